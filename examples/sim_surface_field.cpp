@@ -190,17 +190,9 @@ struct Sim {
         scene::Material, mat, MAT_ScalarField::material(gd));
     material = mat;
 
-    VENUS_DECLARE_SHARED_PTR_FROM_RESULT_OR_RETURN_BAD_RESULT(
-        scene::AllocatedModel, triangle_model_ptr,
-        scene::AllocatedModel::Config::fromShape(
-            scene::shapes::box, hermes::geo::bounds::bbox3::unit(),
-            // scene::shapes::triangle, //
-            // hermes::geo::point3(0.f, 0.f, 0.f),
-            // hermes::geo::point3(0.f, 1.f, 0.f),
-            // hermes::geo::point3(1.f, 0.f, 0.f),
-            scene::shape_option_bits::none)
-            .build(engine::GraphicsEngine::device()));
-    model = triangle_model_ptr;
+    VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
+        model, cache.shapes().box(gd, hermes::geo::bounds::bbox3::unit(),
+                                  scene::shape_option_bits::none));
 
     f32 scalar_field[8] = {
         0.1f, 0.5f, 0.9f, 0.2f, 0.4f, 0.8f, 0.3f, 0.6f,
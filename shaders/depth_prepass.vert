@@ -0,0 +1,25 @@
+#version 450
+
+#extension GL_GOOGLE_include_directive : require
+#extension GL_EXT_buffer_reference : require
+#extension GL_EXT_buffer_reference_uvec2 : require
+
+// Depth prepass (see scene::Material::Pipeline::Config::setDepthPrepassConfig).
+// Only positions are read, through the same path as mesh.vert so depths match
+// the equal depth test of the main pass. No fragment stage is needed as the
+// pass only writes depth.
+
+layout(set = 0, binding = 0) uniform SceneData {
+  mat4 view;
+  mat4 proj;
+} sceneData;
+
+#include "venus/mesh.glsl"
+
+invariant gl_Position;
+
+void main() {
+  mat4 model = ve_mesh_model(uint(gl_InstanceIndex));
+  gl_Position = ve_mesh_clip_position(
+      ve_mesh_position(uint(gl_VertexIndex)), model);
+}
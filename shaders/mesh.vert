@@ -3,31 +3,17 @@
 #extension GL_EXT_debug_printf : enable
 #extension GL_GOOGLE_include_directive : require
 #extension GL_EXT_buffer_reference : require
+#extension GL_EXT_buffer_reference_uvec2 : require
 
 #include "base.glsl"
+#include "venus/mesh.glsl"
 
 layout (location = 0) out vec3 outNormal;
 layout (location = 1) out vec3 outColor;
 layout (location = 2) out vec2 outUV;
 
-struct Vertex {
-	vec3 position;
-	float uv_x;
-	vec3 normal;
-	float uv_y;
-	vec4 color;
-}; 
-
-layout(buffer_reference, std430) readonly buffer VertexBuffer { 
-	Vertex vertices[];
-};
-
-//push constants block
-layout( push_constant ) uniform constants
-{
-	mat4 render_matrix;
-	VertexBuffer vertexBuffer;
-} PushConstants;
+// the depth prepass computes the same positions (see depth_prepass.vert)
+invariant gl_Position;
 
 void printVec(in vec3 v) {
   debugPrintfEXT("\n%d -> %f %f %f\n", gl_VertexIndex,v.x,v.y,v.z);
@@ -35,16 +21,28 @@ void printVec(in vec3 v) {
 
 void main() 
 {
-	Vertex v = PushConstants.vertexBuffer.vertices[gl_VertexIndex];
-	vec4 position = vec4(v.position, 1.0f);
+	uint vertex = uint(gl_VertexIndex);
+	mat4 model = ve_mesh_model(uint(gl_InstanceIndex));
 
-	gl_Position =  sceneData.proj * sceneData.view * PushConstants.render_matrix *position;	
+	gl_Position = ve_mesh_clip_position(ve_mesh_position(vertex), model);
 
   //  printVec(gl_Position.xyz);
 
-	outNormal = (PushConstants.render_matrix * vec4(v.normal, 0.f)).xyz;
-	outColor = v.color.xyz * materialData.colorFactors.xyz;	
-	outUV.x = v.uv_x;
-	outUV.y = v.uv_y;
+	VertexBuffer vertices = PushConstants.vertexBuffer;
+	uint attributes = ve_mesh_attributes(vertex);
+	vec3 normal;
+	vec4 color;
+	if (ve_mesh_quantized()) {
+		normal = ve_decode_oct_snorm16(vertices.words[attributes + 1]);
+		color = ve_decode_unorm8x4(vertices.words[attributes + 3]);
+	} else {
+		normal = ve_mesh_vec3(vertices, attributes + 1);
+		color = vec4(ve_mesh_vec3(vertices, attributes + 5),
+		             ve_mesh_float(vertices, attributes + 8));
+	}
+
+	outNormal = (model * vec4(normal, 0.f)).xyz;
+	outColor = color.xyz * materialData.colorFactors.xyz;	
+	outUV.x = ve_mesh_float(vertices, attributes);
+	outUV.y = ve_mesh_float(vertices, attributes + 1 + ve_mesh_normal_words());
 }
-
@@ -0,0 +1,105 @@
+#ifndef VENUS_MESH_GLSL
+#define VENUS_MESH_GLSL
+
+#include "quantization.glsl"
+
+// Vertex pulling shared by the built-in mesh shaders (mesh.vert and
+// depth_prepass.vert), so both compute the exact same clip positions.
+// The including shader enables GL_EXT_buffer_reference and
+// GL_EXT_buffer_reference_uvec2, and declares sceneData (set 0, binding 0).
+//
+// Vertices are pulled word by word in the glTF import layout:
+//   position (3), uv_x (1), normal (3), uv_y (1), color (4)
+// or, if quantized (see mem::quantizeVertices):
+//   position (2, half xyz), uv_x (1), normal (1, octahedral), uv_y (1),
+//   color (1, unorm8)
+// Meshes with a position stream keep positions in their own buffer and the
+// remaining components in the vertex buffer
+// (see scene::AllocatedModel::Config::enablePositionStream).
+
+layout(buffer_reference, std430) readonly buffer VertexBuffer {
+  uint words[];
+};
+
+// transposed object transforms (see pipeline::Rasterizer::instanceObjects)
+layout(buffer_reference, std430) readonly buffer InstanceBuffer {
+  mat4 transforms[];
+};
+
+// see engine::GraphicsEngine::Globals::Types::DrawPushConstants
+layout(push_constant) uniform constants {
+  mat4 render_matrix;
+  VertexBuffer vertexBuffer;
+  InstanceBuffer instanceBuffer;
+  VertexBuffer positionBuffer;
+  uint quantized;
+  float dequantization[6]; // scale (xyz), offset (xyz)
+} PushConstants;
+
+bool ve_mesh_quantized() {
+  return PushConstants.quantized != 0;
+}
+
+bool ve_mesh_position_stream() {
+  return uvec2(PushConstants.positionBuffer) != uvec2(0) &&
+         uvec2(PushConstants.positionBuffer) !=
+             uvec2(PushConstants.vertexBuffer);
+}
+
+uint ve_mesh_position_words() {
+  return ve_mesh_quantized() ? 2 : 3;
+}
+
+uint ve_mesh_normal_words() {
+  return ve_mesh_quantized() ? 1 : 3;
+}
+
+// words of the components other than position
+uint ve_mesh_attribute_words() {
+  return ve_mesh_normal_words() + (ve_mesh_quantized() ? 3 : 6);
+}
+
+// first word of the vertex components other than position (vertex buffer)
+uint ve_mesh_attributes(in uint vertex) {
+  if (ve_mesh_position_stream())
+    return vertex * ve_mesh_attribute_words();
+  return vertex * (ve_mesh_position_words() + ve_mesh_attribute_words()) +
+         ve_mesh_position_words();
+}
+
+float ve_mesh_float(in VertexBuffer buffer, in uint i) {
+  return uintBitsToFloat(buffer.words[i]);
+}
+
+vec3 ve_mesh_vec3(in VertexBuffer buffer, in uint i) {
+  return vec3(ve_mesh_float(buffer, i), ve_mesh_float(buffer, i + 1),
+              ve_mesh_float(buffer, i + 2));
+}
+
+// object space position
+vec3 ve_mesh_position(in uint vertex) {
+  VertexBuffer positions = PushConstants.vertexBuffer;
+  uint p = vertex * (ve_mesh_position_words() + ve_mesh_attribute_words());
+  if (ve_mesh_position_stream()) {
+    positions = PushConstants.positionBuffer;
+    p = vertex * ve_mesh_position_words();
+  }
+  if (!ve_mesh_quantized())
+    return ve_mesh_vec3(positions, p);
+  float d[6] = PushConstants.dequantization;
+  return ve_dequantize_position(
+      ve_decode_half3(positions.words[p], positions.words[p + 1]),
+      vec3(d[0], d[1], d[2]), vec3(d[3], d[4], d[5]));
+}
+
+mat4 ve_mesh_model(in uint instance) {
+  if (uvec2(PushConstants.instanceBuffer) != uvec2(0))
+    return PushConstants.instanceBuffer.transforms[instance];
+  return PushConstants.render_matrix;
+}
+
+vec4 ve_mesh_clip_position(in vec3 position, in mat4 model) {
+  return sceneData.proj * sceneData.view * model * vec4(position, 1.0);
+}
+
+#endif
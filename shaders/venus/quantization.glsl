@@ -0,0 +1,45 @@
+#ifndef VENUS_QUANTIZATION_GLSL
+#define VENUS_QUANTIZATION_GLSL
+
+// Decoding of quantized vertex components (see mem::quantizeVertices).
+// Quantized vertices are read as uint words through buffer references.
+
+// half float xy, half float z (+ padding)
+vec3 ve_decode_half3(in uint xy, in uint z_) {
+  return vec3(unpackHalf2x16(xy), unpackHalf2x16(z_).x);
+}
+
+// half float uv
+vec2 ve_decode_half2(in uint uv) {
+  return unpackHalf2x16(uv);
+}
+
+// quantized positions are stored in [-1,1] relative to the mesh bounds
+vec3 ve_dequantize_position(in vec3 q, in vec3 scale, in vec3 offset) {
+  return offset + scale * q;
+}
+
+vec2 ve_oct_wrap(in vec2 v) {
+  return (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0,
+                                  v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+// octahedral encoded unit vector
+vec3 ve_oct_decode(in vec2 e) {
+  vec3 v = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+  if (v.z < 0.0)
+    v.xy = ve_oct_wrap(v.xy);
+  return normalize(v);
+}
+
+// octahedral snorm16 normals/tangents
+vec3 ve_decode_oct_snorm16(in uint e) {
+  return ve_oct_decode(unpackSnorm2x16(e));
+}
+
+// unorm8 colors
+vec4 ve_decode_unorm8x4(in uint c) {
+  return unpackUnorm4x8(c);
+}
+
+#endif
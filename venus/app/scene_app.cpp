@@ -27,11 +27,15 @@
 #include <venus/app/scene_app.h>
 
 #include <venus/engine/graphics_engine.h>
+#include <venus/ui/memory_budget.h>
 #include <venus/utils/macros.h>
 #include <venus/utils/vk_debug.h>
 
 #include <imgui.h>
 
+#include <cstring>
+#include <unordered_set>
+
 #define RASTERIZER_GLOBAL_DESCRITOR_BUFFER_NAME                                \
   "scene_app_global_descriptor_data"
 
@@ -68,6 +72,11 @@ VeResult SceneApp::setupCallbacks() {
   startup_callback_ = [&](DisplayApp &app) -> VeResult {
     VENUS_RETURN_BAD_RESULT(ge_config_.init(app.display()));
     VENUS_RETURN_BAD_RESULT(venus::engine::GraphicsEngine::startup());
+    // keep scene handles valid when device memory gets defragmented
+    venus::engine::GraphicsEngine::device().addRelocationCallback(
+        [&](const std::vector<mem::Relocation> &relocations) {
+          relocate(relocations);
+        });
     VENUS_RETURN_BAD_RESULT(init());
     return VeResult::noError();
   };
@@ -112,6 +121,9 @@ VeResult SceneApp::setupCallbacks() {
       ImGui::Text("Application average %.3f ms/frame (%.1f FPS)",
                   frame.last_frame_duration.count() / 1000.f,
                   1000000. / frame.current_fps_period.count());
+      if (ImGui::CollapsingHeader("Memory"))
+        ui::memoryBudgetPanel(
+            (*venus::engine::GraphicsEngine::device()).memoryBudget());
     }
     ImGui::End();
 
@@ -147,6 +159,11 @@ VeResult SceneApp::setupCallbacks() {
   return VeResult::noError();
 }
 
+void SceneApp::relocate(const std::vector<mem::Relocation> &relocations) {
+  scene_.graph().relocate(relocations);
+  engine::GraphicsEngine::cache().shapes().relocate(relocations);
+}
+
 Scene &SceneApp::scene() { return scene_; }
 
 void SceneApp::selectCamera(const std::string &label) {
@@ -171,6 +188,37 @@ i32 SceneApp::run() {
   return DisplayApp::run();
 }
 
+RA_SceneApp::Config &RA_SceneApp::Config::setLodErrorThreshold(f32 pixels) {
+  lod_error_threshold_ = pixels;
+  return *this;
+}
+
+RA_SceneApp::Config &RA_SceneApp::Config::enableMeshletCulling() {
+  meshlet_culling_ = true;
+  return *this;
+}
+
+RA_SceneApp::Config &RA_SceneApp::Config::enableInstancing() {
+  instancing_ = true;
+  return *this;
+}
+
+RA_SceneApp::Config &RA_SceneApp::Config::enableDrawCulling() {
+  draw_culling_ = true;
+  return *this;
+}
+
+RA_SceneApp::Config &RA_SceneApp::Config::enableFrustumCulling() {
+  frustum_culling_ = true;
+  return *this;
+}
+
+RA_SceneApp::Config &RA_SceneApp::Config::enableOcclusionCulling() {
+  draw_culling_ = true;
+  occlusion_culling_ = true;
+  return *this;
+}
+
 Result<RA_SceneApp> RA_SceneApp::Config::build() const {
   RA_SceneApp app;
 
@@ -194,6 +242,12 @@ Result<RA_SceneApp> RA_SceneApp::Config::build() const {
   app.fps_ = fps_;
   app.frames_ = frames_;
   app.ge_config_ = ge_config_;
+  app.lod_error_threshold_ = lod_error_threshold_;
+  app.meshlet_culling_ = meshlet_culling_;
+  app.instancing_ = instancing_;
+  app.draw_culling_ = draw_culling_;
+  app.frustum_culling_ = frustum_culling_;
+  app.occlusion_culling_ = occlusion_culling_;
 
   // setup default camera
   scene::Camera::Ptr default_camera_ptr = scene::Camera::Ptr::shared();
@@ -223,6 +277,20 @@ RA_SceneApp &RA_SceneApp::operator=(RA_SceneApp &&rhs) noexcept {
 void RA_SceneApp::destroy() noexcept {
   global_descriptor_set_.destroy();
   descriptor_allocator_.destroy();
+  meshlet_culler_.destroy();
+  instance_buffer_.destroy();
+  draw_culler_.destroy();
+  depth_pyramid_.destroy();
+  occlusion_depth_view_.destroy();
+  occlusion_depth_.destroy();
+  rasterizer_.clear();
+  raster_entries_.clear();
+  untracked_raster_entries_.clear();
+  refreshed_raster_entries_.clear();
+  raster_pass_ = 0;
+  register_scene_ = true;
+  raster_camera_ = {};
+  raster_instance_buffer_ = 0;
   SceneApp::destroy();
 }
 
@@ -231,6 +299,28 @@ void RA_SceneApp::swap(RA_SceneApp &rhs) {
   VENUS_SWAP_FIELD_WITH_RHS(sa_ui_callback_);
   VENUS_SWAP_FIELD_WITH_RHS(descriptor_allocator_);
   VENUS_SWAP_FIELD_WITH_RHS(global_descriptor_set_);
+  VENUS_SWAP_FIELD_WITH_RHS(lod_error_threshold_);
+  VENUS_SWAP_FIELD_WITH_RHS(meshlet_culling_);
+  VENUS_SWAP_FIELD_WITH_RHS(meshlet_culler_);
+  VENUS_SWAP_FIELD_WITH_RHS(instancing_);
+  VENUS_SWAP_FIELD_WITH_RHS(instance_buffer_);
+  VENUS_SWAP_FIELD_WITH_RHS(draw_culling_);
+  VENUS_SWAP_FIELD_WITH_RHS(draw_culler_);
+  VENUS_SWAP_FIELD_WITH_RHS(frustum_culling_);
+  VENUS_SWAP_FIELD_WITH_RHS(object_spheres_);
+  VENUS_SWAP_FIELD_WITH_RHS(visible_objects_);
+  VENUS_SWAP_FIELD_WITH_RHS(occlusion_culling_);
+  VENUS_SWAP_FIELD_WITH_RHS(depth_pyramid_);
+  VENUS_SWAP_FIELD_WITH_RHS(occlusion_depth_);
+  VENUS_SWAP_FIELD_WITH_RHS(occlusion_depth_view_);
+  VENUS_SWAP_FIELD_WITH_RHS(rasterizer_);
+  VENUS_SWAP_FIELD_WITH_RHS(raster_entries_);
+  VENUS_SWAP_FIELD_WITH_RHS(untracked_raster_entries_);
+  VENUS_SWAP_FIELD_WITH_RHS(refreshed_raster_entries_);
+  VENUS_SWAP_FIELD_WITH_RHS(raster_pass_);
+  VENUS_SWAP_FIELD_WITH_RHS(register_scene_);
+  VENUS_SWAP_FIELD_WITH_RHS(raster_camera_);
+  VENUS_SWAP_FIELD_WITH_RHS(raster_instance_buffer_);
   SceneApp::swap(static_cast<SceneApp &>(rhs));
 }
 
@@ -264,9 +354,46 @@ VeResult RA_SceneApp::init() {
       auto, buffer_index,
       cache.buffers().allocate(RASTERIZER_GLOBAL_DESCRITOR_BUFFER_NAME));
   HERMES_UNUSED_VARIABLE(buffer_index);
+
+  // transparent objects are blended back to front
+  pipeline::Rasterizer::SortKeyLayout sort_key_layout;
+  sort_key_layout.back_to_front_passes =
+      1u << static_cast<u32>(scene::Material::Pass::TRANSPARENT_COLOR);
+  rasterizer_.setSortKeyLayout(sort_key_layout);
   return VeResult::noError();
 }
 
+// Render objects match when all but their transforms are the same.
+static bool sameRenderObject(const scene::RasterContext::RenderObject &a,
+                             const scene::RasterContext::RenderObject &b) {
+  return !std::memcmp(&a.bounds, &b.bounds, sizeof(a.bounds)) &&
+         a.count == b.count && a.first_index == b.first_index &&
+         a.index_buffer == b.index_buffer &&
+         a.vertex_buffer == b.vertex_buffer &&
+         a.vertex_buffer_address == b.vertex_buffer_address &&
+         a.position_buffer_address == b.position_buffer_address &&
+         a.index_buffer_address == b.index_buffer_address &&
+         a.index_type == b.index_type &&
+         a.dequantization.has_value() == b.dequantization.has_value() &&
+         (!a.dequantization.has_value() ||
+          !std::memcmp(&*a.dequantization, &*b.dequantization,
+                       sizeof(mem::Dequantization))) &&
+         a.meshlet_buffer_address == b.meshlet_buffer_address &&
+         a.meshlet_count == b.meshlet_count &&
+         a.material_instance.get() == b.material_instance.get();
+}
+
+// Objects drawn through the meshlet culler.
+static bool hasMeshlets(const scene::RasterContext::RenderObject &o) {
+  return o.meshlet_count && o.index_buffer_address;
+}
+
+// Distance from the camera to the center of the object bounds.
+static f32 objectDepth(const scene::RasterContext::RenderObject &o,
+                       const hermes::geo::point3 &eye) {
+  return (o.transform(o.bounds.center()) - eye).length();
+}
+
 VeResult RA_SceneApp::render(const engine::FrameLoop::Iteration::Frame &frame) {
   HERMES_UNUSED_VARIABLE(frame);
 
@@ -274,6 +401,8 @@ VeResult RA_SceneApp::render(const engine::FrameLoop::Iteration::Frame &frame) {
   // update renderer context
   scene::PushConstantsContext push_constants_ctx;
   engine::GraphicsEngine::Globals::Types::CameraData camera_data;
+  scene::RasterContext::LodSelection lod_selection;
+  std::optional<scene::Frustum> frustum;
   if (!selected_camera_.empty()) {
     // update camera
     auto clip_size = gd.swapchain().imageExtent();
@@ -301,33 +430,44 @@ VeResult RA_SceneApp::render(const engine::FrameLoop::Iteration::Frame &frame) {
             hermes::geo::inverse(camera->viewTransform()).matrix();
         push_constants_ctx.proj_view =
             push_constants_ctx.projection * push_constants_ctx.view;
+        lod_selection = scene::RasterContext::LodSelection::fromCamera(
+            *camera, static_cast<f32>(clip_size.height),
+            lod_error_threshold_);
+        frustum = camera->frustum();
       }
     }
   }
+  // objects are refreshed when the camera moves (depth and push constants)
+  const bool view_changed =
+      std::memcmp(&camera_data, &raster_camera_, sizeof(camera_data));
+  raster_camera_ = camera_data;
   {
-    // update global descriptor
-    descriptor_allocator_.reset();
-
+    // update global descriptor (the set is allocated once and written again
+    // along with the whole scene, as relocations may move the buffer)
     auto &cache = engine::GraphicsEngine::cache();
 
     VENUS_RETURN_BAD_RESULT(
         cache.buffers().copyBlock(RASTERIZER_GLOBAL_DESCRITOR_BUFFER_NAME, 0,
                                   &camera_data, sizeof(camera_data)));
 
-    VENUS_DECLARE_OR_RETURN_BAD_RESULT(
-        VkBuffer, vk_global_data_buffer,
-        cache.buffers()[RASTERIZER_GLOBAL_DESCRITOR_BUFFER_NAME]);
-
-    VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
-        global_descriptor_set_,
-        descriptor_allocator_.allocate(
-            engine::GraphicsEngine::globals().descriptors.camera_data_layout));
-
-    pipeline::DescriptorWriter()
-        .writeBuffer(0, vk_global_data_buffer,
-                     sizeof(engine::GraphicsEngine::Globals::Types::CameraData),
-                     0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER)
-        .update(global_descriptor_set_);
+    if (!global_descriptor_set_) {
+      VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
+          global_descriptor_set_,
+          descriptor_allocator_.allocate(engine::GraphicsEngine::globals()
+                                             .descriptors.camera_data_layout));
+    }
+    if (register_scene_) {
+      VENUS_DECLARE_OR_RETURN_BAD_RESULT(
+          VkBuffer, vk_global_data_buffer,
+          cache.buffers()[RASTERIZER_GLOBAL_DESCRITOR_BUFFER_NAME]);
+
+      pipeline::DescriptorWriter()
+          .writeBuffer(
+              0, vk_global_data_buffer,
+              sizeof(engine::GraphicsEngine::Globals::Types::CameraData), 0,
+              VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER)
+          .update(global_descriptor_set_);
+    }
 
     // example of creating a descriptor set with arbitrary texture count
     // VkDescriptorSetVariableDescriptorCountAllocateInfo alloc_array_info{};
@@ -363,54 +503,334 @@ VeResult RA_SceneApp::render(const engine::FrameLoop::Iteration::Frame &frame) {
         gd.swapchain().colorImageHandle(gd.currentTargetIndex()));
     auto depth_image = gd.swapchain().depthBufferImageHandle();
 
-    scene::DrawContext draw_ctx = scene::RasterContext();
-    scene_.graph().draw({}, draw_ctx);
-
-    pipeline::Rasterizer rasterizer;
-    rasterizer.setRenderArea(gd.swapchain().imageExtent());
-    auto err = std::visit(
-        scene::DrawContextOverloaded{
-            [&](scene::RasterContext &ctx) -> VeResult {
-              for (const auto &o : ctx.objects) {
-                pipeline::Rasterizer::RasterObject ro;
-                ro.count = o.count;
-                ro.first_index = o.first_index;
-                ro.index_buffer = o.index_buffer;
-                ro.vertex_buffer = o.vertex_buffer;
-                ro.descriptor_sets =
-                    o.material_instance->localDescriptorSetGroups();
-                pipeline::Rasterizer::RasterMaterial rm;
-                rm.vk_pipeline = *o.material_instance->pipeline();
-                rm.vk_pipeline_layout = *o.material_instance->pipelineLayout();
-
-                // descriptor sets
-                // TODO: assuming all materials have this global descriptor set
-                if (o.material_instance->hasGlobalDescriptors())
-                  rm.global_descriptor_sets[0] = {*global_descriptor_set_};
-
-                // push constants
-                VENUS_RETURN_BAD_RESULT(o.material_instance->writePushConstants(
-                    ro.push_constants, push_constants_ctx));
-                ro.push_constants_stage_flags =
-                    o.material_instance->pushConstantsStageFlags();
-
-                rasterizer.add(ro, rm);
-              }
-              return VeResult::noError();
-            },
-            [&](scene::TracerContext &ctx) -> VeResult {
-              HERMES_UNUSED_VARIABLE(ctx);
-              return VeResult::incompatible();
-            }},
-        draw_ctx);
-    VENUS_RETURN_BAD_RESULT(err);
+    rasterizer_.setRenderArea(gd.swapchain().imageExtent());
+
+    // only objects of changed nodes are drawn, the whole scene is drawn again
+    // when objects may have been added or removed, or when drawn objects
+    // can't be matched to their entries
+    auto &graph = scene_.graph();
+    scene::RasterContext raster_ctx;
+    raster_ctx.lod_selection = lod_selection;
+    scene::DrawContext draw_ctx = std::move(raster_ctx);
+    auto &objects = std::get<scene::RasterContext>(draw_ctx).objects;
+    bool full_pass = register_scene_ || graph.structureChanged();
+    if (!full_pass) {
+      graph.drawChanges({}, draw_ctx,
+                        view_changed && lod_selection.projection_scale > 0.f);
+      std::unordered_set<u64> drawn_ids;
+      for (const auto &o : objects) {
+        auto it = o.id ? raster_entries_.find(o.id) : raster_entries_.end();
+        if (it == raster_entries_.end() || it->second.shared ||
+            !drawn_ids.insert(o.id).second) {
+          full_pass = true;
+          break;
+        }
+      }
+      if (full_pass)
+        objects.clear();
+    }
+    register_scene_ = false;
+
+    bool meshlets_changed = false;
+    auto drop = [&](RasterEntry &entry) {
+      if (entry.id.has_value())
+        rasterizer_.remove(*entry.id);
+      entry.id.reset();
+      meshlets_changed |= entry.meshlet.has_value();
+      entry.meshlet.reset();
+    };
+    ++raster_pass_;
+    refreshed_raster_entries_.clear();
+    auto refresh = [&](RasterEntry &entry) {
+      if (entry.refreshed == raster_pass_)
+        return;
+      entry.refreshed = raster_pass_;
+      refreshed_raster_entries_.emplace_back(&entry);
+    };
+
+    if (full_pass) {
+      graph.draw({}, draw_ctx);
+      graph.clearChanges();
+      for (auto &entry : untracked_raster_entries_)
+        drop(entry);
+      untracked_raster_entries_.clear();
+    }
+    for (const auto &o : objects) {
+      RasterEntry *entry = nullptr;
+      if (o.id) {
+        auto [it, inserted] = raster_entries_.try_emplace(o.id);
+        entry = &it->second;
+        if (entry->pass == raster_pass_) {
+          // the same object drawn twice in the pass
+          entry->shared = true;
+          entry = nullptr;
+        } else if (!inserted) {
+          entry->changed |= !sameRenderObject(entry->object, o);
+          entry->moved |= std::memcmp(&entry->object.transform, &o.transform,
+                                      sizeof(o.transform)) != 0;
+        }
+      }
+      // untracked entries are refreshed below (the vector may still grow)
+      if (!entry)
+        entry = &untracked_raster_entries_.emplace_back();
+      else
+        refresh(*entry);
+      entry->object = o;
+      entry->pass = raster_pass_;
+      entry->shared = false;
+    }
+    if (full_pass) {
+      for (auto &entry : untracked_raster_entries_)
+        refresh(entry);
+      // objects no longer drawn
+      for (auto it = raster_entries_.begin(); it != raster_entries_.end();) {
+        if (it->second.pass == raster_pass_) {
+          ++it;
+          continue;
+        }
+        drop(it->second);
+        it = raster_entries_.erase(it);
+      }
+    }
 
-    VENUS_RETURN_BAD_RESULT(
-        rasterizer.sortObjects().record(cb, color_image, depth_image));
+    // buffers of instance transforms fit all entries
+    const h_size object_capacity = std::max<h_size>(
+        raster_entries_.size() + untracked_raster_entries_.size(), 1);
+    if (draw_culling_) {
+      VENUS_RETURN_BAD_RESULT(draw_culler_.reserve(gd, object_capacity));
+    } else if (instancing_) {
+      VkDeviceSize instances_size =
+          sizeof(hermes::geo::Transform) * object_capacity;
+      if (instance_buffer_.sizeInBytes() < instances_size) {
+        instance_buffer_.destroy();
+        VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
+            instance_buffer_,
+            mem::AllocatedBuffer::Config::forStorage(instances_size, 0)
+                .build(*gd));
+        rasterizer_.setInstanceBuffer(instance_buffer_);
+      }
+    }
+    // push constants hold the instance buffer address
+    const VkDeviceAddress instance_buffer =
+        draw_culling_ ? draw_culler_.transformBuffer()
+                      : (instancing_ ? instance_buffer_.deviceAddress() : 0);
+    const bool instance_buffer_changed =
+        instance_buffer != raster_instance_buffer_;
+    raster_instance_buffer_ = instance_buffer;
+
+    // besides entries drawn by this pass, all entries are refreshed when the
+    // camera moves (depth, culling and push constants)
+    if (view_changed || instance_buffer_changed) {
+      for (auto &item : raster_entries_) {
+        item.second.changed |= instance_buffer_changed;
+        refresh(item.second);
+      }
+      for (auto &entry : untracked_raster_entries_) {
+        entry.changed |= instance_buffer_changed;
+        refresh(entry);
+      }
+    }
+
+    // frustum culling (culled entries leave the rasterizer)
+    const bool frustum_culling = frustum_culling_ && frustum.has_value();
+    if (frustum_culling) {
+      object_spheres_.clear();
+      object_spheres_.reserve(refreshed_raster_entries_.size());
+      for (const auto *entry : refreshed_raster_entries_)
+        object_spheres_.add(entry->object.bounds, entry->object.transform);
+      object_spheres_.cull(*frustum, visible_objects_);
+    }
+    for (h_index i = 0; i < refreshed_raster_entries_.size(); ++i) {
+      auto &entry = *refreshed_raster_entries_[i];
+      const auto &o = entry.object;
+      // objects without bounds are always drawn
+      entry.visible =
+          !frustum_culling || visible_objects_[i] || o.bounds.radius() <= 0.f;
+      if (!entry.visible) {
+        drop(entry);
+        continue;
+      }
+      if ((entry.changed || entry.moved || !entry.id.has_value()) &&
+          (entry.meshlet.has_value() || hasMeshlets(o)))
+        meshlets_changed = true;
+    }
+
+    // meshlet culling (dispatched before rendering starts), culled objects are
+    // added again (and registered with their new draws) when any changes
+    if (meshlet_culling_) {
+      meshlet_culler_.setCamera(push_constants_ctx.proj_view,
+                                push_constants_ctx.eye);
+      if (meshlets_changed) {
+        meshlet_culler_.clear();
+        auto add = [&](RasterEntry &entry) {
+          const bool had_meshlets = entry.meshlet.has_value();
+          entry.meshlet.reset();
+          if (entry.visible && hasMeshlets(entry.object)) {
+            const auto &o = entry.object;
+            pipeline::MeshletCuller::CullObject co;
+            co.model = o.transform;
+            co.meshlet_data = o.meshlet_buffer_address;
+            co.index_data = o.index_buffer_address;
+            co.index_type = o.index_type;
+            co.meshlet_count = o.meshlet_count;
+            co.index_count = o.count;
+            entry.meshlet = meshlet_culler_.add(co);
+          }
+          if (had_meshlets || entry.meshlet.has_value()) {
+            entry.changed = true;
+            refresh(entry);
+          }
+        };
+        for (auto &item : raster_entries_)
+          add(item.second);
+        for (auto &entry : untracked_raster_entries_)
+          add(entry);
+      }
+      VENUS_RETURN_BAD_RESULT(meshlet_culler_.prepare(gd));
+      VENUS_RETURN_BAD_RESULT(meshlet_culler_.record(cb));
+    }
+
+    // entries whose data and push constants are kept only patch their
+    // transforms and depths
+    hermes::mem::Block push_constants;
+    for (auto *entry : refreshed_raster_entries_) {
+      if (!entry->visible)
+        continue;
+      const auto &o = entry->object;
+      const bool push_constants_kept =
+          !entry->changed && (!entry->moved || instanceBuffer(*entry)) &&
+          !(view_changed &&
+            o.material_instance->viewDependentPushConstants());
+      if (entry->id.has_value() && push_constants_kept)
+        rasterizer_.updateTransform(*entry->id, o.transform,
+                                    objectDepth(o, push_constants_ctx.eye));
+      else
+        VENUS_RETURN_BAD_RESULT(
+            registerRasterEntry(*entry, push_constants_ctx, push_constants));
+      entry->changed = entry->moved = false;
+    }
+
+    rasterizer_.sortObjects();
+    if (draw_culling_) {
+      if (occlusion_culling_) {
+        // the depth of the first culling phase is reduced into the pyramid
+        auto extent = gd.swapchain().imageExtent();
+        auto format = gd.swapchain().depthBuffer().format();
+        auto resolution = occlusion_depth_.resolution();
+        if (!occlusion_depth_ || resolution.width != extent.width ||
+            resolution.height != extent.height) {
+          occlusion_depth_view_.destroy();
+          occlusion_depth_.destroy();
+          VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
+              occlusion_depth_,
+              mem::AllocatedImage::Config::forDepthBuffer(extent)
+                  .setFormat(format)
+                  .addUsage(VK_IMAGE_USAGE_TRANSFER_SRC_BIT)
+                  .build(*gd));
+          VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
+              occlusion_depth_view_,
+              mem::Image::View::Config()
+                  .setViewType(VK_IMAGE_VIEW_TYPE_2D)
+                  .setFormat(format)
+                  .setSubresourceRange({VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, 1})
+                  .build(occlusion_depth_));
+        }
+        VENUS_RETURN_BAD_RESULT(depth_pyramid_.prepare(gd, extent, format));
+        depth_image = {.image = *occlusion_depth_,
+                       .view = *occlusion_depth_view_};
+        draw_culler_.setDepthPyramid(&depth_pyramid_);
+      }
+      draw_culler_.setCamera(push_constants_ctx.proj_view);
+      rasterizer_.cullObjects(draw_culler_);
+      VENUS_RETURN_BAD_RESULT(draw_culler_.prepare(gd));
+      VENUS_RETURN_BAD_RESULT(draw_culler_.record(cb));
+    } else if (instancing_)
+      rasterizer_.instanceObjects();
+    VENUS_RETURN_BAD_RESULT(rasterizer_.record(cb, color_image, depth_image));
   }
   return VeResult::noError();
 }
 
+VkDeviceAddress RA_SceneApp::instanceBuffer(const RasterEntry &entry) const {
+  // meshlet culled draws don't carry instance offsets
+  if (entry.meshlet.has_value())
+    return 0;
+  const auto &o = entry.object;
+  // only indexed draws of front to back passes are culled (see init)
+  if (draw_culling_)
+    return o.index_buffer && o.material_instance->pass() !=
+                                 scene::Material::Pass::TRANSPARENT_COLOR
+               ? draw_culler_.transformBuffer()
+               : 0;
+  return instancing_ ? instance_buffer_.deviceAddress() : 0;
+}
+
+VeResult RA_SceneApp::registerRasterEntry(RasterEntry &entry,
+                                          scene::PushConstantsContext &ctx,
+                                          hermes::mem::Block &push_constants) {
+  const auto &o = entry.object;
+  pipeline::Rasterizer::RasterObject ro;
+  ro.count = o.count;
+  ro.first_index = o.first_index;
+  ro.index_buffer = o.index_buffer;
+  ro.index_type = o.index_type;
+  ro.vertex_buffer = o.vertex_buffer;
+  ro.depth = objectDepth(o, ctx.eye);
+  ro.transform = o.transform;
+  ro.bounds = o.bounds;
+  if (entry.meshlet.has_value()) {
+    // culled indices are always 32-bit
+    ro.index_buffer = meshlet_culler_.indexBuffer();
+    ro.index_type = VK_INDEX_TYPE_UINT32;
+    ro.indirect_buffer = meshlet_culler_.drawBuffer();
+    ro.indirect_offset = meshlet_culler_.drawOffset(*entry.meshlet);
+  }
+  ro.descriptor_sets = o.material_instance->localDescriptorSetBindings();
+  ro.pass = static_cast<u32>(o.material_instance->pass());
+  pipeline::Rasterizer::RasterMaterial rm;
+  rm.vk_pipeline = *o.material_instance->pipeline();
+  rm.vk_pipeline_layout = *o.material_instance->pipelineLayout();
+  rm.vk_depth_pipeline = *o.material_instance->depthPrepassPipeline();
+
+  // descriptor sets
+  // TODO: assuming all materials have this global descriptor set
+  if (o.material_instance->hasGlobalDescriptors() &&
+      !rm.global_descriptor_sets.add(0, *global_descriptor_set_))
+    return VeResult::outOfBounds();
+
+  // push constants
+  ctx.model = o.transform;
+  ctx.vertex_buffer = o.vertex_buffer_address;
+  ctx.position_buffer = o.position_buffer_address;
+  ctx.dequantization = o.dequantization;
+  ctx.instance_buffer = instanceBuffer(entry);
+  VENUS_RETURN_BAD_RESULT(
+      o.material_instance->writePushConstants(push_constants, ctx));
+  ro.push_constants_stage_flags =
+      o.material_instance->pushConstantsStageFlags();
+
+  const auto *pc_data = push_constants.data();
+  u32 pc_size = static_cast<u32>(push_constants.sizeInBytes());
+  if (entry.id.has_value())
+    rasterizer_.update(*entry.id, ro, rm, pc_data, pc_size);
+  else
+    entry.id = rasterizer_.insert(ro, rm, pc_data, pc_size);
+  return VeResult::noError();
+}
+
+void RA_SceneApp::relocate(const std::vector<mem::Relocation> &relocations) {
+  SceneApp::relocate(relocations);
+  // retained objects hold the moved buffers and their addresses (in push
+  // constants), the whole scene is registered again with the patched models
+  rasterizer_.clear();
+  raster_entries_.clear();
+  untracked_raster_entries_.clear();
+  refreshed_raster_entries_.clear();
+  meshlet_culler_.clear();
+  raster_instance_buffer_ = 0;
+  register_scene_ = true;
+}
+
 VeResult RA_SceneApp::shutdown() {
   global_descriptor_set_.destroy();
   descriptor_allocator_.destroy();
@@ -484,11 +904,14 @@ VeResult RT_SceneApp::init() {
               pipeline::RayTracer::TracerObject to;
               to.primitive_count = o.primitive_count;
               to.transform_offset = 0;
-              to.vertex_data = o.vertex_buffer_address;
+              // acceleration structures only read positions
+              to.vertex_data = o.position_buffer_address;
               to.index_data = o.index_buffer_address;
+              to.index_type = o.index_type;
               to.transform_data = o.transform_buffer_address;
               to.max_vertex = o.max_vertex;
               to.vertex_layout = o.vertex_layout;
+              to.dequantization = o.dequantization;
               ray_tracer_.add(to);
             }
           }},
@@ -29,10 +29,15 @@
 
 #include <venus/app/display_app.h>
 #include <venus/app/scene.h>
+#include <venus/pipeline/draw_culler.h>
+#include <venus/pipeline/meshlet_culler.h>
 #include <venus/pipeline/rasterizer.h>
 #include <venus/pipeline/ray_tracer.h>
 #include <venus/ui/camera.h>
 
+#include <optional>
+#include <unordered_map>
+
 namespace venus::app {
 
 /// Auxiliary class for providing an application with display, scene and camera.
@@ -73,6 +78,9 @@ public:
 
 protected:
   VeResult setupCallbacks();
+  /// Patches the handles cached by the scene after a defragmentation pass.
+  /// \param relocations Handles replaced by the pass.
+  virtual void relocate(const std::vector<mem::Relocation> &relocations);
   virtual VeResult init() = 0;
   virtual VeResult render(const engine::FrameLoop::Iteration::Frame &frame) = 0;
   virtual VeResult shutdown() = 0;
@@ -111,7 +119,37 @@ VENUS_DEFINE_SETUP_SET_FIELD_METHOD_T(SceneApp, setGraphicsEngineConfig,
 class RA_SceneApp : public SceneApp {
 public:
   struct Config : public SceneApp::Setup<Config, RA_SceneApp> {
+    /// \param pixels Max screen space error of the drawn levels of detail
+    ///        (see scene::RasterContext::LodSelection). Default is 1 pixel.
+    Config &setLodErrorThreshold(f32 pixels);
+    /// Culls the meshlets of shapes (see scene::Meshlet) in a compute pass
+    /// before drawing. Shapes without meshlets are drawn as usual.
+    Config &enableMeshletCulling();
+    /// Merges draws of the same shape and material instance into instanced
+    /// draws (see pipeline::Rasterizer::instanceObjects). Object transforms
+    /// are given to push constants writers as PushConstantsContext fields.
+    Config &enableInstancing();
+    /// Culls whole draws in a compute pass and draws the visible ones with an
+    /// indirect count draw per bucket of shared draw state (see
+    /// pipeline::DrawCuller). Replaces instancing when both are enabled.
+    /// \note Requires GraphicsEngine::Config::setDrawIndirectCount().
+    Config &enableDrawCulling();
+    /// Culls objects whose bounds lie outside the camera frustum on the CPU
+    /// (see scene::SphereBatch) before they reach the rasterizer.
+    Config &enableFrustumCulling();
+    /// Adds two phase occlusion culling to draw culling (enabling it), tested
+    /// against a depth pyramid (see pipeline::DrawCuller::setDepthPyramid).
+    Config &enableOcclusionCulling();
+
     Result<RA_SceneApp> build() const;
+
+  private:
+    f32 lod_error_threshold_{1.f};
+    bool meshlet_culling_{false};
+    bool instancing_{false};
+    bool draw_culling_{false};
+    bool frustum_culling_{false};
+    bool occlusion_culling_{false};
   };
 
   VENUS_DECLARE_RAII_FUNCTIONS(RA_SceneApp)
@@ -125,8 +163,36 @@ protected:
   VeResult render(const engine::FrameLoop::Iteration::Frame &frame) override;
   VeResult shutdown() override;
   VeResult ui() override;
+  void relocate(const std::vector<mem::Relocation> &relocations) override;
 
 private:
+  /// Render object registered into the rasterizer.
+  struct RasterEntry {
+    /// Last drawn object.
+    scene::RasterContext::RenderObject object;
+    /// Rasterizer object (none while culled).
+    std::optional<h_index> id;
+    /// Meshlet culler object.
+    std::optional<h_index> meshlet;
+    u64 pass{0};        //< last registration pass drawing it.
+    u64 refreshed{0};   //< last registration pass refreshing it.
+    bool changed{true}; //< object data (besides transform) changed.
+    bool moved{true};   //< transform changed.
+    bool visible{true}; //< inside the frustum.
+    bool shared{false}; //< the object id is drawn more than once.
+  };
+
+  /// 
+eturn Instance buffer address given to the push constants of the entry.
+  VkDeviceAddress instanceBuffer(const RasterEntry &entry) const;
+  /// Inserts or updates the rasterizer object of the entry.
+  /// \param entry
+  /// \param ctx Camera fields of the push constants context.
+  /// \param push_constants Scratch block receiving the push constants.
+  VeResult registerRasterEntry(RasterEntry &entry,
+                               scene::PushConstantsContext &ctx,
+                               hermes::mem::Block &push_constants);
+
   std::function<VeResult(RA_SceneApp &)> sa_startup_callback_{nullptr};
   std::function<VeResult(RA_SceneApp &)> sa_ui_callback_{nullptr};
 
@@ -135,6 +201,41 @@ private:
   /// The global descriptor set is bound at the beginning of the array of
   /// descriptor sets accessed by all render objects.
   pipeline::DescriptorSet global_descriptor_set_;
+  /// Max screen space error (in pixels) of levels of detail.
+  f32 lod_error_threshold_{1.f};
+  bool meshlet_culling_{false};
+  pipeline::MeshletCuller meshlet_culler_;
+  bool instancing_{false};
+  /// Object transforms of instanced draws (grows with the object count).
+  mem::AllocatedBuffer instance_buffer_;
+  bool draw_culling_{false};
+  pipeline::DrawCuller draw_culler_;
+  bool frustum_culling_{false};
+  /// World space bounds of the objects of the current frame.
+  scene::SphereBatch object_spheres_;
+  std::vector<u8> visible_objects_;
+  bool occlusion_culling_{false};
+  pipeline::DepthPyramid depth_pyramid_;
+  /// Depth target kept for the depth pyramid (swapchain depth is transient).
+  mem::AllocatedImage occlusion_depth_;
+  mem::Image::View occlusion_depth_view_;
+  /// Raster objects are kept between frames and updated in place.
+  pipeline::Rasterizer rasterizer_;
+  /// Entries of scene::RasterContext::RenderObject::id. Only objects of
+  /// changed nodes are drawn again (see scene::graph::Node::drawChanges).
+  std::unordered_map<u64, RasterEntry> raster_entries_;
+  /// Objects without identity (or drawn more than once), replaced when the
+  /// whole scene is registered again.
+  std::vector<RasterEntry> untracked_raster_entries_;
+  /// Entries refreshed by the current frame.
+  std::vector<RasterEntry *> refreshed_raster_entries_;
+  u64 raster_pass_{0};
+  /// The whole scene is drawn again by the next frame.
+  bool register_scene_{true};
+  /// Camera of the last frame.
+  engine::GraphicsEngine::Globals::Types::CameraData raster_camera_{};
+  /// Instance buffer address held by the registered push constants.
+  VkDeviceAddress raster_instance_buffer_{0};
 };
 
 class RT_SceneApp : public SceneApp {
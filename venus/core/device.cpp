@@ -28,6 +28,8 @@
 
 #include <venus/utils/vk_debug.h>
 
+#include <algorithm>
+
 namespace venus::core {
 
 Device::Config &
@@ -96,6 +98,13 @@ Device::Config::addAllocationFlags(VmaAllocatorCreateFlags flags) {
   return *this;
 }
 
+Device::Config &
+Device::Config::addMemoryPool(MemoryClass memory_class,
+                              const MemoryPool::Config &config) {
+  memory_pool_configs_[memory_class] = config;
+  return *this;
+}
+
 Device::Config &
 Device::Config::addQueueFamily(u32 index,
                                const std::vector<f32> &queue_priorities,
@@ -136,6 +145,19 @@ Device::Config::build(const PhysicalDevice &physical_device) const {
     }
   }
 
+  // heap budget queries are used by the allocator when available
+  auto allocator_flags = allocator_info_.flags;
+  for (const auto &available_extension : available_extensions) {
+    if (std::strcmp(available_extension.extensionName,
+                    VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) == 0) {
+      if (std::find(extensions_.begin(), extensions_.end(),
+                    VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) == extensions_.end())
+        extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+      allocator_flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+      break;
+    }
+  }
+
   auto features = features_;
   features.f2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
   features.v13_f.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
@@ -182,6 +204,7 @@ Device::Config::build(const PhysicalDevice &physical_device) const {
   vulkan_functions.vkGetDeviceProcAddr = vkGetDeviceProcAddr;
 
   VmaAllocatorCreateInfo allocator_info = allocator_info_;
+  allocator_info.flags = allocator_flags;
   allocator_info.device = device.vk_device_;
   allocator_info.physicalDevice = *device.physical_device_;
   allocator_info.instance = device.physical_device_.instance();
@@ -189,6 +212,14 @@ Device::Config::build(const PhysicalDevice &physical_device) const {
 
   VENUS_VK_RETURN_BAD_RESULT(
       vmaCreateAllocator(&allocator_info, &device.allocator_));
+  device.memory_budget_ = std::make_unique<MemoryBudget>(device.allocator_);
+
+  // dedicated memory pools
+  for (const auto &item : memory_pool_configs_) {
+    VENUS_DECLARE_OR_RETURN_BAD_RESULT(MemoryPool, pool,
+                                       item.second.build(device.allocator_));
+    device.memory_pools_[item.first] = std::move(pool);
+  }
 
   return Result<Device>(std::move(device));
 }
@@ -206,10 +237,15 @@ Device &Device::operator=(Device &&rhs) noexcept {
 void Device::swap(Device &rhs) noexcept {
   VENUS_SWAP_FIELD_WITH_RHS(vk_device_);
   VENUS_SWAP_FIELD_WITH_RHS(allocator_);
+  VENUS_SWAP_FIELD_WITH_RHS(memory_pools_);
+  VENUS_SWAP_FIELD_WITH_RHS(memory_budget_);
   VENUS_SWAP_FIELD_WITH_RHS(physical_device_);
 }
 
 void Device::destroy() noexcept {
+  // pools must be released before their allocator
+  memory_pools_.clear();
+  memory_budget_.reset();
   if (allocator_) {
     vmaDestroyAllocator(allocator_);
     allocator_ = VK_NULL_HANDLE;
@@ -224,6 +260,24 @@ VkDevice Device::operator*() const { return vk_device_; }
 
 VmaAllocator Device::allocator() const { return allocator_; }
 
+VmaPool Device::memoryPool(MemoryClass memory_class,
+                           const VkMemoryRequirements &requirements) const {
+  auto it = memory_pools_.find(memory_class);
+  if (it == memory_pools_.end() || !it->second.canServe(requirements))
+    return VK_NULL_HANDLE;
+  return *it->second;
+}
+
+const std::unordered_map<MemoryClass, MemoryPool> &
+Device::memoryPools() const {
+  return memory_pools_;
+}
+
+MemoryBudget &Device::memoryBudget() const {
+  HERMES_ASSERT(memory_budget_);
+  return *memory_budget_;
+}
+
 const PhysicalDevice &Device::physical() const { return physical_device_; }
 
 } // namespace venus::core
@@ -27,12 +27,12 @@
 
 #pragma once
 
+#include <venus/core/memory_budget.h>
+#include <venus/core/memory_pool.h>
 #include <venus/core/physical_device.h>
 #include <venus/utils/macros.h>
 
-#define VMA_STATIC_VULKAN_FUNCTIONS 0
-#define VMA_DYNAMIC_VULKAN_FUNCTIONS 1
-#include <vk_mem_alloc.h>
+#include <memory>
 
 namespace venus::core {
 
@@ -75,6 +75,13 @@ public:
     Config &addCreateFlags(VkDeviceCreateFlags flags);
     /// \param flags
     Config &addAllocationFlags(VmaAllocatorCreateFlags flags);
+    /// Creates a dedicated memory pool for a class of resources.
+    /// \note Resources of that class are allocated from the pool whenever
+    ///       the pool can serve them, otherwise default pools are used.
+    /// \param memory_class Resource class served by the pool.
+    /// \param config Memory pool configuration.
+    Config &addMemoryPool(MemoryClass memory_class,
+                          const MemoryPool::Config &config);
     /// \note This indicates a family with size of queue_priorities elements.
     /// \note If the family index has already been added, this will append the
     ///       priorities to the previous priorities for that family index.
@@ -96,6 +103,7 @@ public:
     std::vector<vk::QueueFamilyConfig> family_configs_;
     VkDeviceCreateFlags flags_;
     VmaAllocatorCreateInfo allocator_info_;
+    std::unordered_map<MemoryClass, MemoryPool::Config> memory_pool_configs_;
 
 #ifdef VENUS_INCLUDE_DEBUG_TRAITS
     friend struct hermes::DebugTraits<Device::Config>;
@@ -115,9 +123,24 @@ public:
   VkDevice operator*() const;
   /// \return allocator
   VmaAllocator allocator() const;
+  /// \param memory_class Resource class.
+  /// \param requirements Memory requirements of the allocation.
+  /// \return Dedicated pool for the class, or VK_NULL_HANDLE if the class is
+  ///         served by default pools or its pool can't serve the allocation
+  ///         (see MemoryPool::canServe).
+  VmaPool memoryPool(MemoryClass memory_class,
+                     const VkMemoryRequirements &requirements) const;
+  /// \return Dedicated memory pools.
+  const std::unordered_map<MemoryClass, MemoryPool> &memoryPools() const;
+  /// \note Allocations made through const device references are accounted
+  ///       here as well, hence the mutable access.
+  /// \return Memory budget telemetry.
+  MemoryBudget &memoryBudget() const;
 
 protected:
   VmaAllocator allocator_{VK_NULL_HANDLE};
+  std::unordered_map<MemoryClass, MemoryPool> memory_pools_;
+  std::unique_ptr<MemoryBudget> memory_budget_;
   VkDevice vk_device_{VK_NULL_HANDLE};
   PhysicalDevice physical_device_;
 
@@ -144,6 +167,7 @@ template <> struct DebugTraits<venus::core::Device> {
     return DebugMessage()
         .addTitle("Device")
         .add("Allocator", data.allocator_)
+        .add("memory pools", data.memory_pools_.size())
         .add("vk_device", VENUS_VK_DISPATCHABLE_HANDLE_STRING(data.vk_device_))
         .add("physical device", data.physical_device_);
   }
@@ -0,0 +1,183 @@
+/* Copyright (c) 2025, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+/// \file   memory_budget.cpp
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-18
+
+#include <venus/core/memory_budget.h>
+
+#include <fstream>
+
+namespace venus::core {
+
+std::string_view memoryCategoryName(MemoryCategory category) {
+  switch (category) {
+  case MemoryCategory::Geometry:
+    return "geometry";
+  case MemoryCategory::Textures:
+    return "textures";
+  case MemoryCategory::Grids:
+    return "grids";
+  case MemoryCategory::AccelerationStructures:
+    return "acceleration structures";
+  case MemoryCategory::Staging:
+    return "staging";
+  case MemoryCategory::Descriptors:
+    return "descriptors";
+  case MemoryCategory::Attachments:
+    return "attachments";
+  default:
+    break;
+  }
+  return "other";
+}
+
+MemoryCategory defaultMemoryCategory(MemoryClass memory_class) {
+  switch (memory_class) {
+  case MemoryClass::Staging:
+    return MemoryCategory::Staging;
+  case MemoryClass::Uniform:
+    return MemoryCategory::Descriptors;
+  case MemoryClass::Storage:
+    return MemoryCategory::Geometry;
+  case MemoryClass::AccelerationStructure:
+  case MemoryClass::ShaderBindingTable:
+    return MemoryCategory::AccelerationStructures;
+  case MemoryClass::Texture:
+    return MemoryCategory::Textures;
+  case MemoryClass::Attachment:
+  case MemoryClass::DepthAttachment:
+    return MemoryCategory::Attachments;
+  }
+  return MemoryCategory::Other;
+}
+
+MemoryBudget::MemoryBudget(VmaAllocator vma_allocator) noexcept
+    : vma_allocator_(vma_allocator) {}
+
+void MemoryBudget::update() {
+  if (!vma_allocator_)
+    return;
+
+  vmaSetCurrentFrameIndex(vma_allocator_, ++frame_count_);
+
+  const VkPhysicalDeviceMemoryProperties *properties{nullptr};
+  vmaGetMemoryProperties(vma_allocator_, &properties);
+  std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets{};
+  vmaGetHeapBudgets(vma_allocator_, budgets.data());
+
+  heaps_.resize(properties->memoryHeapCount);
+  VkDeviceSize total_usage = 0;
+  bool over_budget = false;
+  for (u32 i = 0; i < properties->memoryHeapCount; ++i) {
+    auto &heap = heaps_[i];
+    heap.usage = budgets[i].usage;
+    heap.budget = budgets[i].budget;
+    heap.block_bytes = budgets[i].statistics.blockBytes;
+    heap.flags = properties->memoryHeaps[i].flags;
+    heap.peak_usage = std::max(heap.peak_usage, heap.usage);
+    total_usage += heap.usage;
+    if (heap.budget && heap.usage > warning_threshold_ * heap.budget) {
+      over_budget = true;
+      // warn only when the heap crosses the threshold
+      if (!over_budget_)
+        HERMES_WARN("Memory heap {} usage ({} bytes) is above {}% of its "
+                    "budget ({} bytes).",
+                    i, heap.usage, warning_threshold_ * 100.f, heap.budget);
+    }
+  }
+  peak_usage_ = std::max(peak_usage_, total_usage);
+  over_budget_ = over_budget;
+}
+
+MemoryBudget &MemoryBudget::setWarningThreshold(f32 ratio) {
+  warning_threshold_ = ratio;
+  return *this;
+}
+
+void MemoryBudget::add(MemoryCategory category, VkDeviceSize size_in_bytes) {
+  auto &c = categories_[static_cast<h_index>(category)];
+  c.bytes += size_in_bytes;
+  c.peak_bytes = std::max(c.peak_bytes, c.bytes);
+  c.allocation_count++;
+}
+
+void MemoryBudget::remove(MemoryCategory category,
+                          VkDeviceSize size_in_bytes) {
+  auto &c = categories_[static_cast<h_index>(category)];
+  HERMES_ASSERT(c.bytes >= size_in_bytes && c.allocation_count);
+  c.bytes -= std::min(c.bytes, size_in_bytes);
+  if (c.allocation_count)
+    c.allocation_count--;
+}
+
+const std::vector<MemoryBudget::Heap> &MemoryBudget::heaps() const {
+  return heaps_;
+}
+
+const MemoryBudget::Category &
+MemoryBudget::category(MemoryCategory category) const {
+  return categories_[static_cast<h_index>(category)];
+}
+
+VkDeviceSize MemoryBudget::totalUsage() const {
+  VkDeviceSize usage = 0;
+  for (const auto &heap : heaps_)
+    usage += heap.usage;
+  return usage;
+}
+
+VkDeviceSize MemoryBudget::totalBudget() const {
+  VkDeviceSize budget = 0;
+  for (const auto &heap : heaps_)
+    budget += heap.budget;
+  return budget;
+}
+
+VkDeviceSize MemoryBudget::peakUsage() const { return peak_usage_; }
+
+bool MemoryBudget::isOverBudget() const { return over_budget_; }
+
+std::string MemoryBudget::statsString(bool detailed) const {
+  if (!vma_allocator_)
+    return "{}";
+  char *stats{nullptr};
+  vmaBuildStatsString(vma_allocator_, &stats, detailed ? VK_TRUE : VK_FALSE);
+  std::string s(stats);
+  vmaFreeStatsString(vma_allocator_, stats);
+  return s;
+}
+
+VeResult MemoryBudget::dumpStats(const std::filesystem::path &path,
+                                 bool detailed) const {
+  std::ofstream file(path);
+  if (!file.good()) {
+    HERMES_ERROR("Failed to open {} for writing memory stats.", path.string());
+    return VeResult::ioError();
+  }
+  file << statsString(detailed);
+  return VeResult::noError();
+}
+
+} // namespace venus::core
@@ -0,0 +1,157 @@
+/* Copyright (c) 2025, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+/// \file   memory_budget.h
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-18
+/// \brief  Device memory budget telemetry
+
+#pragma once
+
+#include <venus/core/memory_pool.h>
+
+#include <array>
+#include <filesystem>
+
+namespace venus::core {
+
+/// Categories used to account device memory allocations.
+enum class MemoryCategory : u32 {
+  Geometry,               //!< vertex, index and transform data
+  Textures,               //!< sampled images
+  Grids,                  //!< volumetric grids (vdb)
+  AccelerationStructures, //!< ray tracing structures and tables
+  Staging,                //!< transfer sources
+  Descriptors,            //!< uniform data bound through descriptors
+  Attachments,            //!< render targets
+  Other,                  //!< untagged allocations
+  Count
+};
+
+/// \param category
+/// \return Category display name.
+std::string_view memoryCategoryName(MemoryCategory category);
+/// \param memory_class
+/// \return The category assumed for allocations of the given resource class.
+MemoryCategory defaultMemoryCategory(MemoryClass memory_class);
+
+/// Tracks device memory usage per category and per memory heap.
+/// Heap budgets come from the allocator (VK_EXT_memory_budget when
+/// available) and must be refreshed by calling update() once per frame.
+class MemoryBudget {
+public:
+  /// Memory heap usage.
+  struct Heap {
+    VkDeviceSize usage{0};       //!< bytes currently used by the process
+    VkDeviceSize budget{0};      //!< bytes the process can use
+    VkDeviceSize peak_usage{0};  //!< highest usage observed
+    VkDeviceSize block_bytes{0}; //!< bytes allocated in allocator blocks
+    VkMemoryHeapFlags flags{0};  //!< heap properties
+  };
+  /// Allocations accounted for a category.
+  struct Category {
+    VkDeviceSize bytes{0};
+    VkDeviceSize peak_bytes{0};
+    h_size allocation_count{0};
+  };
+
+  /// \param vma_allocator Allocator being inspected.
+  explicit MemoryBudget(VmaAllocator vma_allocator) noexcept;
+
+  /// Advances the allocator frame index, queries the current heap budgets and
+  /// emits a warning when usage crosses the warning threshold of any heap
+  /// budget.
+  /// \note Must be called once per frame, the allocator budget cache expects
+  ///       a frame index that only increases.
+  void update();
+  /// \param ratio Fraction of the heap budget from which warnings are emitted.
+  MemoryBudget &setWarningThreshold(f32 ratio);
+  /// Accounts a new allocation.
+  void add(MemoryCategory category, VkDeviceSize size_in_bytes);
+  /// Removes an allocation from the accounts.
+  void remove(MemoryCategory category, VkDeviceSize size_in_bytes);
+
+  /// \return Heaps usage (as of the last update).
+  const std::vector<Heap> &heaps() const;
+  /// \return Accounts of a given category.
+  const Category &category(MemoryCategory category) const;
+  /// \return Bytes used in all heaps (as of the last update).
+  VkDeviceSize totalUsage() const;
+  /// \return Bytes available in all heaps (as of the last update).
+  VkDeviceSize totalBudget() const;
+  /// \return Highest total usage observed.
+  VkDeviceSize peakUsage() const;
+  /// \return Whether any heap usage is above the warning threshold.
+  bool isOverBudget() const;
+  /// \param detailed Include the list of every allocation.
+  /// \return Allocator statistics in json format.
+  std::string statsString(bool detailed = true) const;
+  /// Writes the allocator statistics (json) into a file.
+  /// \param path Output file path.
+  /// \param detailed Include the list of every allocation.
+  /// \return error status.
+  HERMES_NODISCARD VeResult dumpStats(const std::filesystem::path &path,
+                                      bool detailed = true) const;
+
+private:
+  VmaAllocator vma_allocator_{VK_NULL_HANDLE};
+  std::vector<Heap> heaps_;
+  std::array<Category, static_cast<h_size>(MemoryCategory::Count)>
+      categories_{};
+  VkDeviceSize peak_usage_{0};
+  u32 frame_count_{0};
+  f32 warning_threshold_{0.9f};
+  bool over_budget_{false};
+
+#ifdef VENUS_INCLUDE_DEBUG_TRAITS
+  friend struct hermes::DebugTraits<MemoryBudget>;
+#endif
+};
+
+} // namespace venus::core
+
+#ifdef VENUS_INCLUDE_DEBUG_TRAITS
+namespace hermes {
+
+template <> struct DebugTraits<venus::core::MemoryBudget> {
+  static HERMES_CONST_OR_CONSTEXPR bool is_string_serializable = true;
+  static DebugMessage message(const venus::core::MemoryBudget &data) {
+    DebugMessage m;
+    m.addTitle("Memory Budget")
+        .add("usage", data.totalUsage())
+        .add("budget", data.totalBudget())
+        .add("peak usage", data.peak_usage_)
+        .add("frame count", data.frame_count_);
+    for (u32 i = 0; i < static_cast<u32>(venus::core::MemoryCategory::Count);
+         ++i)
+      m.addFmt("{}: {} bytes",
+               venus::core::memoryCategoryName(
+                   static_cast<venus::core::MemoryCategory>(i)),
+               data.categories_[i].bytes);
+    return m;
+  }
+};
+
+} // namespace hermes
+
+#endif // VENUS_INCLUDE_DEBUG_TRAITS
@@ -0,0 +1,267 @@
+/* Copyright (c) 2025, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+/// \file   memory_pool.cpp
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-18
+
+#include <venus/core/memory_pool.h>
+
+#include <venus/utils/vk_debug.h>
+
+namespace venus::core {
+
+static VkBufferCreateInfo sampleBufferInfo(VkBufferUsageFlags usage) {
+  VkBufferCreateInfo info{};
+  info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+  info.size = 1024;
+  info.usage = usage;
+  info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  return info;
+}
+
+static VkImageCreateInfo sampleImageInfo(VkFormat format,
+                                         VkImageTiling tiling,
+                                         VkImageUsageFlags usage) {
+  VkImageCreateInfo info{};
+  info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+  info.imageType = VK_IMAGE_TYPE_2D;
+  info.format = format;
+  info.extent = {256, 256, 1};
+  info.mipLevels = 1;
+  info.arrayLayers = 1;
+  info.samples = VK_SAMPLE_COUNT_1_BIT;
+  info.tiling = tiling;
+  info.usage = usage;
+  info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  return info;
+}
+
+MemoryPool::Config MemoryPool::Config::forStaging() {
+  VmaAllocationCreateInfo allocation_info{};
+  allocation_info.usage = VMA_MEMORY_USAGE_CPU_ONLY;
+  allocation_info.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+  return MemoryPool::Config()
+      .setBufferInfo(sampleBufferInfo(VK_BUFFER_USAGE_TRANSFER_SRC_BIT))
+      .setAllocationInfo(allocation_info)
+      .setBlockSize(64ull << 20)
+      .setLinearAlgorithm();
+}
+
+MemoryPool::Config MemoryPool::Config::forUniform() {
+  VmaAllocationCreateInfo allocation_info{};
+  allocation_info.requiredFlags = VK_MEMORY_PROPERTY_HOST_COHERENT_BIT |
+                                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+  return MemoryPool::Config()
+      .setBufferInfo(sampleBufferInfo(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT |
+                                      VK_BUFFER_USAGE_TRANSFER_DST_BIT))
+      .setAllocationInfo(allocation_info)
+      .setBlockSize(4ull << 20);
+}
+
+MemoryPool::Config MemoryPool::Config::forStorage() {
+  VmaAllocationCreateInfo allocation_info{};
+  allocation_info.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+  return MemoryPool::Config()
+      .setBufferInfo(sampleBufferInfo(
+          VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+          VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+          VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT))
+      .setAllocationInfo(allocation_info)
+      .setBlockSize(256ull << 20);
+}
+
+MemoryPool::Config MemoryPool::Config::forAccelerationStructure() {
+  VmaAllocationCreateInfo allocation_info{};
+  allocation_info.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+  allocation_info.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+  return MemoryPool::Config()
+      .setBufferInfo(sampleBufferInfo(
+          VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+          VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+          VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT |
+          VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR))
+      .setAllocationInfo(allocation_info)
+      .setBlockSize(64ull << 20);
+}
+
+MemoryPool::Config MemoryPool::Config::forShaderBindingTable() {
+  VmaAllocationCreateInfo allocation_info{};
+  allocation_info.usage = VMA_MEMORY_USAGE_CPU_TO_GPU;
+  return MemoryPool::Config()
+      .setBufferInfo(
+          sampleBufferInfo(VK_BUFFER_USAGE_SHADER_BINDING_TABLE_BIT_KHR |
+                           VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+                           VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT))
+      .setAllocationInfo(allocation_info)
+      .setBlockSize(1ull << 20);
+}
+
+MemoryPool::Config MemoryPool::Config::forTexture() {
+  VmaAllocationCreateInfo allocation_info{};
+  allocation_info.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+  allocation_info.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+  return MemoryPool::Config()
+      .setImageInfo(sampleImageInfo(VK_FORMAT_R8G8B8A8_UNORM,
+                                    VK_IMAGE_TILING_OPTIMAL,
+                                    VK_IMAGE_USAGE_SAMPLED_BIT |
+                                        VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                                        VK_IMAGE_USAGE_TRANSFER_SRC_BIT))
+      .setAllocationInfo(allocation_info)
+      .setBlockSize(128ull << 20);
+}
+
+MemoryPool::Config MemoryPool::Config::forAttachment() {
+  VmaAllocationCreateInfo allocation_info{};
+  allocation_info.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+  allocation_info.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+  return MemoryPool::Config()
+      .setImageInfo(sampleImageInfo(
+          VK_FORMAT_R16G16B16A16_SFLOAT, VK_IMAGE_TILING_OPTIMAL,
+          VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+              VK_IMAGE_USAGE_STORAGE_BIT |
+              VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT))
+      .setAllocationInfo(allocation_info)
+      .setBlockSize(128ull << 20);
+}
+
+MemoryPool::Config MemoryPool::Config::forDepthAttachment() {
+  VmaAllocationCreateInfo allocation_info{};
+  allocation_info.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+  allocation_info.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+  return MemoryPool::Config()
+      .setImageInfo(sampleImageInfo(
+          VK_FORMAT_D32_SFLOAT, VK_IMAGE_TILING_OPTIMAL,
+          VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+              VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT))
+      .setAllocationInfo(allocation_info)
+      .setBlockSize(64ull << 20);
+}
+
+VENUS_DEFINE_SET_CONFIG_FIELD_METHOD(MemoryPool, setBufferInfo,
+                                     const VkBufferCreateInfo &,
+                                     buffer_info_ = value)
+VENUS_DEFINE_SET_CONFIG_FIELD_METHOD(MemoryPool, setImageInfo,
+                                     const VkImageCreateInfo &,
+                                     image_info_ = value)
+VENUS_DEFINE_SET_CONFIG_FIELD_METHOD(MemoryPool, setAllocationInfo,
+                                     const VmaAllocationCreateInfo &,
+                                     allocation_info_ = value)
+VENUS_DEFINE_SET_CONFIG_FIELD_METHOD(MemoryPool, setMemoryTypeIndex, u32,
+                                     memory_type_index_ = value)
+VENUS_DEFINE_SET_CONFIG_INFO_FIELD_METHOD(MemoryPool, setBlockSize,
+                                          VkDeviceSize, blockSize)
+VENUS_DEFINE_SET_CONFIG_INFO_FIELD_METHOD(MemoryPool, setMinBlockCount, h_size,
+                                          minBlockCount)
+VENUS_DEFINE_SET_CONFIG_INFO_FIELD_METHOD(MemoryPool, setMaxBlockCount, h_size,
+                                          maxBlockCount)
+VENUS_DEFINE_SET_CONFIG_FIELD_METHOD(MemoryPool, addCreateFlags,
+                                     VmaPoolCreateFlags, info_.flags |= value)
+VENUS_DEFINE_SET_CONFIG_INFO_FIELD_METHOD(MemoryPool, setPriority, f32,
+                                          priority)
+VENUS_DEFINE_SET_CONFIG_INFO_FIELD_METHOD(MemoryPool,
+                                          setMinAllocationAlignment,
+                                          VkDeviceSize, minAllocationAlignment)
+
+MemoryPool::Config &MemoryPool::Config::setLinearAlgorithm() {
+  info_.flags |= VMA_POOL_CREATE_LINEAR_ALGORITHM_BIT;
+  return *this;
+}
+
+Result<MemoryPool> MemoryPool::Config::build(VmaAllocator vma_allocator) const {
+  VmaPoolCreateInfo info = info_;
+
+  // resolve memory type
+  if (memory_type_index_.has_value())
+    info.memoryTypeIndex = memory_type_index_.value();
+  else if (buffer_info_.has_value()) {
+    VENUS_VK_RETURN_BAD_RESULT(vmaFindMemoryTypeIndexForBufferInfo(
+        vma_allocator, &buffer_info_.value(), &allocation_info_,
+        &info.memoryTypeIndex));
+  } else if (image_info_.has_value()) {
+    VENUS_VK_RETURN_BAD_RESULT(vmaFindMemoryTypeIndexForImageInfo(
+        vma_allocator, &image_info_.value(), &allocation_info_,
+        &info.memoryTypeIndex));
+  } else {
+    HERMES_ERROR("Memory pool requires a memory type index or a sample "
+                 "buffer/image description.");
+    return VeResult::inputError();
+  }
+
+  MemoryPool pool;
+  VENUS_VK_RETURN_BAD_RESULT(
+      vmaCreatePool(vma_allocator, &info, &pool.vma_pool_));
+  pool.vma_allocator_ = vma_allocator;
+  pool.memory_type_index_ = info.memoryTypeIndex;
+  pool.block_size_ = info.blockSize;
+
+  return Result<MemoryPool>(std::move(pool));
+}
+
+MemoryPool::MemoryPool(MemoryPool &&rhs) noexcept { *this = std::move(rhs); }
+
+MemoryPool::~MemoryPool() noexcept { destroy(); }
+
+MemoryPool &MemoryPool::operator=(MemoryPool &&rhs) noexcept {
+  destroy();
+  swap(rhs);
+  return *this;
+}
+
+void MemoryPool::swap(MemoryPool &rhs) noexcept {
+  VENUS_SWAP_FIELD_WITH_RHS(vma_allocator_);
+  VENUS_SWAP_FIELD_WITH_RHS(vma_pool_);
+  VENUS_SWAP_FIELD_WITH_RHS(memory_type_index_);
+  VENUS_SWAP_FIELD_WITH_RHS(block_size_);
+}
+
+void MemoryPool::destroy() noexcept {
+  if (vma_allocator_ && vma_pool_)
+    vmaDestroyPool(vma_allocator_, vma_pool_);
+  vma_allocator_ = VK_NULL_HANDLE;
+  vma_pool_ = VK_NULL_HANDLE;
+  memory_type_index_ = 0;
+  block_size_ = 0;
+}
+
+VmaPool MemoryPool::operator*() const { return vma_pool_; }
+
+u32 MemoryPool::memoryTypeIndex() const { return memory_type_index_; }
+
+VkDeviceSize MemoryPool::blockSize() const { return block_size_; }
+
+bool MemoryPool::canServe(const VkMemoryRequirements &requirements) const {
+  if (!vma_pool_ || !((requirements.memoryTypeBits >> memory_type_index_) & 1u))
+    return false;
+  return !block_size_ || requirements.size <= block_size_;
+}
+
+VmaStatistics MemoryPool::statistics() const {
+  VmaStatistics stats{};
+  if (vma_allocator_ && vma_pool_)
+    vmaGetPoolStatistics(vma_allocator_, vma_pool_, &stats);
+  return stats;
+}
+
+} // namespace venus::core
@@ -0,0 +1,188 @@
+/* Copyright (c) 2025, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+/// \file   memory_pool.h
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-18
+/// \brief  Custom device memory pools
+
+#pragma once
+
+#include <venus/core/physical_device.h>
+#include <venus/utils/macros.h>
+
+#define VMA_STATIC_VULKAN_FUNCTIONS 0
+#define VMA_DYNAMIC_VULKAN_FUNCTIONS 1
+#include <vk_mem_alloc.h>
+
+#include <optional>
+
+namespace venus::core {
+
+/// Classes of resources that can be served by dedicated memory pools.
+enum class MemoryClass : u32 {
+  Staging,               //!< short-lived host-visible transfer sources
+  Uniform,               //!< small host-visible uniform buffers
+  Storage,               //!< device-local storage (geometry, grids, etc)
+  AccelerationStructure, //!< acceleration structure storage and scratch
+  ShaderBindingTable,    //!< ray tracing shader binding tables
+  Texture,               //!< sampled images
+  Attachment,            //!< render targets and storage images
+  DepthAttachment        //!< depth buffers
+};
+
+/// Holds a custom VMA memory pool.
+/// Custom pools keep resources of the same class in their own memory blocks,
+/// so tiny and short-lived allocations do not fragment the blocks of big
+/// long-lived resources.
+/// \note Allocations larger than the pool block size, or whose memory type
+///       bits do not include the pool memory type, cannot be served by the
+///       pool.
+/// \note This class uses RAII.
+class MemoryPool {
+public:
+  /// Builder for MemoryPool.
+  /// \note The pool memory type is either set explicitly or resolved from a
+  ///       sample buffer/image description and an allocation description.
+  struct Config {
+    /// Linear pool for staging buffers (host visible, transfer source).
+    static Config forStaging();
+    /// Pool for uniform buffers (host visible and coherent).
+    static Config forUniform();
+    /// Pool for device local storage buffers.
+    static Config forStorage();
+    /// Pool for acceleration structure buffers.
+    static Config forAccelerationStructure();
+    /// Pool for shader binding table buffers.
+    static Config forShaderBindingTable();
+    /// Pool for sampled images.
+    static Config forTexture();
+    /// Pool for color attachments and storage images.
+    static Config forAttachment();
+    /// Pool for depth attachments.
+    static Config forDepthAttachment();
+
+    /// \param info Sample buffer used to resolve the memory type.
+    Config &setBufferInfo(const VkBufferCreateInfo &info);
+    /// \param info Sample image used to resolve the memory type.
+    Config &setImageInfo(const VkImageCreateInfo &info);
+    /// \param info Allocation description used to resolve the memory type.
+    Config &setAllocationInfo(const VmaAllocationCreateInfo &info);
+    /// \param index Memory type index (skips memory type resolution).
+    Config &setMemoryTypeIndex(u32 index);
+    /// \param size_in_bytes Size of each memory block (0 for VMA default).
+    Config &setBlockSize(VkDeviceSize size_in_bytes);
+    /// \param count Number of blocks allocated up front and always kept.
+    Config &setMinBlockCount(h_size count);
+    /// \param count Maximum number of blocks (0 for unlimited).
+    Config &setMaxBlockCount(h_size count);
+    /// Use the linear allocation algorithm, suited for transient data
+    /// allocated and released in stack or ring-buffer order.
+    Config &setLinearAlgorithm();
+    /// \param flags Pool create flags (vma).
+    Config &addCreateFlags(VmaPoolCreateFlags flags);
+    /// \param priority value in [0,1]
+    Config &setPriority(f32 priority);
+    /// \param alignment Minimum alignment of every allocation in the pool.
+    Config &setMinAllocationAlignment(VkDeviceSize alignment);
+
+    /// Creates a new MemoryPool from this configuration.
+    /// \param vma_allocator Allocator owning the pool.
+    /// \return a new MemoryPool, or error.
+    HERMES_NODISCARD Result<MemoryPool> build(VmaAllocator vma_allocator) const;
+
+  private:
+    std::optional<VkBufferCreateInfo> buffer_info_;
+    std::optional<VkImageCreateInfo> image_info_;
+    std::optional<u32> memory_type_index_;
+    VmaAllocationCreateInfo allocation_info_{};
+    VmaPoolCreateInfo info_{};
+
+#ifdef VENUS_INCLUDE_DEBUG_TRAITS
+    friend struct hermes::DebugTraits<MemoryPool::Config>;
+#endif
+  };
+
+  // raii
+
+  VENUS_DECLARE_RAII_FUNCTIONS(MemoryPool)
+
+  /// Destroys the pool.
+  /// \note All allocations made from the pool must be freed before.
+  void destroy() noexcept;
+  void swap(MemoryPool &rhs) noexcept;
+  /// \return Underlying vma pool object.
+  VmaPool operator*() const;
+  /// \return Memory type index of the pool blocks.
+  u32 memoryTypeIndex() const;
+  /// \return Size of each memory block (0 for VMA default).
+  VkDeviceSize blockSize() const;
+  /// \param requirements Memory requirements of an allocation.
+  /// \return Whether the pool memory type is allowed by the requirements and
+  ///         the allocation fits in a block.
+  bool canServe(const VkMemoryRequirements &requirements) const;
+  /// \return Current pool statistics.
+  VmaStatistics statistics() const;
+
+private:
+  VmaAllocator vma_allocator_{VK_NULL_HANDLE};
+  VmaPool vma_pool_{VK_NULL_HANDLE};
+  u32 memory_type_index_{0};
+  VkDeviceSize block_size_{0};
+
+#ifdef VENUS_INCLUDE_DEBUG_TRAITS
+  friend struct hermes::DebugTraits<MemoryPool>;
+#endif
+};
+
+} // namespace venus::core
+
+#ifdef VENUS_INCLUDE_DEBUG_TRAITS
+namespace hermes {
+
+template <> struct DebugTraits<venus::core::MemoryPool::Config> {
+  static HERMES_CONST_OR_CONSTEXPR bool is_string_serializable = true;
+  static DebugMessage message(const venus::core::MemoryPool::Config &data) {
+    return DebugMessage()
+        .addTitle("Memory Pool Config")
+        .add("block size", data.info_.blockSize)
+        .add("min block count", data.info_.minBlockCount)
+        .add("max block count", data.info_.maxBlockCount)
+        .add("flags", data.info_.flags);
+  }
+};
+
+template <> struct DebugTraits<venus::core::MemoryPool> {
+  static HERMES_CONST_OR_CONSTEXPR bool is_string_serializable = true;
+  static DebugMessage message(const venus::core::MemoryPool &data) {
+    return DebugMessage()
+        .addTitle("Memory Pool")
+        .add("vma pool", data.vma_pool_)
+        .add("memory type index", data.memory_type_index_)
+        .add("block size", data.block_size_);
+  }
+};
+
+} // namespace hermes
+
+#endif // VENUS_INCLUDE_DEBUG_TRAITS
@@ -78,6 +78,8 @@ const std::vector<VkExtensionProperties> &vk::availableInstanceExtensions() {
 
 VkDeviceSize vk::indexSize(VkIndexType type) {
   switch (type) {
+  case VK_INDEX_TYPE_UINT16:
+    return sizeof(u16);
   case VK_INDEX_TYPE_UINT32:
     return sizeof(u32);
   default:
@@ -45,6 +45,12 @@ VENUS_DEFINE_SET_CONFIG_FIELD_METHOD(
     GraphicsDevice, addExtensions, const std::vector<std::string> &,
     extensions_.insert(extensions_.end(), value.begin(), value.end()))
 
+GraphicsDevice::Config &GraphicsDevice::Config::addMemoryPool(
+    core::MemoryClass memory_class, const core::MemoryPool::Config &config) {
+  memory_pools_[memory_class] = config;
+  return *this;
+}
+
 bool GraphicsDevice::Config::useDynamicRendering() const {
   return device_features_.v13_f.dynamicRendering;
 }
@@ -78,6 +84,8 @@ GraphicsDevice::Config::build(const core::Instance &instance) const {
           .setFeatures(device_features_)
           .addAllocationFlags(VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT)
           .addExtensions(extensions_);
+  for (const auto &item : memory_pools_)
+    device_config.addMemoryPool(item.first, item.second);
 
   // add one queue for graphics and add another one for present if possible
   device_config.addQueueFamily(indices.graphics_queue_family_index, {1.f});
@@ -187,7 +195,7 @@ GraphicsDevice::Config::build(const core::Instance &instance) const {
 
     VkAttachmentDescription depth_att{};
     depth_att.format = gd.swapchain_.depthBuffer().format();
-    depth_att.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    depth_att.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     depth_att.flags = {};
     depth_att.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
     depth_att.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
@@ -252,6 +260,7 @@ GraphicsDevice::Config::build(const core::Instance &instance) const {
   VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
       gd.output_.depth,
       mem::AllocatedImage::Config::forDepthBuffer(gd.surface_extent_)
+          .enableTransient()
           .build(*gd));
 
   subresource_range.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
@@ -303,11 +312,15 @@ void GraphicsDevice::swap(GraphicsDevice &rhs) noexcept {
   VENUS_FIELD_SWAP_RHS(output_.color);
   VENUS_FIELD_SWAP_RHS(output_.depth_view);
   VENUS_FIELD_SWAP_RHS(output_.depth);
+  VENUS_FIELD_SWAP_RHS(defragmenter_);
+  VENUS_SWAP_FIELD_WITH_RHS(relocation_callbacks_);
 }
 
 VeResult GraphicsDevice::destroy() noexcept {
   presentation_surface_ = VK_NULL_HANDLE;
   surface_extent_ = {};
+  defragmenter_.destroy();
+  relocation_callbacks_.clear();
   framebuffers_.clear();
   renderpass_.destroy();
   output_.depth.destroy();
@@ -376,6 +389,14 @@ VeResult GraphicsDevice::begin(const VkCommandBufferUsageFlags &flags) {
 
   VENUS_VK_RETURN_BAD_RESULT(frame.render_fence.reset());
 
+  // memory telemetry
+
+  device_.memoryBudget().update();
+
+  // the device is idle at this point, so moved resources can be replaced
+
+  VENUS_RETURN_BAD_RESULT(defragmentationStep());
+
   // begin record
 
   VENUS_RETURN_BAD_RESULT(frame.command_buffers[0].reset({}));
@@ -480,4 +501,44 @@ VeResult GraphicsDevice::immediateSubmit(
   return VeResult::noError();
 }
 
+VeResult GraphicsDevice::defragment(const mem::Defragmenter::Config &config) {
+  VENUS_ASSIGN_OR_RETURN_BAD_RESULT(defragmenter_, config.build(device_));
+  return VeResult::noError();
+}
+
+void GraphicsDevice::addRelocationCallback(
+    const RelocationCallback &callback) {
+  relocation_callbacks_.emplace_back(callback);
+}
+
+VeResult GraphicsDevice::defragmentationStep() {
+  if (!defragmenter_)
+    return VeResult::noError();
+
+  // copies of moved resources are completed by the immediate submission
+  Result<bool> moving(false);
+  VENUS_RETURN_BAD_RESULT(
+      immediateSubmit([&](const pipeline::CommandBuffer &cb) {
+        moving = defragmenter_.beginPass(*cb);
+      }));
+  if (!moving)
+    return moving.status();
+  if (!*moving)
+    return VeResult::noError();
+
+  VENUS_DECLARE_OR_RETURN_BAD_RESULT(std::vector<mem::Relocation>,
+                                     relocations, defragmenter_.endPass());
+  if (!relocations.empty())
+    for (const auto &callback : relocation_callbacks_)
+      callback(relocations);
+
+  if (!defragmenter_) {
+    const auto &stats = defragmenter_.statistics();
+    HERMES_INFO("Defragmentation finished: {} allocations moved, {} bytes "
+                "freed.",
+                stats.allocationsMoved, stats.bytesFreed);
+  }
+  return VeResult::noError();
+}
+
 } // namespace venus::engine
@@ -31,6 +31,7 @@
 #include <venus/core/instance.h>
 #include <venus/core/sync.h>
 #include <venus/io/swapchain.h>
+#include <venus/mem/defragmenter.h>
 #include <venus/pipeline/command_buffer.h>
 #include <venus/pipeline/framebuffer.h>
 #include <venus/pipeline/renderpass.h>
@@ -56,12 +57,20 @@ namespace venus::engine {
 /// \note RAII
 class GraphicsDevice {
 public:
+  /// Receives the handles replaced by a defragmentation pass.
+  using RelocationCallback =
+      std::function<void(const std::vector<mem::Relocation> &)>;
+
   struct Config {
     Config &setSurfaceExtent(const VkExtent2D &extent);
     Config &setSurface(VkSurfaceKHR surface);
     Config &setFeatures(const core::vk::DeviceFeatures &device_features);
     Config &addExtension(const std::string_view &extension);
     Config &addExtensions(const std::vector<std::string> &extensions);
+    /// \param memory_class Resource class served by the pool.
+    /// \param config Dedicated memory pool configuration.
+    Config &addMemoryPool(core::MemoryClass memory_class,
+                          const core::MemoryPool::Config &config);
 
     Result<GraphicsDevice> build(const core::Instance &instance) const;
 
@@ -72,6 +81,8 @@ public:
     VkSurfaceKHR surface_{VK_NULL_HANDLE};
     core::vk::DeviceFeatures device_features_{};
     std::vector<std::string> extensions_;
+    std::unordered_map<core::MemoryClass, core::MemoryPool::Config>
+        memory_pools_;
   };
 
   struct Output {
@@ -121,6 +132,20 @@ public:
   HERMES_NODISCARD VeResult immediateSubmit(
       const std::function<void(const pipeline::CommandBuffer &)> &f) const;
 
+  // Memory defragmentation
+
+  /// Starts an incremental defragmentation of device memory. A single
+  /// defragmentation pass runs on each begin() call until there is nothing
+  /// left to be moved.
+  /// \note A running defragmentation is restarted.
+  /// \param config Defragmentation configuration (per-pass budget).
+  HERMES_NODISCARD VeResult defragment(const mem::Defragmenter::Config &config);
+  /// Registers a callback to be called after each defragmentation pass, so
+  /// owners of moved resources can patch cached handles (views, device
+  /// addresses, descriptor sets).
+  /// \param callback
+  void addRelocationCallback(const RelocationCallback &callback);
+
   // Fields access
 
   /// \return The device pair managed by this object.
@@ -179,10 +204,16 @@ private:
 
   /// \return Frame data of the current frame
   const FrameResources &frameData() const;
+  /// Runs a single defragmentation pass (if defragmentation is running).
+  /// \note The device must be idle.
+  VeResult defragmentationStep();
 
   FrameResources frames_[VENUS_MAX_SWAPCHAIN_IMAGE_COUNT];
   ImmediateSubmitResources imm_submit_data_;
   Output output_;
+  // memory defragmentation
+  mem::Defragmenter defragmenter_;
+  std::vector<RelocationCallback> relocation_callbacks_;
 
   h_size swapchain_image_count_{0};
   h_index current_frame_{0};
@@ -75,6 +75,7 @@ VeResult GraphicsEngine::Globals::Shaders::init(VkDevice vk_device) {
   CREATE_SHADER_MODULE(frag_mesh_pbr, mesh_pbr.frag.spv)
   CREATE_SHADER_MODULE(vert_vdb_volume, ve_vdb_volume.vert.spv)
   CREATE_SHADER_MODULE(frag_vdb_volume, ve_vdb_volume.frag.spv)
+  CREATE_SHADER_MODULE(vert_depth_prepass, depth_prepass.vert.spv)
 
   CREATE_SHADER_MODULE(vert_test, test.vert.spv)
   CREATE_SHADER_MODULE(vert_bindless_test, bindless_test.vert.spv)
@@ -89,6 +90,7 @@ VeResult GraphicsEngine::Globals::Shaders::init(VkDevice vk_device) {
 void GraphicsEngine::Globals::Shaders::clear() {
   vert_vdb_volume.destroy();
   frag_vdb_volume.destroy();
+  vert_depth_prepass.destroy();
 
   vert_mesh.destroy();
   frag_mesh_pbr.destroy();
@@ -108,6 +110,13 @@ VeResult GraphicsEngine::Globals::Materials::init(GraphicsDevice &gd) {
   VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
       gltf_metallic_roughness,
       scene::materials::GLTF_MetallicRoughness::material(gd));
+  VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
+      gltf_metallic_roughness_prepass,
+      scene::materials::GLTF_MetallicRoughness::material(gd, true));
+  VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
+      gltf_metallic_roughness_transparent,
+      scene::materials::GLTF_MetallicRoughness::material(
+          gd, false, scene::Material::Pass::TRANSPARENT_COLOR));
 #endif
 #ifdef VENUS_INCLUDE_VDB
   VENUS_ASSIGN_OR_RETURN_BAD_RESULT(vdb,
@@ -119,6 +128,8 @@ VeResult GraphicsEngine::Globals::Materials::init(GraphicsDevice &gd) {
 void GraphicsEngine::Globals::Materials::clear() {
 #ifdef VENUS_INCLUDE_GLTF
   gltf_metallic_roughness.destroy();
+  gltf_metallic_roughness_prepass.destroy();
+  gltf_metallic_roughness_transparent.destroy();
 #endif
 #ifdef VENUS_INCLUDE_VDB
   vdb.destroy();
@@ -420,10 +431,13 @@ mem::ImagePool &GraphicsEngine::Cache::images() { return images_; }
 
 scene::TextureCache &GraphicsEngine::Cache::textures() { return textures_; }
 
+scene::ShapeCache &GraphicsEngine::Cache::shapes() { return shapes_; }
+
 VeResult GraphicsEngine::Cache::cleanup() {
   buffers_.destroy();
   images_.destroy();
   textures_.clear();
+  shapes_.clear();
   return VeResult::noError();
 }
 
@@ -469,6 +483,11 @@ GraphicsEngine::Config &GraphicsEngine::Config::setDynamicRendering() {
   return *this;
 }
 
+GraphicsEngine::Config &GraphicsEngine::Config::setDrawIndirectCount() {
+  device_features_.v12_f.drawIndirectCount = true;
+  return *this;
+}
+
 GraphicsEngine::Config &GraphicsEngine::Config::setRayTracing() {
   device_features_.rt_pipeline_f.rayTracingPipeline = true;
   device_features_.acceleration_structures_f.accelerationStructure = true;
@@ -504,6 +523,34 @@ VENUS_DEFINE_SET_CONFIG_FIELD_METHOD(GraphicsEngine, setDeviceExtensions,
                                      const std::vector<std::string> &,
                                      device_extensions_ = value);
 
+GraphicsEngine::Config &GraphicsEngine::Config::enableMemoryPools() {
+  memory_pools_[core::MemoryClass::Staging] =
+      core::MemoryPool::Config::forStaging();
+  memory_pools_[core::MemoryClass::Uniform] =
+      core::MemoryPool::Config::forUniform();
+  memory_pools_[core::MemoryClass::Storage] =
+      core::MemoryPool::Config::forStorage();
+  memory_pools_[core::MemoryClass::Texture] =
+      core::MemoryPool::Config::forTexture();
+  memory_pools_[core::MemoryClass::Attachment] =
+      core::MemoryPool::Config::forAttachment();
+  memory_pools_[core::MemoryClass::DepthAttachment] =
+      core::MemoryPool::Config::forDepthAttachment();
+  if (device_features_.acceleration_structures_f.accelerationStructure) {
+    memory_pools_[core::MemoryClass::AccelerationStructure] =
+        core::MemoryPool::Config::forAccelerationStructure();
+    memory_pools_[core::MemoryClass::ShaderBindingTable] =
+        core::MemoryPool::Config::forShaderBindingTable();
+  }
+  return *this;
+}
+
+GraphicsEngine::Config &GraphicsEngine::Config::addMemoryPool(
+    core::MemoryClass memory_class, const core::MemoryPool::Config &config) {
+  memory_pools_[memory_class] = config;
+  return *this;
+}
+
 VeResult GraphicsEngine::Config::init(const io::Display *display) const {
 
   // vulkan instance
@@ -524,13 +571,15 @@ VeResult GraphicsEngine::Config::init(const io::Display *display) const {
       s_instance.surface_, display->createSurface(*s_instance.instance_));
 
   // graphics device
+  auto gd_config = engine::GraphicsDevice::Config()
+                       .setSurface(*s_instance.surface_)
+                       .setSurfaceExtent(display->resolution())
+                       .setFeatures(device_features_)
+                       .addExtensions(device_extensions_);
+  for (const auto &item : memory_pools_)
+    gd_config.addMemoryPool(item.first, item.second);
   VENUS_ASSIGN_OR_RETURN_BAD_RESULT(s_instance.gd_,
-                                    engine::GraphicsDevice::Config()
-                                        .setSurface(*s_instance.surface_)
-                                        .setSurfaceExtent(display->resolution())
-                                        .setFeatures(device_features_)
-                                        .addExtensions(device_extensions_)
-                                        .build(s_instance.instance_));
+                                    gd_config.build(s_instance.instance_));
 
   // init ui
 
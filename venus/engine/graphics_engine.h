@@ -28,6 +28,7 @@
 #pragma once
 
 #include <venus/engine/graphics_device.h>
+#include <venus/engine/shapes.h>
 #include <venus/io/display.h>
 #include <venus/pipeline/descriptors.h>
 #include <venus/scene/material.h>
@@ -65,9 +66,22 @@ public:
     /// Types used throughout the application code.
     struct Types {
       /// Common push constants for shaders.
+      /// \note See scene::materials::writeDrawPushConstants.
       struct DrawPushConstants {
         hermes::geo::Transform world_matrix;
         VkDeviceAddress vertex_buffer;
+        /// Transposed transforms indexed by gl_InstanceIndex (see
+        /// pipeline::Rasterizer::instanceObjects), replacing world_matrix
+        /// when set.
+        VkDeviceAddress instance_buffer;
+        /// Position stream of the mesh (the vertex buffer if the mesh has
+        /// none).
+        VkDeviceAddress position_buffer;
+        /// Non-zero if vertices are quantized (see mem::quantizeVertices).
+        u32 quantized;
+        /// Position dequantization of quantized vertices.
+        mem::Dequantization dequantization;
+        u32 padding;
       };
       /// Common scene data for shaders.
       struct CameraData {
@@ -83,6 +97,9 @@ public:
       pipeline::ShaderModule frag_mesh_pbr;
       pipeline::ShaderModule vert_vdb_volume;
       pipeline::ShaderModule frag_vdb_volume;
+      /// Position only vertex stage of depth prepasses of vert_mesh
+      /// materials, with DrawPushConstants and the scene data at set 0.
+      pipeline::ShaderModule vert_depth_prepass;
 
       // utils
 
@@ -99,6 +116,10 @@ public:
     /// \brief Set of materials provided by the graphics engine.
     struct Materials {
       scene::Material gltf_metallic_roughness;
+      /// gltf_metallic_roughness with a depth prepass.
+      scene::Material gltf_metallic_roughness_prepass;
+      /// Alpha blended gltf_metallic_roughness (blend alpha mode).
+      scene::Material gltf_metallic_roughness_transparent;
       scene::Material vdb;
       scene::Material color;
       scene::Material empty;
@@ -196,6 +217,8 @@ public:
     mem::BufferPool &buffers();
     mem::ImagePool &images();
     scene::TextureCache &textures();
+    /// \note Shared models of procedural shapes (see scene::ShapeCache).
+    scene::ShapeCache &shapes();
 
     /// Release and clears all resources.
     VeResult cleanup();
@@ -204,6 +227,7 @@ public:
     mem::BufferPool buffers_;
     mem::ImagePool images_;
     scene::TextureCache textures_;
+    scene::ShapeCache shapes_;
   };
 
   /// GraphicsEngine configuration.
@@ -213,15 +237,28 @@ public:
     Config &setShaderDemoteToHelperInvocation();
     Config &setDynamicRendering();
     Config &setRayTracing();
+    /// Enables draw counts sourced from buffers (see pipeline::DrawCuller).
+    Config &setDrawIndirectCount();
     Config &enableUI();
     Config &setDeviceFeatures(const core::vk::DeviceFeatures &features);
     Config &setDeviceExtensions(const std::vector<std::string> &extensions);
+    /// Creates dedicated memory pools for every resource class using the
+    /// default pool presets.
+    /// \note Ray tracing pools are only created if called after
+    ///       setRayTracing().
+    Config &enableMemoryPools();
+    /// \param memory_class Resource class served by the pool.
+    /// \param config Dedicated memory pool configuration.
+    Config &addMemoryPool(core::MemoryClass memory_class,
+                          const core::MemoryPool::Config &config);
 
     VeResult init(const io::Display *display) const;
 
   private:
     core::vk::DeviceFeatures device_features_;
     std::vector<std::string> device_extensions_;
+    std::unordered_map<core::MemoryClass, core::MemoryPool::Config>
+        memory_pools_;
     // TODO: this is not being used at all!
     bool enable_ui_{false};
   };
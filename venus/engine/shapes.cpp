@@ -364,3 +364,77 @@ Result<Model::Mesh> merge(const Model::Mesh &a, const Model::Mesh &b) {
 }
 
 } // namespace venus::scene::shapes
+
+namespace venus::scene {
+
+// Appends the bytes of the given values to the cache key.
+template <typename T>
+static void appendKey(std::string &key, std::initializer_list<T> values) {
+  for (const T &value : values)
+    key.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+static void appendKey(std::string &key, shape_options options) {
+  u32 mask = 0;
+  for (u32 bit = 1; bit <= static_cast<u32>(shape_option_bits::merge);
+       bit <<= 1)
+    if (options.contain(static_cast<shape_option_bits>(bit)))
+      mask |= bit;
+  appendKey<u32>(key, {mask});
+}
+
+Result<AllocatedModel::Ptr> ShapeCache::triangle(
+    const engine::GraphicsDevice &gd, const hermes::geo::point3 &a,
+    const hermes::geo::point3 &b, const hermes::geo::point3 &c,
+    shape_options options) {
+  std::string key = "triangle";
+  appendKey<real_t>(key, {a.x, a.y, a.z, b.x, b.y, b.z, c.x, c.y, c.z});
+  appendKey(key, options);
+  return get(key, gd, [&]() { return shapes::triangle(a, b, c, options); });
+}
+
+Result<AllocatedModel::Ptr>
+ShapeCache::box(const engine::GraphicsDevice &gd,
+                const hermes::geo::bounds::bbox3 &box, shape_options options) {
+  std::string key = "box";
+  appendKey<real_t>(key, {box.lower.x, box.lower.y, box.lower.z,
+                          box.upper.x, box.upper.y, box.upper.z});
+  appendKey(key, options);
+  return get(key, gd, [&]() { return shapes::box(box, options); });
+}
+
+Result<AllocatedModel::Ptr>
+ShapeCache::plane(const engine::GraphicsDevice &gd,
+                  const hermes::geo::Plane &plane,
+                  const hermes::geo::vec2 &scale, shape_options options) {
+  std::string key = "plane";
+  appendKey<real_t>(key, {plane.normal.x, plane.normal.y, plane.normal.z,
+                          plane.offset, scale.x, scale.y});
+  appendKey(key, options);
+  return get(key, gd, [&]() { return shapes::plane(plane, scale, options); });
+}
+
+Result<AllocatedModel::Ptr>
+ShapeCache::get(const std::string &key, const engine::GraphicsDevice &gd,
+                const std::function<Result<Model::Mesh>()> &generate) {
+  auto it = models_.find(key);
+  if (it != models_.end())
+    return Result<AllocatedModel::Ptr>(it->second);
+
+  VENUS_DECLARE_OR_RETURN_BAD_RESULT(Model::Mesh, mesh, generate());
+  VENUS_DECLARE_SHARED_PTR_FROM_RESULT_OR_RETURN_BAD_RESULT(
+      AllocatedModel, model, AllocatedModel::Config::fromMesh(mesh).build(gd));
+  models_[key] = model;
+  return Result<AllocatedModel::Ptr>(model);
+}
+
+void ShapeCache::relocate(const std::vector<mem::Relocation> &relocations) {
+  for (auto &item : models_)
+    item.second->relocate(relocations);
+}
+
+void ShapeCache::clear() { models_.clear(); }
+
+h_size ShapeCache::size() const { return models_.size(); }
+
+} // namespace venus::scene
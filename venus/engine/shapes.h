@@ -34,6 +34,9 @@
 
 #include <hermes/geometry/plane.h>
 
+#include <functional>
+#include <unordered_map>
+
 namespace venus::scene {
 
 /// Shape's mesh attributes and configurations
@@ -97,3 +100,69 @@ Result<Model::Mesh> plane(const hermes::geo::Plane &plane,
 Result<Model::Mesh> merge(const Model::Mesh &a, const Model::Mesh &b);
 
 } // namespace venus::scene::shapes
+
+namespace venus::scene {
+
+/// \brief Shares models of procedural shapes generated with the same
+///        parameters.
+/// Each shape (keyed by shape type, parameters and options) is generated and
+/// uploaded once, then every request returns the same model, which can be
+/// referenced by many nodes (see graph::ModelNode::setMaterialInstance).
+/// \note Shapes are compared by the exact bits of their parameters.
+class ShapeCache {
+public:
+  /// \note See shapes::triangle.
+  /// \return Shared model of the shape, or error.
+  HERMES_NODISCARD Result<AllocatedModel::Ptr>
+  triangle(const engine::GraphicsDevice &gd, const hermes::geo::point3 &a,
+           const hermes::geo::point3 &b, const hermes::geo::point3 &c,
+           shape_options options = shape_option_bits::none);
+  /// \note See shapes::box.
+  /// \return Shared model of the shape, or error.
+  HERMES_NODISCARD Result<AllocatedModel::Ptr>
+  box(const engine::GraphicsDevice &gd, const hermes::geo::bounds::bbox3 &box,
+      shape_options options = shape_option_bits::none);
+  /// \note See shapes::plane.
+  /// \return Shared model of the shape, or error.
+  HERMES_NODISCARD Result<AllocatedModel::Ptr>
+  plane(const engine::GraphicsDevice &gd, const hermes::geo::Plane &plane,
+        const hermes::geo::vec2 &scale,
+        shape_options options = shape_option_bits::none);
+  /// Patches the cached models whose buffers were moved by the
+  /// defragmenter.
+  /// \param relocations Handles replaced by a defragmentation pass.
+  void relocate(const std::vector<mem::Relocation> &relocations);
+  /// Releases the cache references (models still referenced elsewhere are
+  /// kept alive by their users).
+  void clear();
+  /// \return Number of cached shapes.
+  h_size size() const;
+
+private:
+  HERMES_NODISCARD Result<AllocatedModel::Ptr>
+  get(const std::string &key, const engine::GraphicsDevice &gd,
+      const std::function<Result<Model::Mesh>()> &generate);
+
+  std::unordered_map<std::string, AllocatedModel::Ptr> models_;
+
+#ifdef VENUS_INCLUDE_DEBUG_TRAITS
+  friend struct hermes::DebugTraits<ShapeCache>;
+#endif
+};
+
+} // namespace venus::scene
+
+#ifdef VENUS_INCLUDE_DEBUG_TRAITS
+namespace hermes {
+
+template <> struct DebugTraits<venus::scene::ShapeCache> {
+  static HERMES_CONST_OR_CONSTEXPR bool is_string_serializable = true;
+  static DebugMessage message(const venus::scene::ShapeCache &data) {
+    return DebugMessage()
+        .addTitle("Shape Cache")
+        .add("cached shapes", data.models_.size());
+  }
+};
+
+} // namespace hermes
+#endif // VENUS_INCLUDE_DEBUG_TRAITS
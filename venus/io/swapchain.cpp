@@ -213,9 +213,12 @@ Result<Swapchain> Swapchain::Config::build(const core::Device &device) const {
     swapchain.image_views_.emplace_back(std::move(view));
   }
 
+  // depth is only consumed within the frame rendering
   VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
       swapchain.depth_buffer_,
-      mem::AllocatedImage::Config::forDepthBuffer(extent).build(device));
+      mem::AllocatedImage::Config::forDepthBuffer(extent)
+          .enableTransient()
+          .build(device));
 
   VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
       swapchain.depth_buffer_view_,
@@ -169,7 +169,8 @@ AllocatedBuffer::Config::forStaging(h_size size_in_bytes) {
       .setSize(size_in_bytes)
       .setAllocationFlags(VMA_ALLOCATION_CREATE_MAPPED_BIT)
       .addUsage(VK_BUFFER_USAGE_TRANSFER_SRC_BIT)
-      .setMemoryUsage(VMA_MEMORY_USAGE_CPU_ONLY);
+      .setMemoryUsage(VMA_MEMORY_USAGE_CPU_ONLY)
+      .setMemoryClass(core::MemoryClass::Staging);
 }
 
 AllocatedBuffer::Config
@@ -180,7 +181,9 @@ AllocatedBuffer::Config::forUniform(h_size size_in_bytes) {
       .addUsage(VK_BUFFER_USAGE_TRANSFER_DST_BIT)
       .setSize(size_in_bytes)
       // memory
-      .setHostVisible();
+      .setHostVisible()
+      .enablePersistentMapping()
+      .setMemoryClass(core::MemoryClass::Uniform);
 }
 
 AllocatedBuffer::Config
@@ -194,7 +197,30 @@ AllocatedBuffer::Config::forStorage(h_size size_in_bytes,
       .addUsage(usage)
       .enableShaderDeviceAddress()
       // memory
-      .setDeviceLocal();
+      .setDeviceLocal()
+      .setMemoryClass(core::MemoryClass::Storage);
+}
+
+AllocatedBuffer::Config
+AllocatedBuffer::Config::forDirectWrite(h_size size_in_bytes,
+                                        VkBufferUsageFlags usage) {
+  return AllocatedBuffer::Config()
+      // buffer
+      .addUsage(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)
+      .addUsage(VK_BUFFER_USAGE_TRANSFER_DST_BIT)
+      .setSize(size_in_bytes)
+      .addUsage(usage)
+      .enableShaderDeviceAddress()
+      // memory
+      .setDeviceLocal()
+      .enableDirectWrite()
+      .setMemoryCategory(core::MemoryCategory::Geometry);
+}
+
+AllocatedBuffer::Config
+AllocatedBuffer::Config::forVertices(h_size size_in_bytes) {
+  return AllocatedBuffer::Config::forDirectWrite(
+      size_in_bytes, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
 }
 
 AllocatedBuffer::Config
@@ -204,7 +230,8 @@ AllocatedBuffer::Config::forAccelerationStructure(h_size size_in_bytes) {
              VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR)
       .setMemoryUsage(VMA_MEMORY_USAGE_CPU_TO_GPU)
       .enableShaderDeviceAddress()
-      .setDeviceLocal();
+      .setDeviceLocal()
+      .setMemoryClass(core::MemoryClass::AccelerationStructure);
 }
 
 AllocatedBuffer::Config
@@ -216,22 +243,42 @@ AllocatedBuffer::Config::forShaderBindingTable(h_size size_in_bytes) {
       .enableShaderDeviceAddress()
       .setSize(size_in_bytes)
       // memory
-      .setMemoryUsage(VMA_MEMORY_USAGE_CPU_TO_GPU);
+      .setMemoryUsage(VMA_MEMORY_USAGE_CPU_TO_GPU)
+      .setMemoryClass(core::MemoryClass::ShaderBindingTable);
 }
 
 Result<AllocatedBuffer>
 AllocatedBuffer::Config::build(const core::Device &device) const {
   auto info = createInfo();
-
+  // relocated buffers get their contents copied into a new buffer
+  if (relocatable_)
+    info.usage |=
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+  // class pools only serve requirements matching their memory type and blocks
+  VkDeviceBufferMemoryRequirements device_info{};
+  device_info.sType = VK_STRUCTURE_TYPE_DEVICE_BUFFER_MEMORY_REQUIREMENTS;
+  device_info.pCreateInfo = &info;
+  VkMemoryRequirements2 requirements{};
+  requirements.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+  vkGetDeviceBufferMemoryRequirements(*device, &device_info, &requirements);
+
+  auto alloc_info =
+      allocationCreateInfo(device, requirements.memoryRequirements);
   VkBuffer vk_buffer{VK_NULL_HANDLE};
   VmaAllocation vma_allocation{VK_NULL_HANDLE};
-  VENUS_VK_RETURN_BAD_RESULT(
-      vmaCreateBuffer(device.allocator(), &info, &vma_allocation_create_info_,
-                      &vk_buffer, &vma_allocation, nullptr));
+  VENUS_VK_RETURN_BAD_RESULT(vmaCreateBuffer(device.allocator(), &info,
+                                             &alloc_info, &vk_buffer,
+                                             &vma_allocation, nullptr));
 
   AllocatedBuffer buffer;
   buffer.vma_allocator_ = device.allocator();
   buffer.vma_allocation_ = vma_allocation;
+  buffer.track(device, memoryCategory());
+  buffer.relocatable_ = relocatable_;
+  buffer.vk_buffer_info_ = info;
+  buffer.bindOwner();
+  buffer.initMapping();
 
   if (info.usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT)
     buffer.vk_device_address_ = 0;
@@ -260,11 +307,62 @@ void AllocatedBuffer::swap(AllocatedBuffer &rhs) noexcept {
   VENUS_SWAP_FIELD_WITH_RHS(vk_memory_requirements_);
   VENUS_SWAP_FIELD_WITH_RHS(vma_allocator_);
   VENUS_SWAP_FIELD_WITH_RHS(vma_allocation_);
+  VENUS_SWAP_FIELD_WITH_RHS(memory_budget_);
+  VENUS_SWAP_FIELD_WITH_RHS(memory_category_);
+  VENUS_SWAP_FIELD_WITH_RHS(relocatable_);
+  VENUS_SWAP_FIELD_WITH_RHS(vk_buffer_info_);
+  VENUS_SWAP_FIELD_WITH_RHS(relocated_vk_buffer_);
+  VENUS_SWAP_FIELD_WITH_RHS(mapped_);
+  VENUS_SWAP_FIELD_WITH_RHS(map_count_);
+  VENUS_SWAP_FIELD_WITH_RHS(persistently_mapped_);
+  VENUS_SWAP_FIELD_WITH_RHS(vk_memory_properties_);
+  bindOwner();
+  rhs.bindOwner();
 }
 
 AllocatedBuffer::operator bool() const { return vk_buffer_ != VK_NULL_HANDLE; }
 
+VeResult AllocatedBuffer::recordRelocation(VmaAllocation dst_allocation,
+                                           VkCommandBuffer vk_command_buffer) {
+  VENUS_VK_RETURN_BAD_RESULT(vkCreateBuffer(vk_device_, &vk_buffer_info_,
+                                            nullptr, &relocated_vk_buffer_));
+  VkResult result =
+      vmaBindBufferMemory(vma_allocator_, dst_allocation, relocated_vk_buffer_);
+  if (result != VK_SUCCESS) {
+    cancelRelocation();
+    VENUS_VK_RETURN_BAD_RESULT(result);
+  }
+  VkBufferCopy region{};
+  region.srcOffset = 0;
+  region.dstOffset = 0;
+  region.size = vk_buffer_info_.size;
+  vkCmdCopyBuffer(vk_command_buffer, vk_buffer_, relocated_vk_buffer_, 1,
+                  &region);
+  return VeResult::noError();
+}
+
+Relocation AllocatedBuffer::commitRelocation() {
+  Relocation relocation;
+  relocation.old_buffer = vk_buffer_;
+  relocation.old_address = vk_device_address_.value_or(0);
+  vkDestroyBuffer(vk_device_, vk_buffer_, nullptr);
+  init(vk_device_, relocated_vk_buffer_);
+  relocated_vk_buffer_ = VK_NULL_HANDLE;
+  relocation.new_buffer = vk_buffer_;
+  relocation.new_address = vk_device_address_.value_or(0);
+  return relocation;
+}
+
+void AllocatedBuffer::cancelRelocation() noexcept {
+  if (vk_device_ && relocated_vk_buffer_)
+    vkDestroyBuffer(vk_device_, relocated_vk_buffer_, nullptr);
+  relocated_vk_buffer_ = VK_NULL_HANDLE;
+}
+
 void AllocatedBuffer::destroy() noexcept {
+  cancelRelocation();
+  releaseMapping();
+  untrack();
   if (vma_allocator_ && vma_allocation_)
     vmaDestroyBuffer(vma_allocator_, vk_buffer_, vma_allocation_);
   vma_allocation_ = VK_NULL_HANDLE;
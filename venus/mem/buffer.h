@@ -274,6 +274,18 @@ public:
     static Config forStaging(h_size size_in_bytes);
     static Config forUniform(h_size size_in_bytes);
     static Config forStorage(h_size size_in_bytes, VkBufferUsageFlags usage);
+    /// \brief Setup for device local buffers the host writes directly into.
+    /// When the device exposes host visible device local memory (UMA, ReBAR),
+    /// data is copied without staging buffers (see BufferWritter). Plain
+    /// device local memory is used otherwise.
+    /// \note This sets usage flags as eStorageBuffer and eTransferDst.
+    /// \param size_in_bytes
+    /// \param usage Additional usage flags.
+    static Config forDirectWrite(h_size size_in_bytes,
+                                 VkBufferUsageFlags usage);
+    /// \brief Direct write setup for vertex buffers.
+    /// \param size_in_bytes
+    static Config forVertices(h_size size_in_bytes);
     static Config forAccelerationStructure(h_size size_in_bytes);
     static Config forShaderBindingTable(h_size size_in_bytes);
 
@@ -296,7 +308,17 @@ public:
   void swap(AllocatedBuffer &rhs) noexcept;
   operator bool() const;
 
+protected:
+  VeResult recordRelocation(VmaAllocation dst_allocation,
+                            VkCommandBuffer vk_command_buffer) override;
+  Relocation commitRelocation() override;
+  void cancelRelocation() noexcept override;
+
 private:
+  // kept for recreating the buffer when relocated
+  VkBufferCreateInfo vk_buffer_info_{};
+  VkBuffer relocated_vk_buffer_{VK_NULL_HANDLE};
+
 #ifdef VENUS_INCLUDE_DEBUG_TRAITS
   friend struct hermes::DebugTraits<AllocatedBuffer>;
 #endif
@@ -0,0 +1,164 @@
+/* Copyright (c) 2025, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+/// \file   defragmenter.cpp
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-18
+
+#include <venus/mem/defragmenter.h>
+
+#include <venus/utils/vk_debug.h>
+
+namespace venus::mem {
+
+VENUS_DEFINE_SET_CONFIG_FIELD_METHOD(Defragmenter, setPool, VmaPool,
+                                     info_.pool = value)
+VENUS_DEFINE_SET_CONFIG_FIELD_METHOD(Defragmenter, setAlgorithm,
+                                     VmaDefragmentationFlags,
+                                     info_.flags = value)
+VENUS_DEFINE_SET_CONFIG_FIELD_METHOD(Defragmenter, setMaxBytesPerPass,
+                                     VkDeviceSize,
+                                     info_.maxBytesPerPass = value)
+VENUS_DEFINE_SET_CONFIG_FIELD_METHOD(Defragmenter, setMaxAllocationsPerPass,
+                                     u32, info_.maxAllocationsPerPass = value)
+
+Result<Defragmenter>
+Defragmenter::Config::build(const core::Device &device) const {
+  Defragmenter defragmenter;
+  VENUS_VK_RETURN_BAD_RESULT(vmaBeginDefragmentation(
+      device.allocator(), &info_, &defragmenter.vma_context_));
+  defragmenter.vma_allocator_ = device.allocator();
+  return Result<Defragmenter>(std::move(defragmenter));
+}
+
+Defragmenter::Defragmenter(Defragmenter &&rhs) noexcept {
+  *this = std::move(rhs);
+}
+
+Defragmenter::~Defragmenter() noexcept { destroy(); }
+
+Defragmenter &Defragmenter::operator=(Defragmenter &&rhs) noexcept {
+  destroy();
+  swap(rhs);
+  return *this;
+}
+
+void Defragmenter::destroy() noexcept {
+  if (in_pass_) {
+    for (u32 i = 0; i < vma_pass_.moveCount; ++i) {
+      if (owners_[i])
+        owners_[i]->cancelRelocation();
+      vma_pass_.pMoves[i].operation =
+          VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+    }
+    vmaEndDefragmentationPass(vma_allocator_, vma_context_, &vma_pass_);
+    in_pass_ = false;
+  }
+  finish();
+  vma_allocator_ = VK_NULL_HANDLE;
+  owners_.clear();
+}
+
+void Defragmenter::swap(Defragmenter &rhs) noexcept {
+  VENUS_SWAP_FIELD_WITH_RHS(vma_allocator_);
+  VENUS_SWAP_FIELD_WITH_RHS(vma_context_);
+  VENUS_SWAP_FIELD_WITH_RHS(vma_pass_);
+  VENUS_SWAP_FIELD_WITH_RHS(owners_);
+  VENUS_SWAP_FIELD_WITH_RHS(in_pass_);
+  VENUS_SWAP_FIELD_WITH_RHS(stats_);
+}
+
+Result<bool> Defragmenter::beginPass(VkCommandBuffer vk_command_buffer) {
+  if (!vma_context_)
+    return Result<bool>(false);
+  HERMES_ASSERT(!in_pass_);
+
+  VkResult result =
+      vmaBeginDefragmentationPass(vma_allocator_, vma_context_, &vma_pass_);
+  // VK_SUCCESS means there is nothing left to be moved
+  if (result == VK_SUCCESS) {
+    finish();
+    return Result<bool>(false);
+  }
+  if (result != VK_INCOMPLETE)
+    VENUS_VK_RETURN_BAD_RESULT(result);
+
+  in_pass_ = true;
+  owners_.assign(vma_pass_.moveCount, nullptr);
+  for (u32 i = 0; i < vma_pass_.moveCount; ++i) {
+    auto &move = vma_pass_.pMoves[i];
+    VmaAllocationInfo info{};
+    vmaGetAllocationInfo(vma_allocator_, move.srcAllocation, &info);
+    auto *owner = static_cast<DeviceMemory *>(info.pUserData);
+    // allocations whose owners don't know how to move are kept in place
+    if (!owner || !owner->relocatable_ || owner->map_count_ ||
+        !owner->recordRelocation(move.dstTmpAllocation, vk_command_buffer)) {
+      move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+      continue;
+    }
+    owners_[i] = owner;
+  }
+  return Result<bool>(true);
+}
+
+Result<std::vector<Relocation>> Defragmenter::endPass() {
+  if (!in_pass_)
+    return Result<std::vector<Relocation>>(std::vector<Relocation>());
+
+  std::vector<Relocation> relocations;
+  std::vector<DeviceMemory *> moved;
+  for (u32 i = 0; i < vma_pass_.moveCount; ++i)
+    if (owners_[i] && vma_pass_.pMoves[i].operation ==
+                          VMA_DEFRAGMENTATION_MOVE_OPERATION_COPY) {
+      relocations.emplace_back(owners_[i]->commitRelocation());
+      moved.emplace_back(owners_[i]);
+    }
+  owners_.clear();
+
+  VkResult result =
+      vmaEndDefragmentationPass(vma_allocator_, vma_context_, &vma_pass_);
+  in_pass_ = false;
+  // persistent maps of moved allocations point to the new memory now
+  for (auto *owner : moved)
+    owner->initMapping();
+  if (result == VK_SUCCESS)
+    finish();
+  else if (result != VK_INCOMPLETE)
+    VENUS_VK_RETURN_BAD_RESULT(result);
+
+  return Result<std::vector<Relocation>>(std::move(relocations));
+}
+
+Defragmenter::operator bool() const { return vma_context_ != VK_NULL_HANDLE; }
+
+const VmaDefragmentationStats &Defragmenter::statistics() const {
+  return stats_;
+}
+
+void Defragmenter::finish() noexcept {
+  if (vma_allocator_ && vma_context_)
+    vmaEndDefragmentation(vma_allocator_, vma_context_, &stats_);
+  vma_context_ = VK_NULL_HANDLE;
+}
+
+} // namespace venus::mem
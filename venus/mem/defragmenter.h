@@ -0,0 +1,149 @@
+/* Copyright (c) 2025, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+/// \file   defragmenter.h
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-18
+/// \brief  Incremental device memory defragmentation
+
+#pragma once
+
+#include <venus/mem/device_memory.h>
+
+#include <vector>
+
+namespace venus::mem {
+
+/// Moves device memory allocations to reduce fragmentation. The work is split
+/// in passes, each moving a bounded amount of memory, so it can be spread over
+/// multiple frames:
+///   - beginPass() creates the moved resources in their new allocations and
+///     records the copies of their contents.
+///   - endPass() replaces the resources once the copies are completed and
+///     releases the previous memory.
+/// \note Only buffers built with enableRelocation() are moved. Memory with
+///       active maps (map()/ScopedMap) is never moved, persistent maps are
+///       updated.
+/// \note Moved resources can't be in use by the device between beginPass()
+///       and endPass(), and handles cached by their owners must be patched
+///       with the relocations returned by endPass() (buffer handles, device
+///       addresses and anything holding them, such as push constants).
+/// \note This class uses RAII.
+class Defragmenter {
+public:
+  struct Config {
+    /// \param pool Pool to be defragmented. If not set, default pools are
+    ///             defragmented.
+    Config &setPool(VmaPool pool);
+    /// \param flags Algorithm flags (VMA_DEFRAGMENTATION_FLAG_ALGORITHM_*).
+    Config &setAlgorithm(VmaDefragmentationFlags flags);
+    /// \param size_in_bytes Maximum number of bytes moved by a single pass.
+    ///                      0 means no limit.
+    Config &setMaxBytesPerPass(VkDeviceSize size_in_bytes);
+    /// \param count Maximum number of allocations moved by a single pass.
+    ///              0 means no limit.
+    Config &setMaxAllocationsPerPass(u32 count);
+    /// Starts the defragmentation.
+    /// \param device Device holding the allocator.
+    /// \return defragmenter or error.
+    HERMES_NODISCARD Result<Defragmenter>
+    build(const core::Device &device) const;
+
+  private:
+    VmaDefragmentationInfo info_{};
+
+#ifdef VENUS_INCLUDE_DEBUG_TRAITS
+    friend struct hermes::DebugTraits<Defragmenter::Config>;
+#endif
+  };
+
+  // raii
+
+  VENUS_DECLARE_RAII_FUNCTIONS(Defragmenter)
+
+  /// Finishes the defragmentation.
+  /// \note Pending moves of an unfinished pass are discarded.
+  void destroy() noexcept;
+  void swap(Defragmenter &rhs) noexcept;
+  /// Starts a new pass and records the copies of the moved resources.
+  /// \param vk_command_buffer Command buffer recording the copies.
+  /// \return True if resources are being moved. False if the defragmentation
+  ///         finished.
+  HERMES_NODISCARD Result<bool> beginPass(VkCommandBuffer vk_command_buffer);
+  /// Replaces the moved resources and releases their previous memory.
+  /// \note The copies recorded by beginPass() must be completed.
+  /// \return Handles replaced during the pass.
+  HERMES_NODISCARD Result<std::vector<Relocation>> endPass();
+  /// \return True if the defragmentation is still running.
+  operator bool() const;
+  /// \return Statistics of the defragmentation.
+  /// \note Statistics are only available after the defragmentation finishes.
+  const VmaDefragmentationStats &statistics() const;
+
+private:
+  void finish() noexcept;
+
+  VmaAllocator vma_allocator_{VK_NULL_HANDLE};
+  VmaDefragmentationContext vma_context_{VK_NULL_HANDLE};
+  VmaDefragmentationPassMoveInfo vma_pass_{};
+  // owners of the allocations moved in the current pass
+  std::vector<DeviceMemory *> owners_;
+  bool in_pass_{false};
+  VmaDefragmentationStats stats_{};
+
+#ifdef VENUS_INCLUDE_DEBUG_TRAITS
+  friend struct hermes::DebugTraits<Defragmenter>;
+#endif
+};
+
+} // namespace venus::mem
+
+#ifdef VENUS_INCLUDE_DEBUG_TRAITS
+
+namespace hermes {
+
+template <> struct DebugTraits<venus::mem::Defragmenter::Config> {
+  static HERMES_CONST_OR_CONSTEXPR bool is_string_serializable = true;
+  static DebugMessage message(const venus::mem::Defragmenter::Config &data) {
+    return DebugMessage()
+        .addTitle("Defragmenter Config")
+        .add("max bytes per pass", data.info_.maxBytesPerPass)
+        .add("max allocations per pass", data.info_.maxAllocationsPerPass);
+  }
+};
+
+template <> struct DebugTraits<venus::mem::Defragmenter> {
+  static HERMES_CONST_OR_CONSTEXPR bool is_string_serializable = true;
+  static DebugMessage message(const venus::mem::Defragmenter &data) {
+    return DebugMessage()
+        .addTitle("Defragmenter")
+        .add("bytes moved", data.stats_.bytesMoved)
+        .add("bytes freed", data.stats_.bytesFreed)
+        .add("allocations moved", data.stats_.allocationsMoved)
+        .add("blocks freed", data.stats_.deviceMemoryBlocksFreed);
+  }
+};
+
+} // namespace hermes
+
+#endif // VENUS_INCLUDE_DEBUG_TRAITS
@@ -28,6 +28,8 @@
 
 #include <venus/utils/vk_debug.h>
 
+#include <cstring>
+
 #ifdef HERMES_LINUX
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-function"
@@ -64,10 +66,15 @@ DeviceMemory::Config::build(const core::Device &device) const {
 
   DeviceMemory device_memory;
 
-  VENUS_VK_RETURN_BAD_RESULT(vmaAllocateMemory(
-      device.allocator(), &requirements_, &vma_allocation_create_info_,
-      &device_memory.vma_allocation_, nullptr));
+  auto alloc_info = allocationCreateInfo(device, requirements_);
+  VENUS_VK_RETURN_BAD_RESULT(
+      vmaAllocateMemory(device.allocator(), &requirements_, &alloc_info,
+                        &device_memory.vma_allocation_, nullptr));
   device_memory.vma_allocator_ = device.allocator();
+  device_memory.track(device, memoryCategory());
+  device_memory.relocatable_ = relocatable_;
+  device_memory.bindOwner();
+  device_memory.initMapping();
 
 #ifdef VENUS_DEBUG
   device_memory.config_ = static_cast<const DeviceMemory::Config &>(*this);
@@ -76,9 +83,39 @@ DeviceMemory::Config::build(const core::Device &device) const {
 }
 
 DeviceMemory::ScopedMap::ScopedMap(DeviceMemory &memory, void *mapped) noexcept
-    : memory_(memory), mapped_(mapped) {}
+    : memory_(&memory), mapped_(mapped) {}
+
+DeviceMemory::ScopedMap::ScopedMap(ScopedMap &&rhs) noexcept {
+  *this = std::move(rhs);
+}
+
+DeviceMemory::ScopedMap::~ScopedMap() noexcept {
+  if (memory_)
+    memory_->unmap();
+}
+
+DeviceMemory::ScopedMap &
+DeviceMemory::ScopedMap::operator=(ScopedMap &&rhs) noexcept {
+  if (memory_)
+    memory_->unmap();
+  memory_ = rhs.memory_;
+  mapped_ = rhs.mapped_;
+  rhs.memory_ = nullptr;
+  rhs.mapped_ = nullptr;
+  return *this;
+}
 
-DeviceMemory::ScopedMap::~ScopedMap() noexcept { memory_.unmap(); }
+VeResult DeviceMemory::ScopedMap::flush(VkDeviceSize size_in_bytes,
+                                        VkDeviceSize offset) {
+  HERMES_ASSERT(memory_);
+  return memory_->flush(size_in_bytes, offset);
+}
+
+VeResult DeviceMemory::ScopedMap::invalidate(VkDeviceSize size_in_bytes,
+                                             VkDeviceSize offset) {
+  HERMES_ASSERT(memory_);
+  return memory_->invalidate(size_in_bytes, offset);
+}
 
 DeviceMemory::DeviceMemory(DeviceMemory &&rhs) noexcept {
   *this = std::move(rhs);
@@ -100,13 +137,10 @@ Result<DeviceMemory::ScopedMap> DeviceMemory::scopedMap() {
 }
 
 Result<void *> DeviceMemory::map() const {
-  if (mapped_) {
-    HERMES_WARN("Mapping an already mapped device memory. A device memory can "
-                "only have one mapped memory at a time.");
-    return Result<void *>(mapped_);
-  }
-  VENUS_VK_RETURN_BAD_RESULT(
-      vmaMapMemory(vma_allocator_, vma_allocation_, &mapped_));
+  if (!mapped_)
+    VENUS_VK_RETURN_BAD_RESULT(
+        vmaMapMemory(vma_allocator_, vma_allocation_, &mapped_));
+  ++map_count_;
   // vkMapMemory(vk_device_, vk_device_memory_, offset,
   //                                        size ? size : size_, flags,
   //                                        &mapped_));
@@ -123,12 +157,16 @@ VeResult DeviceMemory::access(const std::function<void(void *)> &f) const {
 }
 
 void DeviceMemory::unmap() const {
-  if (mapped_) {
+  if (!map_count_)
+    return;
+  if (--map_count_ == 0 && !persistently_mapped_) {
     vmaUnmapMemory(vma_allocator_, vma_allocation_);
     mapped_ = nullptr;
   }
 }
 
+void *DeviceMemory::mapped() const { return mapped_; }
+
 VeResult DeviceMemory::flush(VkDeviceSize size, VkDeviceSize offset) {
   VENUS_VK_RETURN_BAD_RESULT(
       vmaFlushAllocation(vma_allocator_, vma_allocation_, offset, size));
@@ -144,13 +182,23 @@ VeResult DeviceMemory::invalidate(VkDeviceSize size, VkDeviceSize offset) {
 void DeviceMemory::swap(DeviceMemory &rhs) noexcept {
   VENUS_SWAP_FIELD_WITH_RHS(vma_allocation_);
   VENUS_SWAP_FIELD_WITH_RHS(vma_allocator_);
+  VENUS_SWAP_FIELD_WITH_RHS(memory_budget_);
+  VENUS_SWAP_FIELD_WITH_RHS(memory_category_);
+  VENUS_SWAP_FIELD_WITH_RHS(relocatable_);
+  VENUS_SWAP_FIELD_WITH_RHS(mapped_);
+  VENUS_SWAP_FIELD_WITH_RHS(map_count_);
+  VENUS_SWAP_FIELD_WITH_RHS(persistently_mapped_);
+  VENUS_SWAP_FIELD_WITH_RHS(vk_memory_properties_);
 #ifdef VENUS_DEBUG
   VENUS_SWAP_FIELD_WITH_RHS(config_);
 #endif
+  bindOwner();
+  rhs.bindOwner();
 }
 
 void DeviceMemory::destroy() noexcept {
-  unmap();
+  releaseMapping();
+  untrack();
   if (vma_allocation_ && vma_allocator_)
     vmaFreeMemory(vma_allocator_, vma_allocation_);
   vma_allocator_ = VK_NULL_HANDLE;
@@ -165,6 +213,14 @@ VeResult DeviceMemory::copy(const void *data, VkDeviceSize size_in_bytes,
 
   HERMES_UNUSED_VARIABLE(flags);
 
+  if (persistently_mapped_) {
+    std::memcpy(reinterpret_cast<u8 *>(mapped_) + offset, data,
+                size_in_bytes);
+    if (!isHostCoherent())
+      return flush(size_in_bytes, offset);
+    return VeResult::noError();
+  }
+
   // void *dst{nullptr};
   // VENUS_ASSIGN_OR_RETURN_BAD_RESULT(dst,
   //                                         map(size_in_bytes, offset, flags));
@@ -180,4 +236,72 @@ VeResult DeviceMemory::copy(const void *data, VkDeviceSize size_in_bytes,
 
 VkDeviceSize DeviceMemory::size() const { return vma_allocation_->GetSize(); }
 
+bool DeviceMemory::isRelocatable() const { return relocatable_; }
+
+bool DeviceMemory::isHostVisible() const {
+  return vk_memory_properties_ & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+}
+
+bool DeviceMemory::isHostCoherent() const {
+  return vk_memory_properties_ & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+}
+
+bool DeviceMemory::isPersistentlyMapped() const {
+  return persistently_mapped_;
+}
+
+VeResult DeviceMemory::recordRelocation(VmaAllocation dst_allocation,
+                                        VkCommandBuffer vk_command_buffer) {
+  HERMES_UNUSED_VARIABLE(dst_allocation);
+  HERMES_UNUSED_VARIABLE(vk_command_buffer);
+  return VeResult::incompatible();
+}
+
+Relocation DeviceMemory::commitRelocation() { return {}; }
+
+void DeviceMemory::cancelRelocation() noexcept {}
+
+void DeviceMemory::bindOwner() noexcept {
+  if (vma_allocator_ && vma_allocation_)
+    vmaSetAllocationUserData(vma_allocator_, vma_allocation_, this);
+}
+
+void DeviceMemory::initMapping() noexcept {
+  if (!vma_allocator_ || !vma_allocation_)
+    return;
+  vmaGetAllocationMemoryProperties(vma_allocator_, vma_allocation_,
+                                   &vk_memory_properties_);
+  // allocations created with VMA_ALLOCATION_CREATE_MAPPED_BIT are kept mapped
+  // by the allocator
+  VmaAllocationInfo info{};
+  vmaGetAllocationInfo(vma_allocator_, vma_allocation_, &info);
+  persistently_mapped_ = info.pMappedData != nullptr;
+  if (persistently_mapped_)
+    mapped_ = info.pMappedData;
+}
+
+void DeviceMemory::releaseMapping() noexcept {
+  if (mapped_ && !persistently_mapped_ && vma_allocator_ && vma_allocation_)
+    vmaUnmapMemory(vma_allocator_, vma_allocation_);
+  mapped_ = nullptr;
+  map_count_ = 0;
+  persistently_mapped_ = false;
+}
+
+void DeviceMemory::track(const core::Device &device,
+                         core::MemoryCategory category) {
+  memory_budget_ = &device.memoryBudget();
+  memory_category_ = category;
+  memory_budget_->add(category, size());
+  // name allocations so they can be identified in the allocator stats dump
+  vmaSetAllocationName(vma_allocator_, vma_allocation_,
+                       core::memoryCategoryName(category).data());
+}
+
+void DeviceMemory::untrack() noexcept {
+  if (memory_budget_ && vma_allocation_)
+    memory_budget_->remove(memory_category_, size());
+  memory_budget_ = nullptr;
+}
+
 } // namespace venus::mem
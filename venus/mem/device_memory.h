@@ -29,8 +29,20 @@
 
 #include <venus/core/device.h>
 
+#include <algorithm>
+#include <optional>
+
 namespace venus::mem {
 
+/// Vulkan handles replaced when a buffer is moved into a new allocation.
+/// \note Addresses are zero for buffers without device addresses.
+struct Relocation {
+  VkBuffer old_buffer{VK_NULL_HANDLE};
+  VkBuffer new_buffer{VK_NULL_HANDLE};
+  VkDeviceAddress old_address{0};
+  VkDeviceAddress new_address{0};
+};
+
 /// Holds memory allocated in the device memory.
 /// \note This class uses RAII.
 class DeviceMemory {
@@ -55,20 +67,68 @@ public:
     Derived &addMemoryType(u32 type_bits);
     /// \param pool (vma)
     Derived &setPool(VmaPool pool);
+    /// Allocates from the device dedicated pool of the given resource class
+    /// (if any).
+    /// \note An explicit pool set by setPool takes precedence.
+    /// \param memory_class Resource class.
+    Derived &setMemoryClass(core::MemoryClass memory_class);
+    /// Sets the category under which this memory is accounted in the device
+    /// memory budget.
+    /// \note If not set, the category is deduced from the memory class.
+    /// \param category Memory category.
+    Derived &setMemoryCategory(core::MemoryCategory category);
+    /// Keeps the memory mapped for its whole lifetime, so mapped() holds a
+    /// stable host pointer and map()/unmap() don't reach the driver.
+    /// \note Only effective for host visible memory.
+    Derived &enablePersistentMapping();
+    /// Allows the defragmenter to move this memory into a new allocation.
+    /// \note Owners of relocatable memory must patch handles they cache (see
+    ///       Defragmenter).
+    /// \note Only buffers are moved. Images stay in place, since their views
+    ///       and the descriptor sets sampling them can't be patched.
+    Derived &enableRelocation();
     /// \param priority value in [0,1]
     Derived &setPriority(f32 priority);
     /// \param requirements new memory requirements.
     Derived &setMemoryRequirements(const VkMemoryRequirements &requirements);
+    /// Extends the memory requirements so the memory can also back a
+    /// resource with the given requirements. Resources whose lifetimes don't
+    /// overlap can then alias the same allocation.
+    /// \note Size and alignment are the maximum of all requirements, memory
+    ///       types are the ones accepted by all of them.
+    /// \param requirements Aliased resource memory requirements.
+    Derived &addAliasedRequirements(const VkMemoryRequirements &requirements);
     /// Set memory host visible.
     /// \note This sets memory properties eHostCoherent and eHostVisible.
     Derived &setHostVisible();
     /// Set memory host visible.
     /// \note This sets memory properties eDeviceLocal.
     Derived &setDeviceLocal();
+    /// Requests device memory the host can write directly into (host visible
+    /// device local memory of UMA and ReBAR devices), falling back to memory
+    /// that must be written through transfers.
+    /// \note Only for buffers and images, as this sets automatic memory usage.
+    /// \note Dedicated class pools are skipped, since they are bound to a
+    ///       single memory type.
+    /// \note Use isHostVisible() to check the resulting memory.
+    Derived &enableDirectWrite();
 
   protected:
+    /// \param device Device holding the memory pools.
+    /// \param requirements Memory requirements of the allocation.
+    /// \return Allocation info pointing to the resource class pool, if the
+    ///         device holds one that can serve the allocation.
+    VmaAllocationCreateInfo
+    allocationCreateInfo(const core::Device &device,
+                         const VkMemoryRequirements &requirements) const;
+    /// \return Category under which the memory is accounted.
+    core::MemoryCategory memoryCategory() const;
+
     VkMemoryRequirements requirements_{};
     VmaAllocationCreateInfo vma_allocation_create_info_{};
+    std::optional<core::MemoryClass> memory_class_;
+    std::optional<core::MemoryCategory> memory_category_;
+    bool relocatable_{false};
   };
 
   struct Config : public Setup<Config> {
@@ -83,16 +143,36 @@ public:
 #endif
   };
 
+  /// Mapped view of the memory, released on destruction.
+  /// \note Views are reference counted, so multiple (nested) views of the same
+  ///       memory can coexist.
   class ScopedMap {
   public:
+    ScopedMap(ScopedMap &&rhs) noexcept;
+    ScopedMap(const ScopedMap &) = delete;
     ~ScopedMap() noexcept;
+    ScopedMap &operator=(ScopedMap &&rhs) noexcept;
+    ScopedMap &operator=(const ScopedMap &) = delete;
 
     template <typename T> T *get() { return reinterpret_cast<T *>(mapped_); }
+    /// Flushes a range written through this view (non-coherent memory).
+    /// \param size_in_bytes [def=VK_WHOLE_SIZE]
+    /// \param offset        [def=0]
+    /// \return error status.
+    VeResult flush(VkDeviceSize size_in_bytes = VK_WHOLE_SIZE,
+                   VkDeviceSize offset = 0);
+    /// Invalidates a range before reading through this view (non-coherent
+    /// memory).
+    /// \param size_in_bytes [def=VK_WHOLE_SIZE]
+    /// \param offset        [def=0]
+    /// \return error status.
+    VeResult invalidate(VkDeviceSize size_in_bytes = VK_WHOLE_SIZE,
+                        VkDeviceSize offset = 0);
 
   private:
     ScopedMap(DeviceMemory &memory, void *mapped) noexcept;
 
-    DeviceMemory &memory_;
+    DeviceMemory *memory_{nullptr};
     void *mapped_{nullptr};
 
     friend class DeviceMemory;
@@ -115,8 +195,9 @@ public:
   ///           from the mapped memory.
   /// \note Mapping different regions may affect performance. Mapping the whole
   ///       memory once might be a better choice.
-  /// \note There can exist only one mapped instance at a time. Calling this
-  ///       method with a current map will generate an error.
+  /// \note Maps are reference counted: nested calls return the same pointer
+  ///       and the memory is unmapped when the last map is released.
+  /// \note Persistently mapped memory is never unmapped.
   /// \return pointer to mapped memory.
   HERMES_NODISCARD Result<void *> map() const;
   /// \note Sometimes the driver may not immediately copy the data into the
@@ -130,8 +211,6 @@ public:
   ///           from the mapped memory.
   /// \note Mapping different regions may affect performance. Mapping the whole
   ///       memory once might be a better choice.
-  /// \note There can exist only one mapped instance at a time. Calling this
-  ///       method with a current map will generate an error.
   /// \param size_in_bytes [def=0]   Region size in bytes to be mapped. If 0
   ///                                than the full available range is mapped.
   /// \param offset        [def=0]   Mapped memory offset in bytes.
@@ -153,11 +232,16 @@ public:
   ///\return error status.
   VeResult invalidate(VkDeviceSize size_in_bytes = VK_WHOLE_SIZE,
                       VkDeviceSize offset = 0);
-  /// Unmap mapped memory.
-  /// \note This invalidates the memory pointed by mapped().
+  /// Releases a map acquired with map().
+  /// \note This invalidates the memory pointed by mapped() once the last map
+  ///       is released (unless the memory is persistently mapped).
   void unmap() const;
+  /// \return Host pointer to the mapped memory, or nullptr if not mapped.
+  void *mapped() const;
 
   /// \brief Copies data into this memory.
+  /// \note Persistently mapped memory is written with a plain memcpy (plus a
+  ///       flush for non-coherent memory).
   /// \param data pointer
   /// \param size_in_bytes
   /// \param offset [def=0] Offset (in bytes) of the destination copy location.
@@ -171,11 +255,57 @@ public:
   void swap(DeviceMemory &rhs) noexcept;
   /// \return This memory capacity in bytes.
   VkDeviceSize size() const;
+  /// \return True if the defragmenter is allowed to move this memory.
+  bool isRelocatable() const;
+  /// \return True if the host can access this memory directly.
+  bool isHostVisible() const;
+  /// \return True if host writes don't require explicit flushes.
+  bool isHostCoherent() const;
+  /// \return True if this memory stays mapped for its whole lifetime.
+  bool isPersistentlyMapped() const;
 
 protected:
+  friend class Defragmenter;
+  friend class Image;
+
+  /// Creates a resource object bound to the destination allocation of a
+  /// defragmentation move and records the copy of the current contents.
+  /// \note Plain device memory holds no resource object and can't be moved.
+  /// \param dst_allocation Temporary allocation provided by the defragmenter.
+  /// \param vk_command_buffer Command buffer recording the copy.
+  /// \return error status.
+  virtual VeResult recordRelocation(VmaAllocation dst_allocation,
+                                    VkCommandBuffer vk_command_buffer);
+  /// Replaces the resource object by the one created in recordRelocation.
+  /// \note The copy recorded in recordRelocation must be completed.
+  /// \return Replaced handles.
+  virtual Relocation commitRelocation();
+  /// Destroys the resource object created in recordRelocation.
+  virtual void cancelRelocation() noexcept;
+  /// Registers this object as the owner of its allocation, so it can be
+  /// reached from allocation handles.
+  void bindOwner() noexcept;
+  /// Reads memory properties and the persistent map pointer (if any) of the
+  /// allocation.
+  void initMapping() noexcept;
+  /// Unmaps the memory regardless of the current map count.
+  void releaseMapping() noexcept;
+  /// Accounts this memory in the device memory budget.
+  /// \param device Device holding the memory budget.
+  /// \param category Memory category.
+  void track(const core::Device &device, core::MemoryCategory category);
+  /// Removes this memory from the device memory budget accounts.
+  void untrack() noexcept;
+
   VmaAllocator vma_allocator_{VK_NULL_HANDLE};
   VmaAllocation vma_allocation_{VK_NULL_HANDLE};
   mutable void *mapped_{nullptr};
+  mutable u32 map_count_{0};
+  bool persistently_mapped_{false};
+  VkMemoryPropertyFlags vk_memory_properties_{};
+  core::MemoryBudget *memory_budget_{nullptr};
+  core::MemoryCategory memory_category_{core::MemoryCategory::Other};
+  bool relocatable_{false};
 
 private:
 #ifdef VENUS_DEBUG
@@ -188,8 +318,31 @@ private:
 };
 
 template <typename Derived> Derived DeviceMemory::Setup<Derived>::forTexture() {
-  return DeviceMemory::Setup<Derived>().setDeviceLocal().setMemoryUsage(
-      VMA_MEMORY_USAGE_GPU_ONLY);
+  return DeviceMemory::Setup<Derived>()
+      .setDeviceLocal()
+      .setMemoryUsage(VMA_MEMORY_USAGE_GPU_ONLY)
+      .setMemoryClass(core::MemoryClass::Texture);
+}
+
+template <typename Derived>
+core::MemoryCategory DeviceMemory::Setup<Derived>::memoryCategory() const {
+  if (memory_category_.has_value())
+    return memory_category_.value();
+  if (memory_class_.has_value())
+    return core::defaultMemoryCategory(memory_class_.value());
+  return core::MemoryCategory::Other;
+}
+
+template <typename Derived>
+VmaAllocationCreateInfo DeviceMemory::Setup<Derived>::allocationCreateInfo(
+    const core::Device &device,
+    const VkMemoryRequirements &requirements) const {
+  auto info = vma_allocation_create_info_;
+  bool direct_write =
+      info.flags & VMA_ALLOCATION_CREATE_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT;
+  if (!info.pool && memory_class_.has_value() && !direct_write)
+    info.pool = device.memoryPool(memory_class_.value(), requirements);
+  return info;
 }
 
 template <typename Derived>
@@ -200,6 +353,42 @@ Derived &DeviceMemory::Setup<Derived>::setHostVisible() {
   return static_cast<Derived &>(*this);
 }
 
+template <typename Derived>
+Derived &DeviceMemory::Setup<Derived>::enableDirectWrite() {
+  vma_allocation_create_info_.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+  vma_allocation_create_info_.flags |=
+      VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+      VMA_ALLOCATION_CREATE_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT |
+      VMA_ALLOCATION_CREATE_MAPPED_BIT;
+  return static_cast<Derived &>(*this);
+}
+
+template <typename Derived>
+Derived &DeviceMemory::Setup<Derived>::enablePersistentMapping() {
+  vma_allocation_create_info_.flags |= VMA_ALLOCATION_CREATE_MAPPED_BIT;
+  return static_cast<Derived &>(*this);
+}
+
+template <typename Derived>
+Derived &DeviceMemory::Setup<Derived>::enableRelocation() {
+  relocatable_ = true;
+  return static_cast<Derived &>(*this);
+}
+
+template <typename Derived>
+Derived &DeviceMemory::Setup<Derived>::addAliasedRequirements(
+    const VkMemoryRequirements &requirements) {
+  if (!requirements_.size) {
+    requirements_ = requirements;
+  } else {
+    requirements_.size = std::max(requirements_.size, requirements.size);
+    requirements_.alignment =
+        std::max(requirements_.alignment, requirements.alignment);
+    requirements_.memoryTypeBits &= requirements.memoryTypeBits;
+  }
+  return static_cast<Derived &>(*this);
+}
+
 template <typename Derived>
 Derived &DeviceMemory::Setup<Derived>::setDeviceLocal() {
   vma_allocation_create_info_.requiredFlags |=
@@ -223,6 +412,10 @@ VENUS_DEFINE_SETUP_ADD_FLAGS_METHOD(DeviceMemory, addMemoryType, u32,
                                     vma_allocation_create_info_.memoryTypeBits);
 VENUS_DEFINE_SETUP_SET_FIELD_METHOD(DeviceMemory, setPool, VmaPool,
                                     vma_allocation_create_info_.pool);
+VENUS_DEFINE_SETUP_SET_FIELD_METHOD(DeviceMemory, setMemoryClass,
+                                    core::MemoryClass, memory_class_);
+VENUS_DEFINE_SETUP_SET_FIELD_METHOD(DeviceMemory, setMemoryCategory,
+                                    core::MemoryCategory, memory_category_);
 VENUS_DEFINE_SETUP_SET_FIELD_METHOD(DeviceMemory, setPriority, f32,
                                     vma_allocation_create_info_.priority);
 VENUS_DEFINE_SETUP_SET_FIELD_METHOD(DeviceMemory, setMemoryRequirements,
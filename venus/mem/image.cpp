@@ -55,6 +55,29 @@ Result<Image> Image::Config::build(const core::Device &device) const {
   return Result<Image>(std::move(image));
 }
 
+Result<Image> Image::Config::build(const core::Device &device,
+                                   const DeviceMemory &memory,
+                                   VkDeviceSize offset) const {
+  if (!memory.vma_allocation_)
+    return VeResult::badAllocation();
+
+  Image image;
+  auto info = createInfo();
+
+  VENUS_VK_RETURN_BAD_RESULT(
+      vmaCreateAliasingImage2(device.allocator(), memory.vma_allocation_,
+                              offset, &info, &image.vk_image_));
+
+  image.vk_extents_ = info.extent;
+  image.vk_device_ = *device;
+  image.vk_format_ = info.format;
+#ifdef VENUS_DEBUG
+  image.config_ = static_cast<const Image::Config &>(*this);
+#endif
+
+  return Result<Image>(std::move(image));
+}
+
 VENUS_DEFINE_SET_CONFIG_INFO_FIELD_METHOD(Image::View, setFlags,
                                           VkImageViewCreateFlags, flags)
 VENUS_DEFINE_SET_CONFIG_INFO_FIELD_METHOD(Image::View, setImage, VkImage, image)
@@ -172,7 +195,8 @@ AllocatedImage::Config::forColorAttachment(VkExtent2D extent) {
       .addAspectMask(VK_IMAGE_ASPECT_COLOR_BIT)
       // memory
       .setDeviceLocal()
-      .setMemoryUsage(VMA_MEMORY_USAGE_GPU_ONLY);
+      .setMemoryUsage(VMA_MEMORY_USAGE_GPU_ONLY)
+      .setMemoryClass(core::MemoryClass::Attachment);
 }
 
 AllocatedImage::Config
@@ -193,7 +217,8 @@ AllocatedImage::Config::forDepthBuffer(VkExtent2D extent) {
       .addAspectMask(VK_IMAGE_ASPECT_DEPTH_BIT)
       // memory
       .setDeviceLocal()
-      .setMemoryUsage(VMA_MEMORY_USAGE_GPU_ONLY);
+      .setMemoryUsage(VMA_MEMORY_USAGE_GPU_ONLY)
+      .setMemoryClass(core::MemoryClass::DepthAttachment);
 }
 
 AllocatedImage::Config AllocatedImage::Config::forTexture(VkExtent2D extent) {
@@ -218,7 +243,8 @@ AllocatedImage::Config AllocatedImage::Config::forTexture(VkExtent3D extent) {
       .addAspectMask(VK_IMAGE_ASPECT_COLOR_BIT)
       // memory
       .setDeviceLocal()
-      .setMemoryUsage(VMA_MEMORY_USAGE_GPU_ONLY);
+      .setMemoryUsage(VMA_MEMORY_USAGE_GPU_ONLY)
+      .setMemoryClass(core::MemoryClass::Texture);
 }
 
 AllocatedImage::Config AllocatedImage::Config::forStorage(VkExtent2D extent) {
@@ -238,26 +264,65 @@ AllocatedImage::Config AllocatedImage::Config::forStorage(VkExtent2D extent) {
       .addAspectMask(VK_IMAGE_ASPECT_COLOR_BIT)
       // memory
       .setDeviceLocal()
-      .setMemoryUsage(VMA_MEMORY_USAGE_GPU_ONLY);
+      .setMemoryUsage(VMA_MEMORY_USAGE_GPU_ONLY)
+      .setMemoryClass(core::MemoryClass::Attachment);
+}
+
+AllocatedImage::Config &AllocatedImage::Config::enableTransient() {
+  transient_ = true;
+  return *this;
 }
 
 Result<AllocatedImage>
 AllocatedImage::Config::build(const core::Device &device) const {
   auto info = createInfo();
+  if (transient_) {
+    // transient attachments only accept attachment usages
+    info.usage &= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                  VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+                  VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+    info.usage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+  }
+
+  // class pools only serve requirements matching their memory type and blocks
+  VkDeviceImageMemoryRequirements device_info{};
+  device_info.sType = VK_STRUCTURE_TYPE_DEVICE_IMAGE_MEMORY_REQUIREMENTS;
+  device_info.pCreateInfo = &info;
+  VkMemoryRequirements2 requirements{};
+  requirements.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+  vkGetDeviceImageMemoryRequirements(*device, &device_info, &requirements);
+
+  auto alloc_info =
+      allocationCreateInfo(device, requirements.memoryRequirements);
+  if (transient_) {
+    // lazily allocated memory types are not served by class pools
+    alloc_info.usage = VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED;
+    alloc_info.pool = VK_NULL_HANDLE;
+  }
 
-  auto alloc_info = vma_allocation_create_info_;
   VkImage vk_image{VK_NULL_HANDLE};
   VmaAllocation vma_allocation{VK_NULL_HANDLE};
-  VENUS_VK_RETURN_BAD_RESULT(vmaCreateImage(device.allocator(), &info,
-                                            &alloc_info, &vk_image,
-                                            &vma_allocation, nullptr));
+  VkResult result = vmaCreateImage(device.allocator(), &info, &alloc_info,
+                                   &vk_image, &vma_allocation, nullptr);
+  // lazily allocated memory may not exist, fallback to default pools
+  if (result != VK_SUCCESS && transient_)
+    result =
+        vmaCreateImage(device.allocator(), &info, &vma_allocation_create_info_,
+                       &vk_image, &vma_allocation, nullptr);
+  VENUS_VK_RETURN_BAD_RESULT(result);
   AllocatedImage image;
   image.vk_extents_ = info.extent;
   image.vma_allocator_ = device.allocator();
   image.vma_allocation_ = vma_allocation;
+  image.track(device, memoryCategory());
   image.vk_format_ = info.format;
   image.vk_image_ = vk_image;
   image.vk_device_ = *device;
+  // images are never moved, their views and the descriptor sets sampling
+  // them can't be patched
+  image.relocatable_ = false;
+  image.bindOwner();
+  image.initMapping();
 
   return Result<AllocatedImage>(std::move(image));
 }
@@ -282,6 +347,8 @@ void AllocatedImage::swap(AllocatedImage &rhs) noexcept {
 AllocatedImage::operator bool() const { return vk_image_ != VK_NULL_HANDLE; }
 
 void AllocatedImage::destroy() noexcept {
+  releaseMapping();
+  untrack();
   if (vk_image_ && vma_allocator_ && vma_allocation_) {
     vmaDestroyImage(vma_allocator_, vk_image_, vma_allocation_);
   }
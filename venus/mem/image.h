@@ -97,6 +97,12 @@ public:
     Derived &addFormatFeatures(VkFormatFeatureFlagBits features);
     //
     VkImageCreateInfo createInfo() const;
+    /// Queries the memory requirements of images created from this
+    /// configuration, without creating one.
+    /// \note Use it to size memory shared by aliased images.
+    /// \param device
+    /// \return Memory requirements.
+    VkMemoryRequirements memoryRequirements(const core::Device &device) const;
     /// Create an initialized image from this configuration.
     /// \note This copies data into image's buffer memory.
     /// \param gd Graphics device with access to a command buffer.
@@ -123,6 +129,19 @@ public:
     ///       and will destroy it with destroy() is called.
     HERMES_NODISCARD Result<Image> build(VkDevice vk_device,
                                          VkImage vk_image) const;
+    /// \brief Creates an image bound to a region of existing memory.
+    /// Images whose lifetimes within a frame don't overlap can alias the same
+    /// memory (see DeviceMemory::Setup::addAliasedRequirements).
+    /// \note The memory is not owned by the image and must outlive it.
+    /// \note Aliased contents are undefined once another alias is written, so
+    ///       transition from VK_IMAGE_LAYOUT_UNDEFINED at every first use.
+    /// \param device
+    /// \param memory Memory backing the image.
+    /// \param offset [def=0] Offset (in bytes) of the image within memory.
+    /// \return image or error.
+    HERMES_NODISCARD Result<Image> build(const core::Device &device,
+                                         const DeviceMemory &memory,
+                                         VkDeviceSize offset = 0) const;
 
 #ifdef VENUS_INCLUDE_DEBUG_TRAITS
     friend struct hermes::DebugTraits<Image::Config>;
@@ -266,6 +285,19 @@ VkImageCreateInfo Image::Setup<Derived>::createInfo() const {
   return info;
 }
 
+template <typename Derived>
+VkMemoryRequirements
+Image::Setup<Derived>::memoryRequirements(const core::Device &device) const {
+  auto info = createInfo();
+  VkDeviceImageMemoryRequirements device_info{};
+  device_info.sType = VK_STRUCTURE_TYPE_DEVICE_IMAGE_MEMORY_REQUIREMENTS;
+  device_info.pCreateInfo = &info;
+  VkMemoryRequirements2 requirements{};
+  requirements.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+  vkGetDeviceImageMemoryRequirements(*device, &device_info, &requirements);
+  return requirements.memoryRequirements;
+}
+
 VENUS_DEFINE_SETUP_SET_FIELD_METHOD(Image, setInfo, VkImageCreateInfo, info_)
 VENUS_DEFINE_SETUP_SET_FIELD_METHOD(Image, addCreateFlags, VkImageCreateFlags,
                                     info_.flags)
@@ -305,7 +337,19 @@ public:
     static Config forTexture(VkExtent3D extent);
     static Config forStorage(VkExtent2D extent);
 
+    /// Makes the image a transient attachment, whose contents only live
+    /// within a render pass. Transient attachments are backed by lazily
+    /// allocated memory where available (tile memory of tiled GPUs), falling
+    /// back to regular device local memory.
+    /// \note This restricts usage to attachment usages, the image can't be
+    ///       sampled or copied.
+    /// \note Render with VK_ATTACHMENT_STORE_OP_DONT_CARE.
+    Config &enableTransient();
+
     Result<AllocatedImage> build(const core::Device &device) const;
+
+  private:
+    bool transient_{false};
   };
 
   VENUS_DECLARE_RAII_FUNCTIONS(AllocatedImage)
@@ -26,13 +26,81 @@
 
 #include <venus/mem/layout.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
 namespace venus::mem {
 
+static u16 floatToHalf(f32 value) {
+  u32 bits;
+  std::memcpy(&bits, &value, sizeof(f32));
+  u32 sign = (bits >> 16) & 0x8000;
+  u32 mantissa = bits & 0x7fffff;
+  i32 exponent = static_cast<i32>((bits >> 23) & 0xff) - 127 + 15;
+  // inf/nan and values too large for half
+  if (exponent >= 31) {
+    bool is_nan = ((bits >> 23) & 0xff) == 0xff && mantissa;
+    return static_cast<u16>(sign | 0x7c00 | (is_nan ? 0x200 : 0));
+  }
+  // subnormals and values too small for half
+  if (exponent <= 0) {
+    if (exponent < -10)
+      return static_cast<u16>(sign);
+    mantissa |= 0x800000;
+    u32 shift = static_cast<u32>(14 - exponent);
+    u32 half = mantissa >> shift;
+    if ((mantissa >> (shift - 1)) & 1)
+      half++;
+    return static_cast<u16>(sign | half);
+  }
+  u32 half = sign | (static_cast<u32>(exponent) << 10) | (mantissa >> 13);
+  // round to nearest (a carry correctly bumps the exponent)
+  if (mantissa & 0x1000)
+    half++;
+  return static_cast<u16>(half);
+}
+
+static i16 floatToSnorm16(f32 value) {
+  return static_cast<i16>(std::round(std::clamp(value, -1.f, 1.f) * 32767.f));
+}
+
+static u8 floatToUnorm8(f32 value) {
+  return static_cast<u8>(std::round(std::clamp(value, 0.f, 1.f) * 255.f));
+}
+
+static f32 signNotZero(f32 value) { return value >= 0.f ? 1.f : -1.f; }
+
+// projects the unit vector onto the octahedron and unfolds the lower half
+static void octahedralEncode(const f32 *v, f32 *e) {
+  f32 l1 = std::abs(v[0]) + std::abs(v[1]) + std::abs(v[2]);
+  if (l1 == 0.f) {
+    e[0] = e[1] = 0.f;
+    return;
+  }
+  f32 x = v[0] / l1;
+  f32 y = v[1] / l1;
+  if (v[2] < 0.f) {
+    f32 folded_x = (1.f - std::abs(y)) * signNotZero(x);
+    y = (1.f - std::abs(x)) * signNotZero(y);
+    x = folded_x;
+  }
+  e[0] = x;
+  e[1] = y;
+}
+
 VertexLayout &VertexLayout::pushComponent(VertexLayout::ComponentType component,
-                                          VkFormat format) {
-  components_.push_back(
-      {.format = format, .type = component, .offset = stride_});
-  stride_ += core::vk::formatSize(format);
+                                          VkFormat format,
+                                          VertexLayout::Encoding encoding,
+                                          u32 stream) {
+  if (strides_.size() <= stream)
+    strides_.resize(stream + 1, 0);
+  components_.push_back({.format = format,
+                         .type = component,
+                         .offset = strides_[stream],
+                         .encoding = encoding,
+                         .stream = stream});
+  strides_[stream] += core::vk::formatSize(format);
   return *this;
 }
 
@@ -54,7 +122,7 @@ VertexLayout::componentFormat(VertexLayout::ComponentType component) const {
 
 void VertexLayout::clear() {
   components_.clear();
-  stride_ = 0;
+  strides_.clear();
 }
 
 Result<VkDeviceSize>
@@ -66,7 +134,48 @@ VertexLayout::componentOffset(VertexLayout::ComponentType component) const {
   return VeResult::notFound();
 }
 
-VkDeviceSize VertexLayout::stride() const { return stride_; }
+Result<VertexLayout::Encoding>
+VertexLayout::componentEncoding(VertexLayout::ComponentType component) const {
+  for (const auto &c : components_) {
+    if (c.type == component)
+      return Result<Encoding>(c.encoding);
+  }
+  return VeResult::notFound();
+}
+
+bool VertexLayout::isQuantized() const {
+  for (const auto &c : components_)
+    if (c.encoding != Encoding::None)
+      return true;
+  return false;
+}
+
+Result<u32>
+VertexLayout::componentStream(VertexLayout::ComponentType component) const {
+  for (const auto &c : components_) {
+    if (c.type == component)
+      return Result<u32>(c.stream);
+  }
+  return VeResult::notFound();
+}
+
+VkDeviceSize VertexLayout::stride(u32 stream) const {
+  if (stream < strides_.size())
+    return strides_[stream];
+  return 0;
+}
+
+u32 VertexLayout::streamCount() const {
+  return static_cast<u32>(strides_.size());
+}
+
+VertexLayout VertexLayout::streamLayout(u32 stream) const {
+  VertexLayout layout;
+  for (const auto &c : components_)
+    if (c.stream == stream)
+      layout.pushComponent(c.type, c.format, c.encoding);
+  return layout;
+}
 
 const std::vector<VertexLayout::Component> &VertexLayout::components() const {
   return components_;
@@ -75,7 +184,8 @@ const std::vector<VertexLayout::Component> &VertexLayout::components() const {
 bool operator==(const VertexLayout::Component &lhs,
                 const VertexLayout::Component &rhs) {
   return lhs.format == rhs.format && lhs.type == rhs.type &&
-         lhs.offset == rhs.offset;
+         lhs.offset == rhs.offset && lhs.encoding == rhs.encoding &&
+         lhs.stream == rhs.stream;
 }
 
 bool operator!=(const VertexLayout::Component &lhs,
@@ -84,7 +194,7 @@ bool operator!=(const VertexLayout::Component &lhs,
 }
 
 bool operator==(const VertexLayout &lhs, const VertexLayout &rhs) {
-  if (lhs.stride_ != rhs.stride_)
+  if (lhs.strides_ != rhs.strides_)
     return false;
   if (lhs.components_.size() != rhs.components_.size())
     return false;
@@ -98,4 +208,192 @@ bool operator!=(const VertexLayout &lhs, const VertexLayout &rhs) {
   return !(lhs == rhs);
 }
 
+Result<QuantizedVertices> quantizeVertices(const VertexLayout &layout,
+                                           const void *data,
+                                           u32 vertex_count) {
+  using ComponentType = VertexLayout::ComponentType;
+  using Encoding = VertexLayout::Encoding;
+
+  if (!data || !vertex_count || !layout.stride())
+    return VeResult::inputError();
+  if (layout.isQuantized() || layout.streamCount() > 1)
+    return VeResult::incompatible();
+
+  const u8 *src = reinterpret_cast<const u8 *>(data);
+  const VkDeviceSize src_stride = layout.stride();
+  auto readFloats = [&](u32 vertex, const VertexLayout::Component &c, f32 *v,
+                        u32 n) {
+    std::memcpy(v, src + vertex * src_stride + c.offset, n * sizeof(f32));
+  };
+
+  QuantizedVertices quantized;
+
+  // output layout
+
+  for (const auto &c : layout.components()) {
+    bool is_vec3 = c.format == VK_FORMAT_R32G32B32_SFLOAT;
+    switch (c.type) {
+    case ComponentType::Position:
+      if (is_vec3) {
+        quantized.layout.pushComponent(c.type, VK_FORMAT_R16G16B16A16_SFLOAT,
+                                       Encoding::Quantized);
+        continue;
+      }
+      break;
+    case ComponentType::Normal:
+    case ComponentType::Tangent:
+    case ComponentType::Bitangent:
+      if (is_vec3) {
+        quantized.layout.pushComponent(c.type, VK_FORMAT_R16G16_SNORM,
+                                       Encoding::Octahedral);
+        continue;
+      }
+      break;
+    case ComponentType::UV:
+      if (c.format == VK_FORMAT_R32G32_SFLOAT) {
+        quantized.layout.pushComponent(c.type, VK_FORMAT_R16G16_SFLOAT);
+        continue;
+      }
+      break;
+    case ComponentType::Color:
+      if (is_vec3 || c.format == VK_FORMAT_R32G32B32A32_SFLOAT) {
+        quantized.layout.pushComponent(c.type, VK_FORMAT_R8G8B8A8_UNORM);
+        continue;
+      }
+      break;
+    default:
+      break;
+    }
+    quantized.layout.pushComponent(c.type, c.format);
+  }
+
+  // position dequantization maps [-1,1] to the position bounds
+
+  const auto &src_components = layout.components();
+  const auto &dst_components = quantized.layout.components();
+  for (h_index k = 0; k < src_components.size(); ++k) {
+    if (dst_components[k].encoding != Encoding::Quantized)
+      continue;
+    f32 lower[3], upper[3], p[3];
+    readFloats(0, src_components[k], lower, 3);
+    std::memcpy(upper, lower, sizeof(upper));
+    for (u32 i = 1; i < vertex_count; ++i) {
+      readFloats(i, src_components[k], p, 3);
+      for (u32 d = 0; d < 3; ++d) {
+        lower[d] = std::min(lower[d], p[d]);
+        upper[d] = std::max(upper[d], p[d]);
+      }
+    }
+    for (u32 d = 0; d < 3; ++d) {
+      quantized.dequantization.offset[d] = 0.5f * (lower[d] + upper[d]);
+      quantized.dequantization.scale[d] =
+          std::max(0.5f * (upper[d] - lower[d]), 1e-8f);
+    }
+    break;
+  }
+
+  // convert
+
+  const VkDeviceSize dst_stride = quantized.layout.stride();
+  quantized.data.resize(dst_stride * vertex_count, 0);
+  for (u32 i = 0; i < vertex_count; ++i) {
+    for (h_index k = 0; k < src_components.size(); ++k) {
+      const auto &sc = src_components[k];
+      const auto &dc = dst_components[k];
+      u8 *dst = quantized.data.data() + i * dst_stride + dc.offset;
+      if (sc.format == dc.format) {
+        std::memcpy(dst, src + i * src_stride + sc.offset,
+                    core::vk::formatSize(sc.format));
+        continue;
+      }
+      f32 v[4] = {0.f, 0.f, 0.f, 1.f};
+      readFloats(i, sc, v, core::vk::formatSize(sc.format) / sizeof(f32));
+      if (dc.encoding == Encoding::Quantized) {
+        u16 h[4] = {0, 0, 0, 0};
+        for (u32 d = 0; d < 3; ++d)
+          h[d] = floatToHalf((v[d] - quantized.dequantization.offset[d]) /
+                             quantized.dequantization.scale[d]);
+        std::memcpy(dst, h, sizeof(h));
+      } else if (dc.encoding == Encoding::Octahedral) {
+        f32 e[2];
+        octahedralEncode(v, e);
+        i16 q[2] = {floatToSnorm16(e[0]), floatToSnorm16(e[1])};
+        std::memcpy(dst, q, sizeof(q));
+      } else if (dc.format == VK_FORMAT_R16G16_SFLOAT) {
+        u16 h[2] = {floatToHalf(v[0]), floatToHalf(v[1])};
+        std::memcpy(dst, h, sizeof(h));
+      } else if (dc.format == VK_FORMAT_R8G8B8A8_UNORM) {
+        for (u32 d = 0; d < 4; ++d)
+          dst[d] = floatToUnorm8(v[d]);
+      }
+    }
+  }
+
+  return Result<QuantizedVertices>(std::move(quantized));
+}
+
+Result<VertexStreams> separateStream(const VertexLayout &layout,
+                                     const void *data, u32 vertex_count,
+                                     VertexLayout::ComponentType component) {
+  if (!data || !vertex_count || !layout.stride())
+    return VeResult::inputError();
+  if (layout.streamCount() > 1)
+    return VeResult::incompatible();
+  if (!layout.componentFormat(component))
+    return VeResult::notFound();
+
+  VertexStreams streams;
+  for (const auto &c : layout.components())
+    streams.layout.pushComponent(c.type, c.format, c.encoding,
+                                 c.type == component ? 1 : 0);
+
+  const u8 *src = reinterpret_cast<const u8 *>(data);
+  const VkDeviceSize src_stride = layout.stride();
+  const auto &src_components = layout.components();
+  const auto &dst_components = streams.layout.components();
+  streams.data.resize(2);
+  for (u32 stream = 0; stream < 2; ++stream)
+    streams.data[stream].resize(streams.layout.stride(stream) * vertex_count);
+  for (u32 i = 0; i < vertex_count; ++i)
+    for (h_index k = 0; k < src_components.size(); ++k) {
+      const auto &dc = dst_components[k];
+      std::memcpy(streams.data[dc.stream].data() +
+                      i * streams.layout.stride(dc.stream) + dc.offset,
+                  src + i * src_stride + src_components[k].offset,
+                  core::vk::formatSize(dc.format));
+    }
+
+  return Result<VertexStreams>(std::move(streams));
+}
+
+VkIndexType indexTypeFor(u32 vertex_count) {
+  return vertex_count <= 0xffff ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+}
+
+Result<std::vector<u8>> packIndices(const std::vector<u32> &indices,
+                                    VkIndexType index_type) {
+  std::vector<u8> data;
+  switch (index_type) {
+  case VK_INDEX_TYPE_UINT32:
+    data.resize(sizeof(u32) * indices.size());
+    std::memcpy(data.data(), indices.data(), data.size());
+    break;
+  case VK_INDEX_TYPE_UINT16: {
+    // padded to whole 32-bit words, shaders read index pairs as uints (see
+    // shaders/meshlet_cull.comp)
+    data.resize(sizeof(u32) * ((indices.size() + 1) / 2), 0);
+    auto *dst = reinterpret_cast<u16 *>(data.data());
+    for (h_index i = 0; i < indices.size(); ++i) {
+      if (indices[i] > 0xffff)
+        return VeResult::outOfBounds();
+      dst[i] = static_cast<u16>(indices[i]);
+    }
+    break;
+  }
+  default:
+    return VeResult::incompatible();
+  }
+  return Result<std::vector<u8>>(std::move(data));
+}
+
 } // namespace venus::mem
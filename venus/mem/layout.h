@@ -42,6 +42,8 @@ namespace venus::mem {
 /// be identical, but compatible, in the sense that the shader input vertex
 /// components are present in the buffer and their corresponding formats
 /// match.
+/// \note Components may be split into multiple streams (separate buffers),
+///       each stream is interleaved with its own stride.
 class VertexLayout {
 public:
   /// Types of vertex layout components.
@@ -61,18 +63,31 @@ public:
     Array
   };
 
+  /// How component values are encoded in the vertex data.
+  enum class Encoding {
+    None,       //< values are read as given by the format.
+    Quantized,  //< normalized values, remapped by the mesh dequantization.
+    Octahedral, //< unit vectors folded into 2 components (octahedral map).
+  };
+
   /// Vertex layout component.
   struct Component {
     VkFormat format;
     ComponentType type;
-    VkDeviceSize offset;
+    VkDeviceSize offset; //< offset within the component stream.
+    Encoding encoding{Encoding::None};
+    u32 stream{0};
   };
 
   /// \brief Define a new component in the layout.
   /// \note Vertex components follow the same order they are pushed.
   /// \param component The component type.
   /// \param format The component data format.
-  VertexLayout &pushComponent(ComponentType component, VkFormat format);
+  /// \param encoding [def=Encoding::None] The component value encoding.
+  /// \param stream [def=0] The stream (buffer) holding the component.
+  VertexLayout &pushComponent(ComponentType component, VkFormat format,
+                              Encoding encoding = Encoding::None,
+                              u32 stream = 0);
   /// \param other
   /// \return true if this layout contains other's components.
   bool contains(const VertexLayout &other);
@@ -89,8 +104,23 @@ public:
   /// \return the offset if found, VeResult::NotFound otherwise.
   HERMES_NODISCARD Result<VkDeviceSize>
   componentOffset(ComponentType component) const;
-  /// \return The stride (in bytes) of this vertex layout.
-  VkDeviceSize stride() const;
+  /// \param component
+  /// \return the corresponding encoding, if the component is found.
+  HERMES_NODISCARD Result<Encoding>
+  componentEncoding(ComponentType component) const;
+  /// \param component
+  /// \return the stream holding the component, if the component is found.
+  HERMES_NODISCARD Result<u32> componentStream(ComponentType component) const;
+  /// \return True if any component is quantized or octahedral encoded.
+  bool isQuantized() const;
+  /// \param stream [def=0]
+  /// \return The stride (in bytes) of the given stream.
+  VkDeviceSize stride(u32 stream = 0) const;
+  /// \return Number of streams.
+  u32 streamCount() const;
+  /// \param stream
+  /// \return The layout of a single stream (as stream 0).
+  VertexLayout streamLayout(u32 stream) const;
   /// \return The list of vertex components.
   const std::vector<Component> &components() const;
 
@@ -99,7 +129,7 @@ public:
 
 private:
   std::vector<Component> components_;
-  VkDeviceSize stride_{0};
+  std::vector<VkDeviceSize> strides_;
 
 #ifdef VENUS_INCLUDE_DEBUG_TRAITS
   friend struct hermes::DebugTraits<VertexLayout>;
@@ -111,6 +141,70 @@ bool operator==(const VertexLayout::Component &lhs,
 bool operator!=(const VertexLayout::Component &lhs,
                 const VertexLayout::Component &rhs);
 
+/// Maps quantized vertex positions back to object space:
+///   position = offset + scale * quantized_position
+struct Dequantization {
+  f32 scale[3]{1.f, 1.f, 1.f};
+  f32 offset[3]{0.f, 0.f, 0.f};
+};
+
+/// Vertex data produced by quantizeVertices.
+struct QuantizedVertices {
+  VertexLayout layout;
+  std::vector<u8> data;
+  Dequantization dequantization;
+};
+
+/// Vertex data produced by separateStream.
+struct VertexStreams {
+  VertexLayout layout;
+  std::vector<std::vector<u8>> data; //< interleaved data of each stream.
+};
+
+/// \brief Converts 32-bit float vertex components into compact formats.
+/// Components are converted as follows:
+///   - Position (xyz) -> half float xyz (+ padding) in [-1,1] of the bounds
+///   - Normal/Tangent/Bitangent (xyz) -> octahedral snorm16
+///   - UV (xy) -> half float
+///   - Color (rgb/rgba) -> unorm8 rgba
+/// Other components are copied unchanged.
+/// \note Decoding helpers for shaders are in shaders/venus/quantization.glsl.
+/// \param layout Layout of the input vertex data.
+/// \param data Interleaved input vertex data.
+/// \param vertex_count Number of vertices in data.
+/// \return Quantized vertex data and its layout, or error.
+HERMES_NODISCARD Result<QuantizedVertices>
+quantizeVertices(const VertexLayout &layout, const void *data,
+                 u32 vertex_count);
+
+/// \brief Moves a component out of interleaved vertex data into its own
+///        stream (stream 1). Other components stay in stream 0.
+/// \note Passes reading only positions (depth, shadows, acceleration
+///       structure builds) fetch dense cache lines from a position stream.
+/// \param layout Layout of the input (single stream) vertex data.
+/// \param data Interleaved input vertex data.
+/// \param vertex_count Number of vertices in data.
+/// \param component [def=Position] Component moved into stream 1.
+/// \return Vertex data of each stream and the split layout, or error.
+HERMES_NODISCARD Result<VertexStreams>
+separateStream(const VertexLayout &layout, const void *data, u32 vertex_count,
+               VertexLayout::ComponentType component =
+                   VertexLayout::ComponentType::Position);
+
+/// \brief Smallest index type able to address all vertices of a mesh.
+/// \note 0xFFFF is left out of 16-bit indices (primitive restart value).
+/// \param vertex_count
+/// \return VK_INDEX_TYPE_UINT16 or VK_INDEX_TYPE_UINT32.
+HERMES_NODISCARD VkIndexType indexTypeFor(u32 vertex_count);
+
+/// \brief Converts 32-bit indices into index buffer data of the given type.
+/// \param indices
+/// \note 16-bit data is padded with a zero index to a 4-byte multiple.
+/// \param index_type VK_INDEX_TYPE_UINT16 or VK_INDEX_TYPE_UINT32.
+/// \return Index buffer data, or error if an index does not fit the type.
+HERMES_NODISCARD Result<std::vector<u8>>
+packIndices(const std::vector<u32> &indices, VkIndexType index_type);
+
 } // namespace venus::mem
 
 #ifdef VENUS_INCLUDE_DEBUG_TRAITS
@@ -142,19 +236,35 @@ template <> struct DebugTraits<venus::mem::VertexLayout::ComponentType> {
   }
 };
 
+template <> struct DebugTraits<venus::mem::VertexLayout::Encoding> {
+  static HERMES_CONST_OR_CONSTEXPR bool is_string_serializable = true;
+  static DebugMessage message(const venus::mem::VertexLayout::Encoding &data) {
+#define TO_STR(C)                                                              \
+  if (data == venus::mem::VertexLayout::Encoding::C)                           \
+  return DebugMessage(#C)
+    TO_STR(None);
+    TO_STR(Quantized);
+    TO_STR(Octahedral);
+#undef TO_STR
+    return DebugMessage("<invalid encoding>");
+  }
+};
+
 template <> struct DebugTraits<venus::mem::VertexLayout> {
   static HERMES_CONST_OR_CONSTEXPR bool is_string_serializable = true;
   static DebugMessage message(const venus::mem::VertexLayout &data) {
     return DebugMessage()
         .addTitle("Vertex Layout")
-        .add("stride", data.stride_)
+        .addArray("strides", data.strides_)
         .addArray<venus::mem::VertexLayout::Component>(
             "components", data.components_,
             [](h_index i, const venus::mem::VertexLayout::Component &component)
                 -> DebugMessage {
               return DebugMessage(
-                  "{} {} {}", VENUS_VK_STRING(VkFormat, component.format),
-                  component.offset, venus::to_string(component.type));
+                  "{} {} {} {} stream {}",
+                  VENUS_VK_STRING(VkFormat, component.format),
+                  component.offset, venus::to_string(component.type),
+                  venus::to_string(component.encoding), component.stream);
             });
   }
 };
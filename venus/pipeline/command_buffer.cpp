@@ -301,6 +301,18 @@ void CommandBuffer::bind(VkPipelineBindPoint pipeline_bind_point,
       (dynamic_offsets.size()) ? dynamic_offsets.data() : nullptr);
 }
 
+void CommandBuffer::bind(VkPipelineBindPoint pipeline_bind_point,
+                         VkPipelineLayout layout,
+                         const DescriptorSetBindings &bindings) const {
+  for (u32 r = 0; r < bindings.range_count; ++r) {
+    const auto &range = bindings.ranges[r];
+    vkCmdBindDescriptorSets(vk_command_buffer_, pipeline_bind_point, layout,
+                            range.first_set, range.count,
+                            bindings.descriptor_sets + range.offset, 0,
+                            nullptr);
+  }
+}
+
 void CommandBuffer::bind(VkPipelineBindPoint pipeline_bind_point,
                          VkPipelineLayout pipeline_layout,
                          const std::vector<VkDescriptorSet> &descriptor_sets,
@@ -371,6 +383,23 @@ void CommandBuffer::drawIndexed(u32 index_count, u32 instance_count,
                    vertex_offset, first_instance);
 }
 
+void CommandBuffer::drawIndexedIndirect(VkBuffer buffer, VkDeviceSize offset,
+                                        u32 draw_count, u32 stride) const {
+  vkCmdDrawIndexedIndirect(vk_command_buffer_, buffer, offset, draw_count,
+                           stride);
+}
+
+void CommandBuffer::drawIndexedIndirectCount(VkBuffer buffer,
+                                             VkDeviceSize offset,
+                                             VkBuffer count_buffer,
+                                             VkDeviceSize count_offset,
+                                             u32 max_draw_count,
+                                             u32 stride) const {
+  vkCmdDrawIndexedIndirectCount(vk_command_buffer_, buffer, offset,
+                                count_buffer, count_offset, max_draw_count,
+                                stride);
+}
+
 void CommandBuffer::traceRays(
     const VkStridedDeviceAddressRegionKHR *raygen_shader_binding_table,
     const VkStridedDeviceAddressRegionKHR *miss_shader_binding_table,
@@ -382,6 +411,25 @@ void CommandBuffer::traceRays(
                     callable_shader_binding_table, width, height, depth);
 }
 
+void CommandBuffer::memoryBarrier(VkPipelineStageFlags2 src_stage_mask,
+                                  VkAccessFlags2 src_access_mask,
+                                  VkPipelineStageFlags2 dst_stage_mask,
+                                  VkAccessFlags2 dst_access_mask) const {
+  VkMemoryBarrier2 memory_barrier{};
+  memory_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+  memory_barrier.srcStageMask = src_stage_mask;
+  memory_barrier.srcAccessMask = src_access_mask;
+  memory_barrier.dstStageMask = dst_stage_mask;
+  memory_barrier.dstAccessMask = dst_access_mask;
+
+  VkDependencyInfo dependency_info{};
+  dependency_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+  dependency_info.memoryBarrierCount = 1;
+  dependency_info.pMemoryBarriers = &memory_barrier;
+
+  vkCmdPipelineBarrier2(vk_command_buffer_, &dependency_info);
+}
+
 void CommandBuffer::transitionImageLayout(
     VkImageMemoryBarrier barrier, VkPipelineStageFlags src_stages,
     VkPipelineStageFlags dst_stages) const {
@@ -457,7 +505,8 @@ void CommandBuffer::transitionImage(VkImage vk_image,
   image_barrier.newLayout = new_layout;
 
   VkImageAspectFlags aspect_mask =
-      (new_layout == VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL)
+      (new_layout == VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL ||
+       current_layout == VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL)
           ? VK_IMAGE_ASPECT_DEPTH_BIT
           : VK_IMAGE_ASPECT_COLOR_BIT;
 
@@ -663,8 +712,29 @@ BufferWritter &BufferWritter::addBuffer(VkBuffer buffer, const void *data,
   return *this;
 }
 
+BufferWritter &BufferWritter::addBuffer(mem::AllocatedBuffer &buffer,
+                                        const void *data, u32 size_in_bytes) {
+  if (!buffer.isHostVisible())
+    return addBuffer(*buffer, data, size_in_bytes);
+  direct_data_.emplace_back(data);
+  direct_sizes_.emplace_back(size_in_bytes);
+  direct_buffers_.emplace_back(&buffer);
+  return *this;
+}
+
+VeResult BufferWritter::writeDirect() const {
+  for (u32 i = 0; i < direct_buffers_.size(); ++i)
+    VENUS_RETURN_BAD_RESULT(
+        direct_buffers_[i]->copy(direct_data_[i], direct_sizes_[i]));
+  return VeResult::noError();
+}
+
 VeResult BufferWritter::record(const core::Device &device,
                                VkCommandBuffer cb) const {
+  VENUS_RETURN_BAD_RESULT(writeDirect());
+  if (buffers_.empty())
+    return VeResult::noError();
+
   // compute total staging size
   std::vector<u32> offsets(1, 0);
   u32 staging_size = 0;
@@ -700,6 +770,10 @@ VeResult BufferWritter::record(const core::Device &device,
 
 VeResult
 BufferWritter::immediateSubmit(const engine::GraphicsDevice &gd) const {
+  VENUS_RETURN_BAD_RESULT(writeDirect());
+  if (buffers_.empty())
+    return VeResult::noError();
+
   // compute total staging size
   std::vector<u32> offsets(1, 0);
   u32 staging_size = 0;
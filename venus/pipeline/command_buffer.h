@@ -28,6 +28,7 @@
 #pragma once
 
 #include <venus/mem/buffer.h>
+#include <venus/pipeline/descriptors.h>
 #include <venus/pipeline/pipeline.h>
 
 namespace venus::engine {
@@ -231,6 +232,12 @@ public:
   void bind(VkPipelineBindPoint pipeline_bind_point, VkPipelineLayout layout,
             u32 first_set, const std::vector<VkDescriptorSet> &descriptor_sets,
             const std::vector<u32> &dynamic_offsets = {}) const;
+  /// Binds each range of descriptor sets with a single call.
+  /// \param pipeline_bind_point
+  /// \param layout
+  /// \param bindings
+  void bind(VkPipelineBindPoint pipeline_bind_point, VkPipelineLayout layout,
+            const DescriptorSetBindings &bindings) const;
   /// \param pipeline_bind_point  VK_PIPELINE_BIND_POINT_[COMPUTE | GRAPHICS]
   /// \param pipeline_layout      the layout that will be used by pipelines that
   ///                             will access the descriptors
@@ -297,6 +304,26 @@ public:
                              u32 first_instance = 0) const;
   void drawIndexed(u32 index_count, u32 instance_count = 1, u32 first_index = 0,
                    i32 vertex_offset = 0, u32 first_instance = 0) const;
+  /// Performs indexed draws with parameters sourced from a buffer.
+  /// \param buffer    buffer storing VkDrawIndexedIndirectCommand structs
+  /// \param offset    location of the first command in the buffer (in bytes)
+  /// \param draw_count number of draws
+  /// \param stride    distance between consecutive commands (in bytes)
+  void drawIndexedIndirect(
+      VkBuffer buffer, VkDeviceSize offset, u32 draw_count = 1,
+      u32 stride = sizeof(VkDrawIndexedIndirectCommand)) const;
+  /// Performs indexed draws with parameters and draw count sourced from
+  /// buffers.
+  /// \param buffer         buffer storing VkDrawIndexedIndirectCommand structs
+  /// \param offset         location of the first command in the buffer
+  /// \param count_buffer   buffer storing the draw count (u32)
+  /// \param count_offset   location of the draw count in count_buffer
+  /// \param max_draw_count upper bound of the draw count
+  /// \param stride         distance between consecutive commands (in bytes)
+  void drawIndexedIndirectCount(
+      VkBuffer buffer, VkDeviceSize offset, VkBuffer count_buffer,
+      VkDeviceSize count_offset, u32 max_draw_count,
+      u32 stride = sizeof(VkDrawIndexedIndirectCommand)) const;
   ///
   void traceRays(
       const VkStridedDeviceAddressRegionKHR *raygen_shader_binding_table,
@@ -304,6 +331,15 @@ public:
       const VkStridedDeviceAddressRegionKHR *hit_shader_binding_table,
       const VkStridedDeviceAddressRegionKHR *callable_shader_binding_table,
       u32 width, u32 height, u32 depth) const;
+  /// Global memory dependency between commands (synchronization2).
+  /// \param src_stage_mask
+  /// \param src_access_mask
+  /// \param dst_stage_mask
+  /// \param dst_access_mask
+  void memoryBarrier(VkPipelineStageFlags2 src_stage_mask,
+                     VkAccessFlags2 src_access_mask,
+                     VkPipelineStageFlags2 dst_stage_mask,
+                     VkAccessFlags2 dst_access_mask) const;
   /// \param barrier
   /// \param src_stages
   /// \param dst_stages
@@ -410,16 +446,28 @@ private:
 /// \brief Helper class to copy data into buffers from a single source.
 /// The BufferWritter utilizes a staging buffer that concentrates the
 /// data that is distributed into different destination buffers.
+/// \note Host visible destination buffers are written directly, skipping the
+///       staging buffer (and the submission, if no other buffer needs it).
 struct BufferWritter {
   BufferWritter &addBuffer(VkBuffer buffer, const void *data,
                            u32 size_in_bytes);
+  /// \note Data is copied directly if the buffer memory is host visible.
+  BufferWritter &addBuffer(mem::AllocatedBuffer &buffer, const void *data,
+                           u32 size_in_bytes);
   VeResult record(const core::Device &device, VkCommandBuffer cb) const;
   VeResult immediateSubmit(const engine::GraphicsDevice &gd) const;
 
 private:
+  /// Copies data into host visible destinations.
+  VeResult writeDirect() const;
+
   std::vector<const void *> data_;
   std::vector<u32> sizes_;
   std::vector<VkBuffer> buffers_;
+  // host visible destinations
+  std::vector<const void *> direct_data_;
+  std::vector<u32> direct_sizes_;
+  std::vector<mem::AllocatedBuffer *> direct_buffers_;
 };
 
 /// \brief Helper class to copy data into images from a single source.
@@ -0,0 +1,221 @@
+/* Copyright (c) 2025, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/// \file   depth_pyramid.cpp
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-18
+
+#include <venus/pipeline/depth_pyramid.h>
+
+namespace venus::pipeline {
+
+// invocations per work group dimension (local_size of depth_reduce.comp)
+static constexpr u32 k_work_group_size = 8;
+
+DepthPyramid::DepthPyramid(DepthPyramid &&rhs) noexcept {
+  *this = std::move(rhs);
+}
+
+DepthPyramid::~DepthPyramid() noexcept { destroy(); }
+
+DepthPyramid &DepthPyramid::operator=(DepthPyramid &&rhs) noexcept {
+  destroy();
+  swap(rhs);
+  return *this;
+}
+
+void DepthPyramid::destroy() noexcept {
+  pipeline_.destroy();
+  pipeline_layout_.destroy();
+  depth_buffer_.destroy();
+  pyramid_buffer_.destroy();
+  header_ = {};
+  depth_bits_ = 32;
+}
+
+void DepthPyramid::swap(DepthPyramid &rhs) {
+  VENUS_SWAP_FIELD_WITH_RHS(header_);
+  VENUS_SWAP_FIELD_WITH_RHS(depth_bits_);
+  VENUS_SWAP_FIELD_WITH_RHS(pipeline_);
+  VENUS_SWAP_FIELD_WITH_RHS(pipeline_layout_);
+  VENUS_SWAP_FIELD_WITH_RHS(depth_buffer_);
+  VENUS_SWAP_FIELD_WITH_RHS(pyramid_buffer_);
+}
+
+VeResult DepthPyramid::createPipeline(VkDevice vk_device) {
+  VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
+      pipeline_layout_,
+      Pipeline::Layout::Config()
+          .addPushConstantRange(VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                                sizeof(PushConstants))
+          .build(vk_device));
+
+  std::filesystem::path shaders_path(VENUS_SHADERS_PATH);
+  ShaderModule reduce;
+  VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
+      reduce, ShaderModule::Config()
+                  .fromSpvFile(shaders_path / "depth_reduce.comp.spv")
+                  .build(vk_device));
+
+  VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
+      pipeline_, ComputePipeline::Config()
+                     .addShaderStage(Pipeline::ShaderStage()
+                                         .setStages(VK_SHADER_STAGE_COMPUTE_BIT)
+                                         .build(reduce))
+                     .build(vk_device, *pipeline_layout_));
+
+  return VeResult::noError();
+}
+
+VeResult DepthPyramid::prepare(const engine::GraphicsDevice &gd,
+                               const VkExtent2D &depth_extent,
+                               VkFormat depth_format) {
+  if (!*pipeline_)
+    VENUS_RETURN_BAD_RESULT(createPipeline(**gd));
+
+  u32 depth_bits = 0;
+  if (depth_format == VK_FORMAT_D16_UNORM)
+    depth_bits = 16;
+  else if (depth_format == VK_FORMAT_D32_SFLOAT)
+    depth_bits = 32;
+  else {
+    HERMES_ERROR("Depth pyramid does not support depth format {}.",
+                 string_VkFormat(depth_format));
+    return VeResult::inputError();
+  }
+  if (!depth_extent.width || !depth_extent.height)
+    return VeResult::inputError();
+
+  if (*pyramid_buffer_ && depth_bits == depth_bits_ &&
+      header_.width == depth_extent.width &&
+      header_.height == depth_extent.height)
+    return VeResult::noError();
+
+  // levels halve (rounding up) down to a single texel
+  Header header{};
+  header.width = depth_extent.width;
+  header.height = depth_extent.height;
+  u32 width = depth_extent.width;
+  u32 height = depth_extent.height;
+  u32 depth_count = 0;
+  do {
+    if (header.level_count == k_max_levels)
+      return VeResult::outOfBounds();
+    width = (width + 1) / 2;
+    height = (height + 1) / 2;
+    auto &level = header.levels[header.level_count++];
+    level.offset = depth_count;
+    level.width = width;
+    level.height = height;
+    depth_count += width * height;
+  } while (width > 1 || height > 1);
+
+  depth_buffer_.destroy();
+  pyramid_buffer_.destroy();
+  VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
+      depth_buffer_,
+      mem::AllocatedBuffer::Config::forStorage(
+          static_cast<VkDeviceSize>(depth_bits / 8) * header.width *
+              header.height,
+          0)
+          .build(*gd));
+  VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
+      pyramid_buffer_, mem::AllocatedBuffer::Config::forStorage(
+                           sizeof(Header) + sizeof(f32) * depth_count, 0)
+                           .build(*gd));
+  header_ = header;
+  depth_bits_ = depth_bits;
+  return VeResult::noError();
+}
+
+VeResult DepthPyramid::record(const CommandBuffer &cb,
+                              VkImage depth_image) const {
+  if (!*pipeline_ || !*pyramid_buffer_) {
+    HERMES_ERROR("Depth pyramid must be prepared before recording.");
+    return VeResult::notFound();
+  }
+
+  // previous culling may still read the pyramid
+  cb.memoryBarrier(VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_NONE,
+                   VK_PIPELINE_STAGE_2_TRANSFER_BIT |
+                       VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                   VK_ACCESS_2_NONE);
+
+  cb.update(pyramid_buffer_, &header_, 0, sizeof(Header));
+
+  cb.transitionImage(depth_image, VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL,
+                     VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+  VkBufferImageCopy region{};
+  region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+  region.imageSubresource.layerCount = 1;
+  region.imageExtent = {header_.width, header_.height, 1};
+  cb.copy(depth_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, *depth_buffer_,
+          {region});
+  cb.transitionImage(depth_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                     VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL);
+
+  cb.memoryBarrier(VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                   VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                   VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                   VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+
+  cb.bind(pipeline_);
+
+  // each level reduces the previous one (the first reduces the depth copy)
+  const VkDeviceAddress levels_address =
+      pyramid_buffer_.deviceAddress() + sizeof(Header);
+  PushConstants push_constants{};
+  push_constants.source = depth_buffer_.deviceAddress();
+  push_constants.source_width = header_.width;
+  push_constants.source_height = header_.height;
+  push_constants.source_bits = depth_bits_;
+  for (u32 l = 0; l < header_.level_count; ++l) {
+    const auto &level = header_.levels[l];
+    push_constants.level = levels_address + sizeof(f32) * level.offset;
+    push_constants.level_width = level.width;
+    push_constants.level_height = level.height;
+    cb.pushConstants(*pipeline_layout_, VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                     sizeof(PushConstants), &push_constants);
+    cb.dispatch((level.width + k_work_group_size - 1) / k_work_group_size,
+                (level.height + k_work_group_size - 1) / k_work_group_size, 1);
+
+    cb.memoryBarrier(VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                     VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+                     VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                     VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+
+    push_constants.source = push_constants.level;
+    push_constants.source_width = level.width;
+    push_constants.source_height = level.height;
+    push_constants.source_bits = 32;
+  }
+
+  return VeResult::noError();
+}
+
+u32 DepthPyramid::levelCount() const { return header_.level_count; }
+
+VkDeviceAddress DepthPyramid::deviceAddress() const {
+  return pyramid_buffer_.deviceAddress();
+}
+
+} // namespace venus::pipeline
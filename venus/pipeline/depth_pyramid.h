@@ -0,0 +1,109 @@
+/* Copyright (c) 2025, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/// \file   depth_pyramid.h
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-18
+/// \brief  Hierarchical depth (Hi-Z) pyramid compute pass.
+
+#pragma once
+
+#include <venus/engine/graphics_device.h>
+
+namespace venus::pipeline {
+
+/// \brief Hierarchical depth buffer built by compute reductions of a depth
+///        image, used for occlusion culling (see DrawCuller).
+/// The depth image is copied into a buffer and reduced level by level, each
+/// texel keeping the farthest depth of the texels it covers. Level 0 has half
+/// the depth resolution (rounded up).
+/// \note Depth is expected to be reversed (cleared to 0, nearer is greater).
+/// \note Levels live in a single buffer, preceded by a header describing them
+///       (see shaders/draw_cull.comp), accessed through its device address.
+class DepthPyramid {
+public:
+  static constexpr u32 k_max_levels = 16;
+
+  VENUS_DECLARE_RAII_FUNCTIONS(DepthPyramid)
+  void destroy() noexcept;
+  void swap(DepthPyramid &rhs);
+
+  /// Creates the pipeline (on first use) and (re)allocates the pyramid when
+  /// the depth image extent or format changes.
+  /// \note This must be called before record.
+  /// \param gd
+  /// \param depth_extent
+  /// \param depth_format VK_FORMAT_D16_UNORM or VK_FORMAT_D32_SFLOAT.
+  VeResult prepare(const engine::GraphicsDevice &gd,
+                   const VkExtent2D &depth_extent, VkFormat depth_format);
+  /// Records the copy of the depth image followed by the reductions of all
+  /// levels and a barrier that makes the pyramid visible to compute shaders.
+  /// \note Recording must happen outside of render passes.
+  /// \param cb Command buffer being recorded.
+  /// \param depth_image Image in VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL,
+  ///        created with VK_IMAGE_USAGE_TRANSFER_SRC_BIT (and stored by the
+  ///        rendering that wrote it). It is left in the same layout.
+  HERMES_NODISCARD VeResult record(const CommandBuffer &cb,
+                                   VkImage depth_image) const;
+  /// \return Number of levels.
+  u32 levelCount() const;
+  /// \return Address of the pyramid (header followed by the levels).
+  VkDeviceAddress deviceAddress() const;
+
+private:
+  /// Layout of the pyramid header (std430).
+  struct Header {
+    u32 level_count;
+    u32 width;  //< depth image width
+    u32 height; //< depth image height
+    u32 padding;
+    struct Level {
+      u32 offset; //< first depth of the level
+      u32 width;
+      u32 height;
+      u32 padding;
+    } levels[k_max_levels];
+  };
+  /// Layout of shaders/depth_reduce.comp push constants.
+  struct PushConstants {
+    VkDeviceAddress source;
+    VkDeviceAddress level;
+    u32 source_width;
+    u32 source_height;
+    u32 source_bits;
+    u32 level_width;
+    u32 level_height;
+  };
+
+  VeResult createPipeline(VkDevice vk_device);
+
+  Header header_{};
+  u32 depth_bits_{32};
+
+  ComputePipeline pipeline_;
+  Pipeline::Layout pipeline_layout_;
+  /// raw copy of the depth image
+  mem::AllocatedBuffer depth_buffer_;
+  mem::AllocatedBuffer pyramid_buffer_;
+};
+
+} // namespace venus::pipeline
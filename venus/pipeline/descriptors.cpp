@@ -130,6 +130,28 @@ VkDescriptorSet DescriptorSet::operator*() const { return vk_descriptor_set_; }
 
 VkDevice DescriptorSet::device() const { return vk_device_; }
 
+bool DescriptorSetBindings::add(u32 set_index,
+                                VkDescriptorSet vk_descriptor_set) {
+  if (set_count == k_max_sets)
+    return false;
+  Range *last = range_count ? &ranges[range_count - 1] : nullptr;
+  if (last && set_index < last->first_set + last->count)
+    return false;
+  if (!last || last->first_set + last->count != set_index) {
+    if (range_count == k_max_ranges)
+      return false;
+    last = &ranges[range_count++];
+    last->first_set = set_index;
+    last->offset = set_count;
+    last->count = 0;
+  }
+  descriptor_sets[set_count++] = vk_descriptor_set;
+  ++last->count;
+  return true;
+}
+
+bool DescriptorSetBindings::empty() const { return set_count == 0; }
+
 DescriptorAllocator::Config &
 DescriptorAllocator::Config::setInitialSetCount(u32 set_count) {
   initial_set_count_ = set_count;
@@ -111,6 +111,34 @@ private:
 #endif
 };
 
+/// Fixed capacity list of descriptor sets grouped into ranges of consecutive
+/// set indices, so each range is bound with a single call.
+/// \note This struct does not allocate and can be copied into draw records.
+struct DescriptorSetBindings {
+  static constexpr u32 k_max_sets = 8;
+  static constexpr u32 k_max_ranges = 4;
+  /// Descriptor sets bound at set indices [first_set, first_set + count).
+  struct Range {
+    u32 first_set{0};
+    u32 offset{0}; //< position of the first descriptor set in the list.
+    u32 count{0};
+  };
+
+  /// Appends a descriptor set, extending the last range when contiguous.
+  /// \note Descriptor sets must be added in increasing set index order.
+  /// \param set_index
+  /// \param vk_descriptor_set
+  /// \return false if capacity is exceeded or the order is broken.
+  HERMES_NODISCARD bool add(u32 set_index, VkDescriptorSet vk_descriptor_set);
+  /// \return true if there are no descriptor sets.
+  HERMES_NODISCARD bool empty() const;
+
+  VkDescriptorSet descriptor_sets[k_max_sets]{};
+  Range ranges[k_max_ranges]{};
+  u32 set_count{0};
+  u32 range_count{0};
+};
+
 /// Manages the allocation of device memory for storing descriptor sets. The
 /// descriptor allocator generates descriptor pools as more allocation
 /// requests come in. Each pool is created based on the defined the list pool
@@ -280,6 +308,23 @@ template <> struct DebugTraits<venus::pipeline::DescriptorSet> {
   }
 };
 
+template <> struct DebugTraits<venus::pipeline::DescriptorSetBindings> {
+  static HERMES_CONST_OR_CONSTEXPR bool is_string_serializable = true;
+  static DebugMessage
+  message(const venus::pipeline::DescriptorSetBindings &data) {
+    DebugMessage m;
+    m.addTitle("DescriptorSet Bindings").pushTab();
+    for (u32 r = 0; r < data.range_count; ++r) {
+      const auto &range = data.ranges[r];
+      m.addFmt("first set index {}", range.first_set);
+      for (u32 i = 0; i < range.count; ++i)
+        m.addFmt("{}", VENUS_VK_HANDLE_STRING(
+                           data.descriptor_sets[range.offset + i]));
+    }
+    return m;
+  }
+};
+
 template <>
 struct DebugTraits<venus::pipeline::DescriptorAllocator::PoolSizeRatio> {
   static HERMES_CONST_OR_CONSTEXPR bool is_string_serializable = true;
@@ -0,0 +1,414 @@
+/* Copyright (c) 2025, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/// \file   draw_culler.cpp
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-18
+
+#include <venus/pipeline/draw_culler.h>
+
+#include <cstring>
+
+namespace venus::pipeline {
+
+// invocations per work group (local_size_x of draw_cull.comp)
+static constexpr u32 k_work_group_size = 64;
+// work groups per dispatch (guaranteed maxComputeWorkGroupCount[0])
+static constexpr u32 k_max_dispatch_size = 65535;
+// vkCmdUpdateBuffer limit (in bytes)
+static constexpr VkDeviceSize k_max_update_size = 65536;
+
+// Uploads the [first, end) range of data through the command buffer, in
+// chunks of the update limit.
+template <typename T>
+static void updateBuffer(const CommandBuffer &cb, const mem::Buffer &buffer,
+                         const std::vector<T> &data, h_index first,
+                         h_index end) {
+  const auto *bytes = reinterpret_cast<const u8 *>(data.data());
+  VkDeviceSize size = sizeof(T) * end;
+  for (VkDeviceSize offset = sizeof(T) * first; offset < size;
+       offset += k_max_update_size)
+    cb.update(buffer, bytes + offset, offset,
+              std::min(k_max_update_size, size - offset));
+}
+
+// Uploads data through the command buffer, in chunks of the update limit.
+template <typename T>
+static void updateBuffer(const CommandBuffer &cb, const mem::Buffer &buffer,
+                         const std::vector<T> &data) {
+  updateBuffer(cb, buffer, data, 0, data.size());
+}
+
+// Grows the buffer (contents are lost) to hold at least size_in_bytes.
+static VeResult growBuffer(const engine::GraphicsDevice &gd,
+                           mem::AllocatedBuffer &buffer,
+                           VkDeviceSize size_in_bytes,
+                           VkBufferUsageFlags usage, bool &grown) {
+  if (buffer.sizeInBytes() >= size_in_bytes)
+    return VeResult::noError();
+  buffer.destroy();
+  VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
+      buffer, mem::AllocatedBuffer::Config::forStorage(size_in_bytes, usage)
+                  .build(*gd));
+  grown = true;
+  return VeResult::noError();
+}
+
+DrawCuller::DrawCuller(DrawCuller &&rhs) noexcept { *this = std::move(rhs); }
+
+DrawCuller::~DrawCuller() noexcept { destroy(); }
+
+DrawCuller &DrawCuller::operator=(DrawCuller &&rhs) noexcept {
+  destroy();
+  swap(rhs);
+  return *this;
+}
+
+void DrawCuller::destroy() noexcept {
+  pipeline_.destroy();
+  pipeline_layout_.destroy();
+  object_buffer_.destroy();
+  transform_buffer_.destroy();
+  draw_commands_buffer_.destroy();
+  draw_counts_buffer_.destroy();
+  visibility_buffer_.destroy();
+  objects_.clear();
+  object_data_.clear();
+  transforms_.clear();
+  buckets_.clear();
+  objects_changed_ = true;
+  upload_ = false;
+  changed_transforms_ = {0, 0};
+  transform_upload_ = {0, 0};
+  depth_pyramid_ = nullptr;
+  reset_visibility_ = false;
+}
+
+void DrawCuller::swap(DrawCuller &rhs) {
+  VENUS_SWAP_FIELD_WITH_RHS(proj_view_);
+  VENUS_SWAP_FIELD_WITH_RHS(objects_);
+  VENUS_SWAP_FIELD_WITH_RHS(object_data_);
+  VENUS_SWAP_FIELD_WITH_RHS(transforms_);
+  VENUS_SWAP_FIELD_WITH_RHS(buckets_);
+  VENUS_SWAP_FIELD_WITH_RHS(objects_changed_);
+  VENUS_SWAP_FIELD_WITH_RHS(upload_);
+  VENUS_SWAP_FIELD_WITH_RHS(changed_transforms_);
+  VENUS_SWAP_FIELD_WITH_RHS(transform_upload_);
+  VENUS_SWAP_FIELD_WITH_RHS(depth_pyramid_);
+  VENUS_SWAP_FIELD_WITH_RHS(reset_visibility_);
+  VENUS_SWAP_FIELD_WITH_RHS(pipeline_);
+  VENUS_SWAP_FIELD_WITH_RHS(pipeline_layout_);
+  VENUS_SWAP_FIELD_WITH_RHS(object_buffer_);
+  VENUS_SWAP_FIELD_WITH_RHS(transform_buffer_);
+  VENUS_SWAP_FIELD_WITH_RHS(draw_commands_buffer_);
+  VENUS_SWAP_FIELD_WITH_RHS(draw_counts_buffer_);
+  VENUS_SWAP_FIELD_WITH_RHS(visibility_buffer_);
+}
+
+DrawCuller &DrawCuller::setCamera(const hermes::geo::Transform &proj_view) {
+  proj_view_ = proj_view;
+  return *this;
+}
+
+DrawCuller &DrawCuller::setDepthPyramid(const DepthPyramid *depth_pyramid) {
+  depth_pyramid_ = depth_pyramid;
+  return *this;
+}
+
+h_index DrawCuller::add(const DrawObject &draw_object) {
+  objects_.emplace_back(draw_object);
+  objects_changed_ = true;
+  return objects_.size() - 1;
+}
+
+DrawCuller &DrawCuller::setTransform(h_index object,
+                                     const hermes::geo::Transform &model) {
+  HERMES_ASSERT(object < objects_.size());
+  objects_[object].model = model;
+  // prepared transforms are patched in place
+  if (objects_changed_ || object >= transforms_.size())
+    return *this;
+  transforms_[object] = hermes::math::transpose(model.matrix());
+  if (changed_transforms_.first == changed_transforms_.second)
+    changed_transforms_ = {object, object + 1};
+  else
+    changed_transforms_ = {std::min(changed_transforms_.first, object),
+                           std::max(changed_transforms_.second, object + 1)};
+  return *this;
+}
+
+DrawCuller &DrawCuller::clear() {
+  objects_.clear();
+  objects_changed_ = true;
+  return *this;
+}
+
+VeResult DrawCuller::createPipeline(VkDevice vk_device) {
+  VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
+      pipeline_layout_,
+      Pipeline::Layout::Config()
+          .addPushConstantRange(VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                                sizeof(PushConstants))
+          .build(vk_device));
+
+  std::filesystem::path shaders_path(VENUS_SHADERS_PATH);
+  ShaderModule cull;
+  VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
+      cull, ShaderModule::Config()
+                .fromSpvFile(shaders_path / "draw_cull.comp.spv")
+                .build(vk_device));
+
+  VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
+      pipeline_, ComputePipeline::Config()
+                     .addShaderStage(Pipeline::ShaderStage()
+                                         .setStages(VK_SHADER_STAGE_COMPUTE_BIT)
+                                         .build(cull))
+                     .build(vk_device, *pipeline_layout_));
+
+  return VeResult::noError();
+}
+
+VeResult DrawCuller::reserve(const engine::GraphicsDevice &gd,
+                             h_size object_count) {
+  bool grown = false;
+  VENUS_RETURN_BAD_RESULT(growBuffer(
+      gd, transform_buffer_,
+      sizeof(hermes::geo::Transform) * std::max<h_size>(object_count, 1), 0,
+      grown));
+  // transforms are lost
+  if (grown)
+    transforms_.clear();
+  return VeResult::noError();
+}
+
+VeResult DrawCuller::prepare(const engine::GraphicsDevice &gd) {
+  if (!*pipeline_)
+    VENUS_RETURN_BAD_RESULT(createPipeline(**gd));
+
+  // command ranges of buckets
+  if (objects_changed_) {
+    u32 bucket_count = 0;
+    for (const auto &object : objects_)
+      bucket_count = std::max(bucket_count, object.bucket + 1);
+    buckets_.assign(bucket_count, {0, 0});
+    for (const auto &object : objects_)
+      ++buckets_[object.bucket].second;
+    u32 first_command = 0;
+    for (auto &bucket : buckets_) {
+      bucket.first = first_command;
+      first_command += bucket.second;
+    }
+  }
+  const u32 bucket_count = static_cast<u32>(buckets_.size());
+
+  // buffers only grow (object data is uploaded again when they do)
+  bool grown = false;
+  const h_size object_count = std::max<h_size>(objects_.size(), 1);
+  // each occlusion culling phase has its own commands and counts
+  const h_size phase_count = depth_pyramid_ ? 2 : 1;
+  VENUS_RETURN_BAD_RESULT(growBuffer(gd, object_buffer_,
+                                     sizeof(ObjectData) * object_count, 0,
+                                     grown));
+  VENUS_RETURN_BAD_RESULT(growBuffer(
+      gd, transform_buffer_, sizeof(hermes::geo::Transform) * object_count, 0,
+      grown));
+  VENUS_RETURN_BAD_RESULT(growBuffer(
+      gd, draw_commands_buffer_,
+      sizeof(VkDrawIndexedIndirectCommand) * object_count * phase_count,
+      VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, grown));
+  VENUS_RETURN_BAD_RESULT(growBuffer(
+      gd, draw_counts_buffer_,
+      sizeof(u32) * std::max<h_size>(bucket_count, 1) * phase_count,
+      VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, grown));
+  // visibility starts cleared (all objects are drawn by the second phase)
+  reset_visibility_ = false;
+  if (depth_pyramid_)
+    VENUS_RETURN_BAD_RESULT(growBuffer(gd, visibility_buffer_,
+                                       sizeof(u32) * object_count, 0,
+                                       reset_visibility_));
+
+  // only transforms changed (see setTransform)
+  if (!objects_changed_ && !grown && object_data_.size() == objects_.size() &&
+      transforms_.size() == objects_.size()) {
+    upload_ = false;
+    transform_upload_ = changed_transforms_;
+    changed_transforms_ = {0, 0};
+    return VeResult::noError();
+  }
+  objects_changed_ = false;
+  changed_transforms_ = {0, 0};
+  transform_upload_ = {0, 0};
+
+  // host copies of the device data detect changes between frames
+  upload_ = grown || object_data_.size() != objects_.size();
+  object_data_.resize(objects_.size());
+  transforms_.resize(objects_.size());
+  for (h_index i = 0; i < objects_.size(); ++i) {
+    const auto &object = objects_[i];
+    ObjectData data{};
+    auto center = object.bounds.center();
+    for (u32 d = 0; d < 3; ++d)
+      data.sphere[d] = center[d];
+    // a zero radius keeps objects without bounds out of both culling tests
+    data.sphere[3] = std::max(object.bounds.radius(), 0.f);
+    data.index_count = object.index_count;
+    data.first_index = object.first_index;
+    data.bucket = object.bucket;
+    data.first_command = buckets_[object.bucket].first;
+    hermes::geo::Transform transform =
+        hermes::math::transpose(object.model.matrix());
+    if (!upload_ &&
+        (std::memcmp(&data, &object_data_[i], sizeof(ObjectData)) ||
+         std::memcmp(&transform, &transforms_[i], sizeof(transform))))
+      upload_ = true;
+    object_data_[i] = data;
+    transforms_[i] = transform;
+  }
+  return VeResult::noError();
+}
+
+VeResult DrawCuller::record(const CommandBuffer &cb) const {
+  if (objects_.empty())
+    return VeResult::noError();
+  if (!*pipeline_ || !*object_buffer_ || !*draw_commands_buffer_ ||
+      object_data_.size() != objects_.size()) {
+    HERMES_ERROR("Draw culler must be prepared before recording.");
+    return VeResult::notFound();
+  }
+
+  // previous draws may still read the output (and the transforms)
+  cb.memoryBarrier(VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT |
+                       VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT,
+                   VK_ACCESS_2_NONE,
+                   VK_PIPELINE_STAGE_2_TRANSFER_BIT |
+                       VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                   VK_ACCESS_2_NONE);
+  // visibility was written by the previous occlusion culling
+  if (depth_pyramid_)
+    cb.memoryBarrier(VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                     VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+                     VK_PIPELINE_STAGE_2_TRANSFER_BIT |
+                         VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                     VK_ACCESS_2_TRANSFER_WRITE_BIT |
+                         VK_ACCESS_2_SHADER_STORAGE_READ_BIT |
+                         VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+
+  if (upload_) {
+    updateBuffer(cb, object_buffer_, object_data_);
+    updateBuffer(cb, transform_buffer_, transforms_);
+  } else if (transform_upload_.first < transform_upload_.second)
+    updateBuffer(cb, transform_buffer_, transforms_, transform_upload_.first,
+                 transform_upload_.second);
+  if (depth_pyramid_ && reset_visibility_)
+    cb.fill(visibility_buffer_, 0u);
+  // draw counts (of all phases) are accumulated by the shader
+  cb.fill(draw_counts_buffer_, 0u);
+
+  cb.memoryBarrier(VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                   VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                   VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT |
+                       VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT,
+                   VK_ACCESS_2_SHADER_STORAGE_READ_BIT |
+                       VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+
+  dispatch(cb, depth_pyramid_ ? Phase::PREVIOUS : Phase::FRUSTUM);
+
+  return VeResult::noError();
+}
+
+VeResult DrawCuller::recordOcclusion(const CommandBuffer &cb) const {
+  if (objects_.empty())
+    return VeResult::noError();
+  if (!depth_pyramid_ || !*visibility_buffer_) {
+    HERMES_ERROR("Occlusion culling requires a prepared depth pyramid.");
+    return VeResult::notFound();
+  }
+
+  dispatch(cb, Phase::OCCLUSION);
+
+  return VeResult::noError();
+}
+
+void DrawCuller::dispatch(const CommandBuffer &cb, Phase phase) const {
+  cb.bind(pipeline_);
+
+  // the second phase writes after the commands and counts of the first
+  const u32 phase_index = phase == Phase::OCCLUSION ? 1 : 0;
+  PushConstants push_constants{};
+  push_constants.proj_view = hermes::math::transpose(proj_view_.matrix());
+  push_constants.objects = object_buffer_.deviceAddress();
+  push_constants.transforms = transform_buffer_.deviceAddress();
+  push_constants.draw_commands =
+      draw_commands_buffer_.deviceAddress() + drawOffset(0, phase_index);
+  push_constants.draw_counts =
+      draw_counts_buffer_.deviceAddress() + countOffset(0, phase_index);
+  if (depth_pyramid_) {
+    push_constants.visibility = visibility_buffer_.deviceAddress();
+    push_constants.depth_pyramid = depth_pyramid_->deviceAddress();
+  }
+  push_constants.object_count = static_cast<u32>(objects_.size());
+  push_constants.phase = static_cast<u32>(phase);
+  const u32 max_dispatch_objects = k_max_dispatch_size * k_work_group_size;
+  for (u32 first = 0; first < objects_.size(); first += max_dispatch_objects) {
+    u32 count = std::min(max_dispatch_objects,
+                         static_cast<u32>(objects_.size()) - first);
+    push_constants.first_object = first;
+    cb.pushConstants(*pipeline_layout_, VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                     sizeof(PushConstants), &push_constants);
+    cb.dispatch((count + k_work_group_size - 1) / k_work_group_size, 1, 1);
+  }
+
+  cb.memoryBarrier(VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                   VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+                   VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT,
+                   VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT);
+}
+
+const DepthPyramid *DrawCuller::depthPyramid() const { return depth_pyramid_; }
+
+u32 DrawCuller::bucketCount() const {
+  return static_cast<u32>(buckets_.size());
+}
+
+VkBuffer DrawCuller::drawBuffer() const { return *draw_commands_buffer_; }
+
+VkDeviceSize DrawCuller::drawOffset(u32 bucket, u32 phase) const {
+  const u32 first = bucket < buckets_.size() ? buckets_[bucket].first : 0;
+  return sizeof(VkDrawIndexedIndirectCommand) *
+         (phase * objects_.size() + first);
+}
+
+VkBuffer DrawCuller::countBuffer() const { return *draw_counts_buffer_; }
+
+VkDeviceSize DrawCuller::countOffset(u32 bucket, u32 phase) const {
+  return sizeof(u32) * (phase * buckets_.size() + bucket);
+}
+
+u32 DrawCuller::maxDrawCount(u32 bucket) const {
+  return buckets_[bucket].second;
+}
+
+VkDeviceAddress DrawCuller::transformBuffer() const {
+  return transform_buffer_.deviceAddress();
+}
+
+} // namespace venus::pipeline
@@ -0,0 +1,184 @@
+/* Copyright (c) 2025, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/// \file   draw_culler.h
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-18
+/// \brief  Draw culling compute pass.
+
+#pragma once
+
+#include <venus/engine/graphics_device.h>
+#include <venus/pipeline/depth_pyramid.h>
+
+#include <hermes/geometry/bounds.h>
+#include <hermes/geometry/transform.h>
+
+namespace venus::pipeline {
+
+/// \brief Culls whole draws against the view frustum in a compute pass.
+/// Visible draws are compacted into the indirect draw commands of their bucket
+/// and counted, so each bucket is drawn by a single indirect count draw (see
+/// Rasterizer::cullObjects). Draws of a bucket share all state but their index
+/// range and transform: the command of a draw sets its object index as first
+/// instance, which indexes the object transform in transformBuffer().
+/// \note Object data lives in persistent device buffers, only rewritten when
+///       the objects change between frames.
+/// \note Recording must happen outside of render passes.
+/// \note With a depth pyramid, draws are also occlusion culled in two phases
+///       (see setDepthPyramid).
+class DrawCuller {
+public:
+  struct DrawObject {
+    hermes::geo::Transform model; //< object to world transform.
+    /// Object space bounds (objects with zero radius are never culled).
+    hermes::geo::bounds::bsphere3 bounds;
+    u32 index_count{0};
+    u32 first_index{0};
+    u32 bucket{0};
+  };
+
+  VENUS_DECLARE_RAII_FUNCTIONS(DrawCuller)
+  void destroy() noexcept;
+  void swap(DrawCuller &rhs);
+
+  /// \param proj_view Projection times view transform.
+  DrawCuller &setCamera(const hermes::geo::Transform &proj_view);
+  /// Enables two phase occlusion culling. The first phase (record) draws the
+  /// objects visible in the previous frame. The second phase
+  /// (recordOcclusion) tests all objects against the depth pyramid, built from
+  /// the depth of the first phase draws, and draws the ones that became
+  /// visible. Each phase has its own draw commands (see drawOffset).
+  /// \note The visibility of objects is kept between frames by object index.
+  /// \param depth_pyramid Pyramid (or nullptr to disable occlusion culling).
+  ///        It must outlive the recorded commands.
+  DrawCuller &setDepthPyramid(const DepthPyramid *depth_pyramid);
+  /// \param draw_object
+  /// \return Index of the object (its instance index).
+  h_index add(const DrawObject &draw_object);
+  /// Replaces the transform of an object, only changed transforms are
+  /// uploaded when no objects were added since the last prepare.
+  /// \param object Object index.
+  /// \param model Object to world transform.
+  DrawCuller &setTransform(h_index object,
+                           const hermes::geo::Transform &model);
+  /// Removes all objects (buffers are kept for the next frame).
+  DrawCuller &clear();
+  /// Grows the transform buffer to fit the given number of objects, so its
+  /// address can be given to shaders before objects are added.
+  /// \param gd
+  /// \param object_count
+  VeResult reserve(const engine::GraphicsDevice &gd, h_size object_count);
+  /// Creates the pipeline (on first use), grows the buffers to fit the
+  /// current objects and computes the command range of each bucket.
+  /// \note This must be called before record.
+  /// \note Buckets and object data are only computed again when objects were
+  ///       added or cleared.
+  /// \param gd
+  VeResult prepare(const engine::GraphicsDevice &gd);
+  /// Records the upload of changed object data and the culling commands (of
+  /// the first phase), followed by a barrier that makes the output visible to
+  /// indirect draws.
+  /// \param cb Command buffer being recorded.
+  HERMES_NODISCARD VeResult record(const CommandBuffer &cb) const;
+  /// Records the culling commands of the second phase of occlusion culling.
+  /// \note The depth pyramid must be recorded before.
+  /// \param cb Command buffer being recorded.
+  HERMES_NODISCARD VeResult recordOcclusion(const CommandBuffer &cb) const;
+  /// \return Depth pyramid used for occlusion culling (if enabled).
+  const DepthPyramid *depthPyramid() const;
+  /// \return Number of buckets (highest bucket plus one).
+  u32 bucketCount() const;
+  /// \return Buffer holding the draw commands of all buckets.
+  VkBuffer drawBuffer() const;
+  /// \param bucket
+  /// \param phase Occlusion culling phase (0 or 1).
+  /// \return Offset (in bytes) of the first draw command of the bucket.
+  VkDeviceSize drawOffset(u32 bucket, u32 phase = 0) const;
+  /// \return Buffer holding the draw count of each bucket.
+  VkBuffer countBuffer() const;
+  /// \param bucket
+  /// \param phase Occlusion culling phase (0 or 1).
+  /// \return Offset (in bytes) of the draw count of the bucket.
+  VkDeviceSize countOffset(u32 bucket, u32 phase = 0) const;
+  /// \param bucket
+  /// \return Number of objects of the bucket.
+  u32 maxDrawCount(u32 bucket) const;
+  /// \return Address of the (transposed) object transforms.
+  VkDeviceAddress transformBuffer() const;
+
+private:
+  /// Layout of shaders/draw_cull.comp objects (std430).
+  struct ObjectData {
+    f32 sphere[4]; //< center, radius
+    u32 index_count;
+    u32 first_index;
+    u32 bucket;
+    u32 first_command; //< first draw command of the bucket
+  };
+  /// Layout of shaders/draw_cull.comp push constants.
+  struct PushConstants {
+    hermes::geo::Transform proj_view;
+    VkDeviceAddress objects;
+    VkDeviceAddress transforms;
+    VkDeviceAddress draw_commands;
+    VkDeviceAddress draw_counts;
+    VkDeviceAddress visibility;
+    VkDeviceAddress depth_pyramid;
+    u32 first_object;
+    u32 object_count;
+    u32 phase;
+  };
+  /// Culling phases of shaders/draw_cull.comp.
+  enum class Phase : u32 { FRUSTUM = 0, PREVIOUS = 1, OCCLUSION = 2 };
+
+  VeResult createPipeline(VkDevice vk_device);
+  void dispatch(const CommandBuffer &cb, Phase phase) const;
+
+  hermes::geo::Transform proj_view_;
+  std::vector<DrawObject> objects_;
+  std::vector<ObjectData> object_data_;
+  std::vector<hermes::geo::Transform> transforms_;
+  /// first draw command and object count of each bucket
+  std::vector<std::pair<u32, u32>> buckets_;
+  /// objects were added or cleared since the last prepare
+  bool objects_changed_{true};
+  /// object data and transforms need to be uploaded
+  bool upload_{false};
+  /// transforms set since the last prepare (see setTransform)
+  std::pair<h_index, h_index> changed_transforms_{0, 0};
+  /// transforms uploaded by record (when upload_ is false)
+  std::pair<h_index, h_index> transform_upload_{0, 0};
+  const DepthPyramid *depth_pyramid_{nullptr};
+  /// visibility is reset (the visibility buffer was reallocated)
+  bool reset_visibility_{false};
+
+  ComputePipeline pipeline_;
+  Pipeline::Layout pipeline_layout_;
+  mem::AllocatedBuffer object_buffer_;
+  mem::AllocatedBuffer transform_buffer_;
+  mem::AllocatedBuffer draw_commands_buffer_;
+  mem::AllocatedBuffer draw_counts_buffer_;
+  mem::AllocatedBuffer visibility_buffer_;
+};
+
+} // namespace venus::pipeline
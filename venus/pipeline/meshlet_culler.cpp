@@ -0,0 +1,230 @@
+/* Copyright (c) 2025, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+/// \file   meshlet_culler.cpp
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-18
+
+#include <venus/pipeline/meshlet_culler.h>
+
+namespace venus::pipeline {
+
+// size of scene::Meshlet (std430 struct read by meshlet_cull.comp)
+static constexpr VkDeviceSize k_meshlet_size = 64;
+// work groups per dispatch (guaranteed maxComputeWorkGroupCount[0])
+static constexpr u32 k_max_dispatch_size = 65535;
+// vkCmdUpdateBuffer limit (in bytes)
+static constexpr VkDeviceSize k_max_update_size = 65536;
+
+MeshletCuller::MeshletCuller(MeshletCuller &&rhs) noexcept {
+  *this = std::move(rhs);
+}
+
+MeshletCuller::~MeshletCuller() noexcept { destroy(); }
+
+MeshletCuller &MeshletCuller::operator=(MeshletCuller &&rhs) noexcept {
+  destroy();
+  swap(rhs);
+  return *this;
+}
+
+void MeshletCuller::destroy() noexcept {
+  pipeline_.destroy();
+  pipeline_layout_.destroy();
+  indices_.destroy();
+  draw_commands_buffer_.destroy();
+  objects_.clear();
+  draw_commands_.clear();
+  output_index_count_ = 0;
+}
+
+void MeshletCuller::swap(MeshletCuller &rhs) {
+  VENUS_SWAP_FIELD_WITH_RHS(proj_view_);
+  VENUS_SWAP_FIELD_WITH_RHS(eye_);
+  VENUS_SWAP_FIELD_WITH_RHS(objects_);
+  VENUS_SWAP_FIELD_WITH_RHS(draw_commands_);
+  VENUS_SWAP_FIELD_WITH_RHS(output_index_count_);
+  VENUS_SWAP_FIELD_WITH_RHS(pipeline_);
+  VENUS_SWAP_FIELD_WITH_RHS(pipeline_layout_);
+  VENUS_SWAP_FIELD_WITH_RHS(indices_);
+  VENUS_SWAP_FIELD_WITH_RHS(draw_commands_buffer_);
+}
+
+MeshletCuller &MeshletCuller::setCamera(const hermes::geo::Transform &proj_view,
+                                        const hermes::geo::point3 &eye) {
+  proj_view_ = proj_view;
+  eye_ = eye;
+  return *this;
+}
+
+h_index MeshletCuller::add(const CullObject &cull_object) {
+  VkDrawIndexedIndirectCommand draw_command{};
+  draw_command.indexCount = 0;
+  draw_command.instanceCount = 1;
+  draw_command.firstIndex = output_index_count_;
+  draw_command.vertexOffset = 0;
+  draw_command.firstInstance = 0;
+  draw_commands_.emplace_back(draw_command);
+  objects_.emplace_back(cull_object);
+  output_index_count_ += cull_object.index_count;
+  return objects_.size() - 1;
+}
+
+MeshletCuller &MeshletCuller::clear() {
+  objects_.clear();
+  draw_commands_.clear();
+  output_index_count_ = 0;
+  return *this;
+}
+
+VeResult MeshletCuller::createPipeline(VkDevice vk_device) {
+  VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
+      pipeline_layout_,
+      Pipeline::Layout::Config()
+          .addPushConstantRange(VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                                sizeof(PushConstants))
+          .build(vk_device));
+
+  std::filesystem::path shaders_path(VENUS_SHADERS_PATH);
+  ShaderModule cull;
+  VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
+      cull, ShaderModule::Config()
+                .fromSpvFile(shaders_path / "meshlet_cull.comp.spv")
+                .build(vk_device));
+
+  VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
+      pipeline_, ComputePipeline::Config()
+                     .addShaderStage(Pipeline::ShaderStage()
+                                         .setStages(VK_SHADER_STAGE_COMPUTE_BIT)
+                                         .build(cull))
+                     .build(vk_device, *pipeline_layout_));
+
+  return VeResult::noError();
+}
+
+VeResult MeshletCuller::prepare(const engine::GraphicsDevice &gd) {
+  if (!*pipeline_)
+    VENUS_RETURN_BAD_RESULT(createPipeline(**gd));
+
+  // output buffers only grow
+  VkDeviceSize indices_size = sizeof(u32) * std::max(output_index_count_, 1u);
+  if (indices_.sizeInBytes() < indices_size) {
+    indices_.destroy();
+    VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
+        indices_, mem::AllocatedBuffer::Config::forStorage(
+                      indices_size, VK_BUFFER_USAGE_INDEX_BUFFER_BIT)
+                      .build(*gd));
+  }
+  VkDeviceSize draw_commands_size = sizeof(VkDrawIndexedIndirectCommand) *
+                                    std::max<h_size>(draw_commands_.size(), 1);
+  if (draw_commands_buffer_.sizeInBytes() < draw_commands_size) {
+    draw_commands_buffer_.destroy();
+    VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
+        draw_commands_buffer_,
+        mem::AllocatedBuffer::Config::forStorage(
+            draw_commands_size, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT)
+            .build(*gd));
+  }
+  return VeResult::noError();
+}
+
+VeResult MeshletCuller::record(const CommandBuffer &cb) const {
+  if (objects_.empty())
+    return VeResult::noError();
+  if (!*pipeline_ || !*indices_ || !*draw_commands_buffer_) {
+    HERMES_ERROR("Meshlet culler must be prepared before recording.");
+    return VeResult::notFound();
+  }
+
+  // previous draws may still read the output
+  cb.memoryBarrier(VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT |
+                       VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT,
+                   VK_ACCESS_2_NONE,
+                   VK_PIPELINE_STAGE_2_TRANSFER_BIT |
+                       VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                   VK_ACCESS_2_NONE);
+
+  // reset draw commands (index counts are accumulated by the shader)
+  const auto *draw_commands_data =
+      reinterpret_cast<const u8 *>(draw_commands_.data());
+  VkDeviceSize draw_commands_size =
+      sizeof(VkDrawIndexedIndirectCommand) * draw_commands_.size();
+  for (VkDeviceSize offset = 0; offset < draw_commands_size;
+       offset += k_max_update_size)
+    cb.update(draw_commands_buffer_, draw_commands_data + offset, offset,
+              std::min(k_max_update_size, draw_commands_size - offset));
+
+  cb.memoryBarrier(VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                   VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                   VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                   VK_ACCESS_2_SHADER_STORAGE_READ_BIT |
+                       VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+
+  cb.bind(pipeline_);
+
+  PushConstants push_constants{};
+  push_constants.eye[3] = 1.f;
+  for (h_index i = 0; i < objects_.size(); ++i) {
+    const auto &object = objects_[i];
+    // culling happens in object space
+    push_constants.mvp =
+        hermes::math::transpose((proj_view_ * object.model).matrix());
+    auto eye = hermes::geo::inverse(object.model)(eye_);
+    for (u32 d = 0; d < 3; ++d)
+      push_constants.eye[d] = eye[d];
+    push_constants.indices = object.index_data;
+    push_constants.short_indices = object.index_type == VK_INDEX_TYPE_UINT16;
+    push_constants.output_indices =
+        indices_.deviceAddress() + sizeof(u32) * draw_commands_[i].firstIndex;
+    push_constants.draw_command =
+        draw_commands_buffer_.deviceAddress() + drawOffset(i);
+    for (u32 first = 0; first < object.meshlet_count;
+         first += k_max_dispatch_size) {
+      u32 count = std::min(k_max_dispatch_size, object.meshlet_count - first);
+      push_constants.meshlets = object.meshlet_data + k_meshlet_size * first;
+      push_constants.meshlet_count = count;
+      cb.pushConstants(*pipeline_layout_, VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                       sizeof(PushConstants), &push_constants);
+      cb.dispatch(count, 1, 1);
+    }
+  }
+
+  cb.memoryBarrier(VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                   VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+                   VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT |
+                       VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT,
+                   VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT |
+                       VK_ACCESS_2_INDEX_READ_BIT);
+
+  return VeResult::noError();
+}
+
+VkBuffer MeshletCuller::indexBuffer() const { return *indices_; }
+
+VkBuffer MeshletCuller::drawBuffer() const { return *draw_commands_buffer_; }
+
+VkDeviceSize MeshletCuller::drawOffset(h_index object_index) const {
+  return sizeof(VkDrawIndexedIndirectCommand) * object_index;
+}
+
+} // namespace venus::pipeline
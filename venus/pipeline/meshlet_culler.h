@@ -0,0 +1,113 @@
+/* Copyright (c) 2025, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+/// \file   meshlet_culler.h
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-18
+/// \brief  Meshlet culling compute pass.
+
+#pragma once
+
+#include <venus/engine/graphics_device.h>
+
+#include <hermes/geometry/transform.h>
+
+namespace venus::pipeline {
+
+/// \brief Culls meshlets (see scene::Meshlet) against the view frustum and
+///        their normal cones in a compute pass.
+/// The indices of the visible meshlets of each object are compacted into a
+/// shared index buffer, which is drawn through the indirect command of the
+/// object (see Rasterizer::RasterObject::indirect_buffer).
+/// \note Recording must happen outside of render passes.
+class MeshletCuller {
+public:
+  struct CullObject {
+    hermes::geo::Transform model;    //< object to world transform.
+    VkDeviceAddress meshlet_data{0}; //< address of the first meshlet.
+    VkDeviceAddress index_data{0};   //< index buffer read by the meshlets.
+    /// \note Output indices are always VK_INDEX_TYPE_UINT32.
+    VkIndexType index_type{VK_INDEX_TYPE_UINT32};
+    u32 meshlet_count{0};
+    u32 index_count{0}; //< index count of all meshlets.
+  };
+
+  VENUS_DECLARE_RAII_FUNCTIONS(MeshletCuller)
+  void destroy() noexcept;
+  void swap(MeshletCuller &rhs);
+
+  /// \param proj_view Projection times view transform.
+  /// \param eye Camera position (world space).
+  MeshletCuller &setCamera(const hermes::geo::Transform &proj_view,
+                           const hermes::geo::point3 &eye);
+  /// \param cull_object
+  /// \return Index of the object (see drawOffset).
+  h_index add(const CullObject &cull_object);
+  /// Removes all objects (buffers are kept for the next frame).
+  MeshletCuller &clear();
+  /// Creates the pipeline (on first use) and grows the output buffers to fit
+  /// the current objects.
+  /// \note This must be called before record.
+  /// \param gd
+  VeResult prepare(const engine::GraphicsDevice &gd);
+  /// Records the culling commands of all objects, followed by a barrier that
+  /// makes the output visible to indirect draws.
+  /// \param cb Command buffer being recorded.
+  HERMES_NODISCARD VeResult record(const CommandBuffer &cb) const;
+  /// \return Buffer holding the compacted indices of all objects.
+  VkBuffer indexBuffer() const;
+  /// \return Buffer holding the indirect draw commands.
+  VkBuffer drawBuffer() const;
+  /// \param object_index
+  /// \return Offset (in bytes) of the object draw command in drawBuffer().
+  VkDeviceSize drawOffset(h_index object_index) const;
+
+private:
+  /// Layout of shaders/meshlet_cull.comp push constants.
+  struct PushConstants {
+    hermes::geo::Transform mvp;
+    f32 eye[4];
+    VkDeviceAddress meshlets;
+    VkDeviceAddress indices;
+    VkDeviceAddress output_indices;
+    VkDeviceAddress draw_command;
+    u32 meshlet_count;
+    u32 short_indices; //< 16-bit input indices
+  };
+
+  VeResult createPipeline(VkDevice vk_device);
+
+  hermes::geo::Transform proj_view_;
+  hermes::geo::point3 eye_;
+  std::vector<CullObject> objects_;
+  /// per object draw commands (first index is the object output range)
+  std::vector<VkDrawIndexedIndirectCommand> draw_commands_;
+  u32 output_index_count_{0};
+
+  ComputePipeline pipeline_;
+  Pipeline::Layout pipeline_layout_;
+  mem::AllocatedBuffer indices_;
+  mem::AllocatedBuffer draw_commands_buffer_;
+};
+
+} // namespace venus::pipeline
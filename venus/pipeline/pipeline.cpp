@@ -217,11 +217,13 @@ GraphicsPipeline::VertexInput GraphicsPipeline::VertexInput::fromVertexLayout(
   GraphicsPipeline::VertexInput info;
   const auto &components = vertex_layout.components();
   for (u32 location = 0; location < components.size(); ++location) {
-    info.addAttributeDescription(location, binding, components[location].format,
-                                 components[location].offset);
+    info.addAttributeDescription(
+        location, binding + components[location].stream,
+        components[location].format, components[location].offset);
   }
-  if (!vertex_layout.components().empty())
-    info.addBindingDescription(0, vertex_layout.stride(),
+  // each stream is bound to its own (consecutive) binding
+  for (u32 stream = 0; stream < vertex_layout.streamCount(); ++stream)
+    info.addBindingDescription(binding + stream, vertex_layout.stride(stream),
                                VK_VERTEX_INPUT_RATE_VERTEX);
   return info;
 }
@@ -337,6 +339,17 @@ GraphicsPipeline::ColorBlend GraphicsPipeline::ColorBlend::additive() {
   return blend;
 }
 
+GraphicsPipeline::ColorBlend
+GraphicsPipeline::ColorBlend::noColorWrites(u32 attachment_count) {
+  VkPipelineColorBlendAttachmentState attachment{};
+  attachment.colorWriteMask = 0;
+  attachment.blendEnable = VK_FALSE;
+
+  GraphicsPipeline::ColorBlend blend;
+  blend.color_blend_attachments_.assign(attachment_count, attachment);
+  return blend;
+}
+
 GraphicsPipeline::ColorBlend GraphicsPipeline::ColorBlend::alphaBlend() {
   VkPipelineColorBlendAttachmentState attachment{};
   attachment.colorWriteMask =
@@ -524,6 +537,23 @@ GraphicsPipeline::Config::setDepthFormat(VkFormat format) {
   return *this;
 }
 
+GraphicsPipeline::Config &GraphicsPipeline::Config::setColorAttachmentFormats(
+    const std::vector<VkFormat> &formats) {
+  color_attachment_formats_ = formats;
+  return *this;
+}
+
+GraphicsPipeline::Config &GraphicsPipeline::Config::disableColorWrites() {
+  color_blend_ = GraphicsPipeline::ColorBlend::noColorWrites(
+      static_cast<u32>(color_attachment_formats_.size()));
+  return *this;
+}
+
+const std::vector<VkFormat> &
+GraphicsPipeline::Config::colorAttachmentFormats() const {
+  return color_attachment_formats_;
+}
+
 GraphicsPipeline::Config &GraphicsPipeline::Config::setViewportAndDynamicStates(
     const VkExtent2D &extent) {
   dynamic_states_.clear();
@@ -666,6 +696,30 @@ RayTracingPipeline::Config::addShaderGroup(const ShaderGroup &shader_group) {
   return *this;
 }
 
+Result<ComputePipeline>
+ComputePipeline::Config::build(VkDevice vk_device,
+                               VkPipelineLayout vk_pipeline_layout) const {
+  if (stages_.empty()) {
+    HERMES_ERROR("Compute pipeline requires a shader stage.");
+    return VeResult::inputError();
+  }
+
+  VkComputePipelineCreateInfo compute_pipeline_create_info{};
+  compute_pipeline_create_info.sType =
+      VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+  compute_pipeline_create_info.stage = stages_[0];
+  compute_pipeline_create_info.layout = vk_pipeline_layout;
+
+  ComputePipeline pipeline;
+  pipeline.vk_device_ = vk_device;
+
+  VENUS_VK_RETURN_BAD_RESULT(vkCreateComputePipelines(
+      vk_device, VK_NULL_HANDLE, 1, &compute_pipeline_create_info, nullptr,
+      &pipeline.vk_pipeline_));
+
+  return Result<ComputePipeline>(std::move(pipeline));
+}
+
 Result<RayTracingPipeline>
 RayTracingPipeline::Config::build(VkDevice vk_device,
                                   VkPipelineLayout vk_pipeline_layout) const {
@@ -166,7 +166,15 @@ VENUS_DEFINE_SETUP_METHOD(Pipeline, addShaderStage,
                           stages_.emplace_back(value))
 
 /// Specialized pipeline for compute.
-class ComputePipeline : public Pipeline {};
+class ComputePipeline : public Pipeline {
+public:
+  /// Builder for ComputePipeline
+  /// \note The pipeline uses the first (compute) shader stage.
+  struct Config : public Pipeline::Setup<Config> {
+    Result<ComputePipeline> build(VkDevice vk_device,
+                                  VkPipelineLayout vk_pipeline_layout) const;
+  };
+};
 
 /// Specialized pipeline for graphics.
 class GraphicsPipeline : public Pipeline {
@@ -185,6 +193,7 @@ public:
     VertexInput &addAttributeDescription(u32 location, u32 binding,
                                          VkFormat format, u32 offset);
     /// \brief Create an info from a given vertex layout.
+    /// \note Each vertex stream uses its own binding, starting at binding.
     /// \param vertex_layout
     /// \param binding
     HERMES_NODISCARD static VertexInput
@@ -258,6 +267,9 @@ public:
     static ColorBlend none();
     static ColorBlend additive();
     static ColorBlend alphaBlend();
+    /// Keeps color attachments without writing them (zero color write mask).
+    /// \param attachment_count [def=1]
+    static ColorBlend noColorWrites(u32 attachment_count = 1);
 
     ColorBlend() noexcept;
     /// \param op Logical operation.
@@ -344,8 +356,15 @@ public:
 
     /// \param format Attachment color format.
     Config &setColorAttachmentFormat(VkFormat format);
+    /// \param formats Attachment color formats.
+    Config &setColorAttachmentFormats(const std::vector<VkFormat> &formats);
     /// \param format Depth format.
     Config &setDepthFormat(VkFormat format);
+    /// \brief Keeps the color attachments without writing them, so depth only
+    ///        pipelines can draw within color rendering.
+    Config &disableColorWrites();
+    /// \return Attachment color formats.
+    const std::vector<VkFormat> &colorAttachmentFormats() const;
 
     // depth test
 
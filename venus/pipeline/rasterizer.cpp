@@ -26,29 +26,148 @@
 
 #include <venus/pipeline/rasterizer.h>
 
+#include <algorithm>
+#include <cstring>
+
 namespace venus::pipeline {
 
+// vkCmdUpdateBuffer limit (in bytes)
+static constexpr VkDeviceSize k_max_update_size = 65536;
+
+static u64 mixBits(u64 x) {
+  // splitmix64 finalizer
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ull;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebull;
+  x ^= x >> 31;
+  return x;
+}
+
+static u64 descriptorSetsHash(const DescriptorSetBindings &bindings) {
+  u64 hash = 0;
+  for (u32 r = 0; r < bindings.range_count; ++r) {
+    const auto &range = bindings.ranges[r];
+    hash = mixBits(hash ^ range.first_set);
+    for (u32 i = 0; i < range.count; ++i)
+      hash = mixBits(hash ^ (u64)bindings.descriptor_sets[range.offset + i]);
+  }
+  return hash;
+}
+
+static bool sameBindings(const DescriptorSetBindings &a,
+                         const DescriptorSetBindings &b) {
+  if (a.set_count != b.set_count || a.range_count != b.range_count)
+    return false;
+  for (u32 i = 0; i < a.set_count; ++i)
+    if (a.descriptor_sets[i] != b.descriptor_sets[i])
+      return false;
+  for (u32 r = 0; r < a.range_count; ++r)
+    if (a.ranges[r].first_set != b.ranges[r].first_set ||
+        a.ranges[r].count != b.ranges[r].count)
+      return false;
+  return true;
+}
+
+// Dense id (in order of first appearance) of the given hash.
+static u64 denseId(std::unordered_map<u64, u64> &ids, u64 hash) {
+  return ids.emplace(hash, ids.size()).first->second;
+}
+
+// \return true if the value fits the field (left out fields take any value).
+static bool fitsField(u64 value, u8 bits) {
+  return !bits || bits >= 64 || value < (1ull << bits);
+}
+
+// Appends a field to the key, saturating values that do not fit.
+static u64 packField(u64 key, u64 value, u8 bits) {
+  if (!bits)
+    return key;
+  const u64 max_value = bits >= 64 ? ~0ull : (1ull << bits) - 1;
+  return (bits >= 64 ? 0 : key << bits) | std::min(value, max_value);
+}
+
+static u64 depthField(f32 depth, u8 bits, bool back_to_front) {
+  if (!bits)
+    return 0;
+  // bits of non negative floats are ordered as their values
+  depth = depth > 0.f ? depth : 0.f;
+  u32 depth_bits = 0;
+  std::memcpy(&depth_bits, &depth, sizeof(depth_bits));
+  const u8 used_bits = std::min<u8>(bits, 32);
+  u64 field = depth_bits >> (32 - used_bits);
+  if (back_to_front)
+    field ^= (1ull << used_bits) - 1;
+  return field;
+}
+
+// Extends the [first, end) range to hold the index.
+static void extendRange(std::pair<u32, u32> &range, u32 index) {
+  if (range.first == range.second)
+    range = {index, index + 1};
+  else
+    range = {std::min(range.first, index), std::max(range.second, index + 1)};
+}
+
+// Compares all object data but the push constants range, the transform and
+// the depth (see Rasterizer::updateTransform).
+static bool sameObject(const Rasterizer::RasterObject &a,
+                       const Rasterizer::RasterObject &b) {
+  return a.count == b.count && a.first_index == b.first_index &&
+         a.index_buffer == b.index_buffer && a.index_type == b.index_type &&
+         a.vertex_buffer == b.vertex_buffer &&
+         a.indirect_buffer == b.indirect_buffer &&
+         a.indirect_offset == b.indirect_offset &&
+         a.push_constants_stage_flags == b.push_constants_stage_flags &&
+         a.pass == b.pass &&
+         !std::memcmp(&a.bounds, &b.bounds, sizeof(a.bounds)) &&
+         sameBindings(a.descriptor_sets, b.descriptor_sets);
+}
+
+// Compares the object data packed into sort keys (but the material and the
+// depth).
+static bool sameSortFields(const Rasterizer::RasterObject &a,
+                           const Rasterizer::RasterObject &b) {
+  return a.pass == b.pass && a.vertex_buffer == b.vertex_buffer &&
+         a.index_buffer == b.index_buffer && a.first_index == b.first_index &&
+         a.count == b.count &&
+         sameBindings(a.descriptor_sets, b.descriptor_sets);
+}
+
 VENUS_DEFINE_SET_FIELD_METHOD(Rasterizer, setClearColor,
                               const VkClearColorValue &, clear_color_ = value)
 VENUS_DEFINE_SET_FIELD_METHOD(Rasterizer, setRenderArea, const VkExtent2D &,
                               render_area_ = value)
 
+Rasterizer &Rasterizer::setInstanceBuffer(const mem::Buffer &buffer) {
+  instance_buffer_ = &buffer;
+  upload_all_instances_ = true;
+  return *this;
+}
+
 Rasterizer &Rasterizer::setDynamicRendering() {
   use_dynamic_rendering_ = true;
   return *this;
 }
 
-Rasterizer &Rasterizer::add(const Rasterizer::RasterObject &object,
-                            const Rasterizer::RasterMaterial &material) {
+Rasterizer &Rasterizer::setSortKeyLayout(const SortKeyLayout &layout) {
+  sort_key_layout_ = layout;
+  // all keys change
+  sorted_ = false;
+  key_saturation_reported_ = false;
+  return *this;
+}
 
-  // cache material
+h_index Rasterizer::materialId(const RasterMaterial &material) {
   h_index material_id = materials_.size();
   auto pipeline_item = material_indices_.find(material.vk_pipeline);
   if (pipeline_item != material_indices_.end()) {
     auto layout_item = pipeline_item->second.find(material.vk_pipeline_layout);
-    if (layout_item != pipeline_item->second.end())
+    if (layout_item != pipeline_item->second.end()) {
+      // bindings may change between frames, the latest ones are kept
       material_id = layout_item->second;
-    else {
+      materials_[material_id] = material;
+    } else {
       pipeline_item->second[material.vk_pipeline_layout] = materials_.size();
       materials_.emplace_back(material);
     }
@@ -58,87 +177,605 @@ Rasterizer &Rasterizer::add(const Rasterizer::RasterObject &object,
         materials_.size();
     materials_.emplace_back(material);
   }
-  // cache object
-  objects_.push_back(std::make_pair(object, material_id));
+  return material_id;
+}
+
+void Rasterizer::storePushConstants(u32 object, const void *push_constants,
+                                    u32 push_constants_size) {
+  auto &cached_object = objects_[object].object;
+  const u32 size = push_constants ? push_constants_size : 0;
+  if (size != cached_object.push_constants_size) {
+    unused_push_constants_size_ += cached_object.push_constants_size;
+    cached_object.push_constants_offset =
+        static_cast<u32>(push_constants_.size());
+    cached_object.push_constants_size = size;
+    push_constants_.resize(push_constants_.size() + size);
+  }
+  if (size)
+    std::memcpy(push_constants_.data() + cached_object.push_constants_offset,
+                push_constants, size);
+  if (unused_push_constants_size_ > push_constants_.size() / 2)
+    compactPushConstants();
+}
+
+void Rasterizer::compactPushConstants() {
+  std::vector<u8> push_constants;
+  push_constants.reserve(push_constants_.size() - unused_push_constants_size_);
+  for (auto &slot : objects_) {
+    if (!slot.live || !slot.object.push_constants_size)
+      continue;
+    const u8 *bytes =
+        push_constants_.data() + slot.object.push_constants_offset;
+    slot.object.push_constants_offset = static_cast<u32>(push_constants.size());
+    push_constants.insert(push_constants.end(), bytes,
+                          bytes + slot.object.push_constants_size);
+  }
+  push_constants_.swap(push_constants);
+  unused_push_constants_size_ = 0;
+}
+
+void Rasterizer::markSortPending(u32 object) {
+  if (objects_[object].sort_pending)
+    return;
+  objects_[object].sort_pending = true;
+  sort_pending_.emplace_back(object);
+}
+
+void Rasterizer::invalidateDraws() {
+  draws_.clear();
+  instance_transforms_.clear();
+  changed_instances_ = {0, 0};
+  draw_culler_ = nullptr;
+  draw_mode_ = DrawMode::OBJECTS;
+}
+
+h_index Rasterizer::insert(const Rasterizer::RasterObject &object,
+                           const Rasterizer::RasterMaterial &material,
+                           const void *push_constants,
+                           u32 push_constants_size) {
+  u32 id = static_cast<u32>(objects_.size());
+  if (!free_objects_.empty()) {
+    id = free_objects_.back();
+    free_objects_.pop_back();
+  } else
+    objects_.emplace_back();
+  auto &slot = objects_[id];
+  slot.object = object;
+  slot.object.push_constants_offset = 0;
+  slot.object.push_constants_size = 0;
+  slot.material = materialId(material);
+  slot.live = true;
+  if (material.vk_depth_pipeline)
+    ++depth_prepass_objects_;
+  storePushConstants(id, push_constants, push_constants_size);
+  // drawn last until sorted
+  draw_order_.emplace_back(id);
+  markSortPending(id);
+  invalidateDraws();
+  return id;
+}
+
+Rasterizer &Rasterizer::add(const Rasterizer::RasterObject &object,
+                            const Rasterizer::RasterMaterial &material,
+                            const void *push_constants,
+                            u32 push_constants_size) {
+  insert(object, material, push_constants, push_constants_size);
+  return *this;
+}
+
+Rasterizer &Rasterizer::update(h_index id,
+                               const Rasterizer::RasterObject &object,
+                               const Rasterizer::RasterMaterial &material,
+                               const void *push_constants,
+                               u32 push_constants_size) {
+  HERMES_ASSERT(id < objects_.size() && objects_[id].live);
+  auto &slot = objects_[id];
+  const h_index material_id = materialId(material);
+  const u32 size = push_constants ? push_constants_size : 0;
+  const bool same_push_constants =
+      size == slot.object.push_constants_size &&
+      (!size ||
+       !std::memcmp(push_constants_.data() + slot.object.push_constants_offset,
+                    push_constants, size));
+  const bool same_key =
+      material_id == slot.material && sameSortFields(slot.object, object);
+  // push constants of objects drawn alone are patched in place
+  const bool standalone =
+      draw_mode_ == DrawMode::OBJECTS ||
+      (draw_mode_ == DrawMode::CULLED && !slot.culled);
+  if (same_key && sameObject(slot.object, object) &&
+      (same_push_constants ||
+       (standalone && size == slot.object.push_constants_size))) {
+    if (!same_push_constants)
+      storePushConstants(id, push_constants, push_constants_size);
+    return updateTransform(id, object.transform, object.depth);
+  }
+
+  const bool depth_key_changed = depthKeyChanged(slot.object, object.depth);
+  const u32 push_constants_offset = slot.object.push_constants_offset;
+  const u32 current_push_constants_size = slot.object.push_constants_size;
+  slot.object = object;
+  slot.object.push_constants_offset = push_constants_offset;
+  slot.object.push_constants_size = current_push_constants_size;
+  if (materials_[slot.material].vk_depth_pipeline)
+    --depth_prepass_objects_;
+  if (material.vk_depth_pipeline)
+    ++depth_prepass_objects_;
+  slot.material = material_id;
+  if (!same_push_constants)
+    storePushConstants(id, push_constants, push_constants_size);
+  if (!same_key || depth_key_changed)
+    markSortPending(id);
+  invalidateDraws();
+  return *this;
+}
+
+Rasterizer &Rasterizer::updateTransform(h_index id,
+                                        const hermes::geo::Transform &transform,
+                                        f32 depth) {
+  HERMES_ASSERT(id < objects_.size() && objects_[id].live);
+  auto &slot = objects_[id];
+  if (depthKeyChanged(slot.object, depth))
+    markSortPending(id);
+  slot.object.depth = depth;
+  if (!std::memcmp(&transform, &slot.object.transform, sizeof(transform)))
+    return *this;
+  slot.object.transform = transform;
+  // instanced draws and culled buckets keep their objects, only the instance
+  // transforms change
+  if (draw_mode_ == DrawMode::INSTANCED) {
+    instance_transforms_[slot.instance] =
+        hermes::math::transpose(transform.matrix());
+    extendRange(changed_instances_, slot.instance);
+  } else if (draw_mode_ == DrawMode::CULLED && slot.culled)
+    draw_culler_->setTransform(slot.instance, transform);
+  return *this;
+}
+
+Rasterizer &Rasterizer::remove(h_index id) {
+  HERMES_ASSERT(id < objects_.size() && objects_[id].live);
+  auto &slot = objects_[id];
+  slot.live = false;
+  if (materials_[slot.material].vk_depth_pipeline)
+    --depth_prepass_objects_;
+  unused_push_constants_size_ += slot.object.push_constants_size;
+  slot.object.push_constants_size = 0;
+  if (unused_push_constants_size_ > push_constants_.size() / 2)
+    compactPushConstants();
+  // dropped from the draw order (and freed) by the next sort
+  removed_objects_.emplace_back(static_cast<u32>(id));
+  markSortPending(id);
+  invalidateDraws();
+  return *this;
+}
+
+Rasterizer &Rasterizer::clear() {
+  material_indices_.clear();
+  materials_.clear();
+  objects_.clear();
+  free_objects_.clear();
+  removed_objects_.clear();
+  push_constants_.clear();
+  unused_push_constants_size_ = 0;
+  draw_order_.clear();
+  sort_items_.clear();
+  sort_pending_.clear();
+  material_ids_.clear();
+  mesh_ids_.clear();
+  sorted_ = false;
+  depth_prepass_objects_ = 0;
+  key_saturation_reported_ = false;
+  invalidateDraws();
+  instance_upload_ = {0, 0};
+  upload_all_instances_ = true;
   return *this;
 }
 
+h_size Rasterizer::objectCount() const {
+  return draw_order_.size() - removed_objects_.size();
+}
+
+u64 Rasterizer::sortKey(u32 object_index) {
+  const auto &layout = sort_key_layout_;
+  const auto &object = objects_[object_index].object;
+  const bool back_to_front = backToFront(object.pass);
+  const u64 depth = depthField(object.depth, layout.depth_bits, back_to_front);
+  u64 key = packField(0, object.pass, layout.pass_bits);
+  // blending order comes before state
+  if (back_to_front)
+    key = packField(key, depth, layout.depth_bits);
+  const u64 pipeline_id = objects_[object_index].material;
+  key = packField(key, pipeline_id, layout.pipeline_bits);
+  // dense ids keep the fields small
+  const u64 material_id =
+      denseId(material_ids_, descriptorSetsHash(object.descriptor_sets));
+  key = packField(key, material_id, layout.material_bits);
+  // index ranges keep instances of the same mesh together
+  u64 mesh_hash = mixBits((u64)object.vertex_buffer) ^ (u64)object.index_buffer;
+  mesh_hash = mixBits(mesh_hash ^ object.first_index);
+  mesh_hash = mixBits(mesh_hash ^ object.count);
+  const u64 mesh_id = denseId(mesh_ids_, mesh_hash);
+  key = packField(key, mesh_id, layout.mesh_bits);
+  if (!key_saturation_reported_ &&
+      (!fitsField(pipeline_id, layout.pipeline_bits) ||
+       !fitsField(material_id, layout.material_bits) ||
+       !fitsField(mesh_id, layout.mesh_bits))) {
+    HERMES_WARN("Raster sort key ids exceed their fields (pipeline {}, "
+                "material {}, mesh {}), states sharing the saturated ids are "
+                "no longer grouped.",
+                pipeline_id, material_id, mesh_id);
+    key_saturation_reported_ = true;
+  }
+  if (!back_to_front)
+    key = packField(key, depth, layout.depth_bits);
+  return key;
+}
+
 Rasterizer &Rasterizer::sortObjects() {
-  std::sort(objects_.begin(), objects_.end(),
-            [](const auto &a, const auto &b) { return a.second < b.second; });
+  const auto &layout = sort_key_layout_;
+  HERMES_ASSERT(layout.pass_bits + layout.pipeline_bits +
+                    layout.material_bits + layout.mesh_bits +
+                    layout.depth_bits <=
+                64);
+
+  // the order is kept while objects don't change
+  if (sorted_ && sort_pending_.empty())
+    return *this;
+
+  // dense ids of removed and changed objects are only dropped by full sorts,
+  // which also run once ids outnumber objects
+  const bool stale_ids = material_ids_.size() > 2 * draw_order_.size() ||
+                         mesh_ids_.size() > 2 * draw_order_.size();
+  if (!sorted_ || stale_ids || sort_pending_.size() * 2 > draw_order_.size()) {
+    // all keys are computed again
+    material_ids_.clear();
+    mesh_ids_.clear();
+    sort_items_.clear();
+    for (u32 object : draw_order_)
+      if (objects_[object].live)
+        sort_items_.push_back({sortKey(object), object});
+    radixSort(sort_items_, sort_scratch_);
+  } else {
+    // unchanged objects keep their keys and order, changed objects are
+    // sorted apart and merged into them
+    h_size kept_count = 0;
+    for (const auto &item : sort_items_)
+      if (objects_[item.object].live && !objects_[item.object].sort_pending)
+        sort_items_[kept_count++] = item;
+    sort_items_.resize(kept_count);
+    for (u32 object : sort_pending_)
+      if (objects_[object].live)
+        sort_items_.push_back({sortKey(object), object});
+    auto by_key = [](const SortItem &a, const SortItem &b) {
+      return a.key < b.key;
+    };
+    std::stable_sort(sort_items_.begin() + kept_count, sort_items_.end(),
+                     by_key);
+    std::inplace_merge(sort_items_.begin(), sort_items_.begin() + kept_count,
+                       sort_items_.end(), by_key);
+  }
+  for (u32 object : sort_pending_)
+    objects_[object].sort_pending = false;
+  sort_pending_.clear();
+  sorted_ = true;
+  // removed objects are out of the draw order
+  free_objects_.insert(free_objects_.end(), removed_objects_.begin(),
+                       removed_objects_.end());
+  removed_objects_.clear();
+
+  // draws are kept while the order is the same
+  bool reordered = sort_items_.size() != draw_order_.size();
+  draw_order_.resize(sort_items_.size());
+  for (h_index i = 0; i < sort_items_.size(); ++i) {
+    if (draw_order_[i] == sort_items_[i].object)
+      continue;
+    draw_order_[i] = sort_items_[i].object;
+    reordered = true;
+  }
+  if (reordered)
+    invalidateDraws();
+  return *this;
+}
+
+Rasterizer &Rasterizer::instanceObjects() {
+  // the merge is kept while objects don't change, patched transforms are
+  // uploaded alone
+  if (draw_mode_ == DrawMode::INSTANCED) {
+    instance_upload_ = changed_instances_;
+    if (upload_all_instances_)
+      instance_upload_ = {0, static_cast<u32>(instance_transforms_.size())};
+    changed_instances_ = {0, 0};
+    upload_all_instances_ = false;
+    return *this;
+  }
+  invalidateDraws();
+  for (u32 object : draw_order_) {
+    if (!objects_[object].live)
+      continue;
+    if (!draws_.empty() && sameDraw(draws_.back().object, object))
+      ++draws_.back().instance_count;
+    else {
+      Draw draw;
+      draw.object = object;
+      draw.first_instance = static_cast<u32>(instance_transforms_.size());
+      draws_.emplace_back(draw);
+    }
+    objects_[object].instance = static_cast<u32>(instance_transforms_.size());
+    instance_transforms_.emplace_back(
+        hermes::math::transpose(objects_[object].object.transform.matrix()));
+  }
+  draw_mode_ = DrawMode::INSTANCED;
+  instance_upload_ = {0, static_cast<u32>(instance_transforms_.size())};
+  upload_all_instances_ = false;
   return *this;
 }
 
+void Rasterizer::radixSort(std::vector<SortItem> &items,
+                           std::vector<SortItem> &scratch) {
+  if (items.size() < 2)
+    return;
+  scratch.resize(items.size());
+  for (u32 shift = 0; shift < 64; shift += 8) {
+    h_size offsets[256] = {};
+    for (const auto &item : items)
+      ++offsets[(item.key >> shift) & 0xff];
+    // all items share this digit
+    if (offsets[(items[0].key >> shift) & 0xff] == items.size())
+      continue;
+    h_size offset = 0;
+    for (auto &count : offsets) {
+      h_size digit_count = count;
+      count = offset;
+      offset += digit_count;
+    }
+    for (const auto &item : items)
+      scratch[offsets[(item.key >> shift) & 0xff]++] = item;
+    items.swap(scratch);
+  }
+}
+
+bool Rasterizer::backToFront(u32 pass) const {
+  return pass < 32 && (sort_key_layout_.back_to_front_passes >> pass) & 1u;
+}
+
+bool Rasterizer::depthKeyChanged(const RasterObject &object, f32 depth) const {
+  const auto &layout = sort_key_layout_;
+  // blending needs the exact order, front to back objects a coarse one
+  const u8 bits =
+      backToFront(object.pass)
+          ? layout.depth_bits
+          : std::min(layout.depth_bits, layout.front_to_back_resort_bits);
+  return depthField(object.depth, bits, false) !=
+         depthField(depth, bits, false);
+}
+
+bool Rasterizer::sameState(u32 a, u32 b) const {
+  if (objects_[a].material != objects_[b].material)
+    return false;
+  const auto &x = objects_[a].object;
+  const auto &y = objects_[b].object;
+  if (x.index_buffer != y.index_buffer || x.index_type != y.index_type ||
+      x.vertex_buffer != y.vertex_buffer || x.pass != y.pass)
+    return false;
+  if (!sameBindings(x.descriptor_sets, y.descriptor_sets))
+    return false;
+  if (x.push_constants_size != y.push_constants_size ||
+      x.push_constants_stage_flags != y.push_constants_stage_flags)
+    return false;
+  return !x.push_constants_size ||
+         !std::memcmp(push_constants_.data() + x.push_constants_offset,
+                      push_constants_.data() + y.push_constants_offset,
+                      x.push_constants_size);
+}
+
+bool Rasterizer::sameDraw(u32 a, u32 b) const {
+  const auto &x = objects_[a].object;
+  const auto &y = objects_[b].object;
+  if (x.indirect_buffer || y.indirect_buffer)
+    return false;
+  return x.count == y.count && x.first_index == y.first_index &&
+         sameState(a, b);
+}
+
+Rasterizer &Rasterizer::cullObjects(DrawCuller &culler) {
+  // buckets are kept while objects don't change
+  if (draw_mode_ == DrawMode::CULLED && draw_culler_ == &culler)
+    return *this;
+  culler.clear();
+  invalidateDraws();
+  draw_culler_ = &culler;
+  draw_mode_ = DrawMode::CULLED;
+  // state hash -> draws of buckets with that hash
+  std::unordered_map<u64, std::vector<h_index>> bucket_draws;
+  u32 bucket_count = 0;
+  for (u32 object_index : draw_order_) {
+    auto &slot = objects_[object_index];
+    if (!slot.live)
+      continue;
+    const auto &object = slot.object;
+    slot.culled = false;
+    Draw draw;
+    draw.object = object_index;
+    // culled draws are unordered
+    if (!object.index_buffer || object.indirect_buffer ||
+        backToFront(object.pass)) {
+      draws_.emplace_back(draw);
+      continue;
+    }
+    u64 hash = mixBits(objects_[object_index].material);
+    hash = mixBits(hash ^ descriptorSetsHash(object.descriptor_sets));
+    hash = mixBits(hash ^ (u64)object.vertex_buffer);
+    hash = mixBits(hash ^ (u64)object.index_buffer);
+    hash = mixBits(hash ^ object.push_constants_size);
+    auto &candidates = bucket_draws[hash];
+    std::optional<u32> bucket;
+    for (h_index d : candidates)
+      if (sameState(draws_[d].object, object_index)) {
+        bucket = draws_[d].bucket;
+        break;
+      }
+    if (!bucket.has_value()) {
+      bucket = bucket_count++;
+      draw.bucket = bucket;
+      candidates.emplace_back(draws_.size());
+      draws_.emplace_back(draw);
+    }
+    DrawCuller::DrawObject draw_object;
+    draw_object.model = object.transform;
+    draw_object.bounds = object.bounds;
+    draw_object.index_count = object.count;
+    draw_object.first_index = object.first_index;
+    draw_object.bucket = *bucket;
+    slot.culled = true;
+    slot.instance = static_cast<u32>(culler.add(draw_object));
+  }
+  return *this;
+}
+
+VeResult Rasterizer::uploadInstances(const CommandBuffer &cb) const {
+  const u32 upload_end = std::min(
+      instance_upload_.second, static_cast<u32>(instance_transforms_.size()));
+  if (instance_upload_.first >= upload_end)
+    return VeResult::noError();
+  VkDeviceSize size =
+      sizeof(hermes::geo::Transform) * instance_transforms_.size();
+  if (!instance_buffer_ || instance_buffer_->sizeInBytes() < size) {
+    HERMES_ERROR("Instance buffer can't hold {} instances.",
+                 instance_transforms_.size());
+    return VeResult::outOfBounds();
+  }
+
+  // previous draws may still read the instance data
+  cb.memoryBarrier(VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT, VK_ACCESS_2_NONE,
+                   VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_NONE);
+
+  // only instances changed since the last upload
+  const auto *data = reinterpret_cast<const u8 *>(instance_transforms_.data());
+  const VkDeviceSize upload_size = sizeof(hermes::geo::Transform) * upload_end;
+  for (VkDeviceSize offset =
+           sizeof(hermes::geo::Transform) * instance_upload_.first;
+       offset < upload_size; offset += k_max_update_size)
+    cb.update(*instance_buffer_, data + offset, offset,
+              std::min(k_max_update_size, upload_size - offset));
+
+  cb.memoryBarrier(VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                   VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                   VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT,
+                   VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+  return VeResult::noError();
+}
+
 VeResult Rasterizer::record(const CommandBuffer &cb,
                             const mem::Image::Handle &color_image,
                             const mem::Image::Handle &depth_image) const {
-  // clear screen
-  VkClearValue clear_value = {};
-  clear_value.color = clear_color_;
-  VkImageSubresourceRange image_range = {};
-  image_range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-  image_range.levelCount = 1;
-  image_range.layerCount = 1;
-  std::vector<VkImageSubresourceRange> ranges;
-  ranges.emplace_back(image_range);
+  // instance data is written outside of rendering
+  VENUS_RETURN_BAD_RESULT(uploadInstances(cb));
 
+  // attachments are cleared by the load ops of their first pass
   cb.transitionImage(color_image.image, VK_IMAGE_LAYOUT_UNDEFINED,
-                     VK_IMAGE_LAYOUT_GENERAL);
-
-  cb.clear(color_image.image, VK_IMAGE_LAYOUT_GENERAL, ranges, clear_color_);
-
-  cb.transitionImage(color_image.image, VK_IMAGE_LAYOUT_GENERAL,
                      VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
 
   cb.transitionImage(depth_image.image, VK_IMAGE_LAYOUT_UNDEFINED,
                      VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL);
 
-  VkClearValue depth_clear;
+  // occlusion culled draws (see DrawCuller::setDepthPyramid) are drawn in a
+  // second pass, after the pyramid is built from the depth of the first
+  const DepthPyramid *depth_pyramid =
+      draw_culler_ ? draw_culler_->depthPyramid() : nullptr;
+  const bool depth_prepass = depth_prepass_objects_ != 0;
+
+  VkClearValue color_clear = {};
+  color_clear.color = clear_color_;
+  VkClearValue depth_clear = {};
   depth_clear.depthStencil.depth = 0.f;
-  auto rendering_info =
-      pipeline::CommandBuffer::RenderingInfo()
-          .setLayerCount(1)
-          .setRenderArea({VkOffset2D{0, 0}, render_area_})
-          .addColorAttachment(
-              pipeline::CommandBuffer::RenderingInfo::Attachment()
-                  .setImageLayout(VK_IMAGE_LAYOUT_ATTACHMENT_OPTIMAL)
-                  .setImageView(color_image.view)
-                  .setStoreOp(VK_ATTACHMENT_STORE_OP_STORE)
-                  .setLoadOp(VK_ATTACHMENT_LOAD_OP_LOAD))
-          .setDepthAttachment(
-              pipeline::CommandBuffer::RenderingInfo::Attachment()
-                  .setImageLayout(VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL)
-                  .setImageView(depth_image.view)
-                  .setStoreOp(VK_ATTACHMENT_STORE_OP_STORE)
-                  .setLoadOp(VK_ATTACHMENT_LOAD_OP_CLEAR)
-                  .setClearValue(depth_clear));
-
-  cb.beginRendering(*rendering_info);
-
-  VENUS_RETURN_BAD_RESULT(draw(cb));
-
-  cb.endRendering();
+  auto color_attachment =
+      pipeline::CommandBuffer::RenderingInfo::Attachment()
+          .setImageLayout(VK_IMAGE_LAYOUT_ATTACHMENT_OPTIMAL)
+          .setImageView(color_image.view)
+          .setStoreOp(VK_ATTACHMENT_STORE_OP_STORE)
+          .setClearValue(color_clear);
+  auto depth_attachment =
+      pipeline::CommandBuffer::RenderingInfo::Attachment()
+          .setImageLayout(VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL)
+          .setImageView(depth_image.view)
+          .setClearValue(depth_clear);
+
+  const u32 phase_count = depth_pyramid ? 2 : 1;
+  for (u32 phase = 0; phase < phase_count; ++phase) {
+    if (phase) {
+      VENUS_RETURN_BAD_RESULT(depth_pyramid->record(cb, depth_image.image));
+      VENUS_RETURN_BAD_RESULT(draw_culler_->recordOcclusion(cb));
+    }
+
+    // attachments are cleared by the first pass, depth is only stored for
+    // the depth pyramid
+    color_attachment.setLoadOp(phase ? VK_ATTACHMENT_LOAD_OP_LOAD
+                                     : VK_ATTACHMENT_LOAD_OP_CLEAR);
+    depth_attachment
+        .setStoreOp(depth_pyramid && !phase ? VK_ATTACHMENT_STORE_OP_STORE
+                                            : VK_ATTACHMENT_STORE_OP_DONT_CARE)
+        .setLoadOp(phase ? VK_ATTACHMENT_LOAD_OP_LOAD
+                         : VK_ATTACHMENT_LOAD_OP_CLEAR);
+    auto rendering_info = pipeline::CommandBuffer::RenderingInfo()
+                              .setLayerCount(1)
+                              .setRenderArea({VkOffset2D{0, 0}, render_area_})
+                              .addColorAttachment(color_attachment)
+                              .setDepthAttachment(depth_attachment);
+
+    cb.beginRendering(*rendering_info);
+
+    // prepass depth writes reach the shading draws in rasterization order,
+    // without leaving the attachment
+    if (depth_prepass)
+      VENUS_RETURN_BAD_RESULT(draw(cb, phase, true));
+    VENUS_RETURN_BAD_RESULT(draw(cb, phase, false));
+
+    cb.endRendering();
+  }
 
   return VeResult::noError();
 }
 
-VeResult Rasterizer::draw(const CommandBuffer &cb) const {
+VeResult Rasterizer::draw(const CommandBuffer &cb, u32 phase,
+                          bool depth_prepass) const {
   // cache
   VkPipeline last_pipeline = nullptr;
   VkBuffer last_index_buffer = nullptr;
+  VkIndexType last_index_type = VK_INDEX_TYPE_UINT32;
   VkBuffer last_vertex_buffer = nullptr;
+  const DescriptorSetBindings *last_descriptor_sets = nullptr;
   h_index last_material = materials_.size();
+  const u32 last_phase = draw_culler_ && draw_culler_->depthPyramid() ? 1 : 0;
 
-  for (const auto &item : objects_) {
-    h_index material_id = item.second;
+  const h_size draw_count = draws_.empty() ? draw_order_.size() : draws_.size();
+  for (h_index i = 0; i < draw_count; ++i) {
+    Draw instances;
+    if (!draws_.empty())
+      instances = draws_[i];
+    else
+      instances.object = draw_order_[i];
+    const auto &item = objects_[instances.object];
+    // removed objects stay in the draw order until the next sort
+    if (!item.live)
+      continue;
+    h_index material_id = item.material;
     HERMES_ASSERT(material_id < materials_.size());
     const auto &material = materials_[material_id];
-    const auto &object = item.first;
+    const auto &object = item.object;
+    // the second occlusion culling phase only draws culled buckets, blended
+    // objects are drawn last (over all culled objects)
+    if (backToFront(object.pass) ? phase != last_phase
+                                 : phase && !instances.bucket.has_value())
+      continue;
+    if (depth_prepass && !material.vk_depth_pipeline)
+      continue;
     if (last_material != material_id) {
-      if (last_pipeline != material.vk_pipeline) {
-        last_pipeline = material.vk_pipeline;
+      VkPipeline vk_pipeline =
+          depth_prepass ? material.vk_depth_pipeline : material.vk_pipeline;
+      if (last_pipeline != vk_pipeline) {
+        last_pipeline = vk_pipeline;
         // bind pipeline
-        cb.bindPipeline(material.vk_pipeline, VK_PIPELINE_BIND_POINT_GRAPHICS);
+        cb.bindPipeline(vk_pipeline, VK_PIPELINE_BIND_POINT_GRAPHICS);
 
         cb.setViewport(static_cast<f32>(render_area_.width),
                        static_cast<f32>(render_area_.height), 0.f, 1.f);
@@ -146,40 +783,60 @@ VeResult Rasterizer::draw(const CommandBuffer &cb) const {
         cb.setScissor(0, 0, render_area_.width, render_area_.height);
 
         // bind global descriptor sets
-        for (const auto &ds_item : material.global_descriptor_sets)
-          cb.bind(VK_PIPELINE_BIND_POINT_GRAPHICS, material.vk_pipeline_layout,
-                  static_cast<u32>(ds_item.first), ds_item.second);
-      }
-      // bind material descriptor set
-      for (const auto &ds_item : object.descriptor_sets)
         cb.bind(VK_PIPELINE_BIND_POINT_GRAPHICS, material.vk_pipeline_layout,
-                static_cast<u32>(ds_item.first), ds_item.second);
+                material.global_descriptor_sets);
+      }
+      last_descriptor_sets = nullptr;
     }
 
     last_material = material_id;
 
+    // bind material descriptor sets (objects of a material may use different
+    // material instances)
+    if (!last_descriptor_sets ||
+        !sameBindings(*last_descriptor_sets, object.descriptor_sets)) {
+      last_descriptor_sets = &object.descriptor_sets;
+      cb.bind(VK_PIPELINE_BIND_POINT_GRAPHICS, material.vk_pipeline_layout,
+              object.descriptor_sets);
+    }
+
     if (object.vertex_buffer && object.vertex_buffer != last_vertex_buffer) {
       last_vertex_buffer = object.vertex_buffer;
       cb.bindVertexBuffers(0, {object.vertex_buffer}, {0});
     }
 
-    if (object.index_buffer && object.index_buffer != last_index_buffer) {
+    if (object.index_buffer && (object.index_buffer != last_index_buffer ||
+                                object.index_type != last_index_type)) {
       last_index_buffer = object.index_buffer;
-      cb.bindIndexBuffer(object.index_buffer, 0, VK_INDEX_TYPE_UINT32);
+      last_index_type = object.index_type;
+      cb.bindIndexBuffer(object.index_buffer, 0, object.index_type);
     }
 
     // push constants
-    if (object.push_constants.sizeInBytes()) {
+    if (object.push_constants_size) {
       cb.pushConstants(material.vk_pipeline_layout,
                        object.push_constants_stage_flags, 0,
-                       static_cast<u32>(object.push_constants.sizeInBytes()),
-                       object.push_constants.data());
+                       object.push_constants_size,
+                       push_constants_.data() + object.push_constants_offset);
     }
 
-    if (object.index_buffer != VK_NULL_HANDLE)
-      cb.drawIndexed(object.count, 1, object.first_index, 0, 0);
+    if (instances.bucket.has_value()) {
+      HERMES_ASSERT(draw_culler_);
+      const u32 bucket = *instances.bucket;
+      cb.drawIndexedIndirectCount(draw_culler_->drawBuffer(),
+                                  draw_culler_->drawOffset(bucket, phase),
+                                  draw_culler_->countBuffer(),
+                                  draw_culler_->countOffset(bucket, phase),
+                                  draw_culler_->maxDrawCount(bucket));
+    } else if (object.index_buffer != VK_NULL_HANDLE &&
+               object.indirect_buffer != VK_NULL_HANDLE)
+      cb.drawIndexedIndirect(object.indirect_buffer, object.indirect_offset);
+    else if (object.index_buffer != VK_NULL_HANDLE)
+      cb.drawIndexed(object.count, instances.instance_count,
+                     object.first_index, 0, instances.first_instance);
     else
-      cb.draw(object.count, 1, 0, 0);
+      cb.draw(object.count, instances.instance_count, 0,
+              instances.first_instance);
   }
 
   return VeResult::noError();
@@ -28,39 +28,82 @@
 #pragma once
 
 #include <venus/pipeline/command_buffer.h>
+#include <venus/pipeline/draw_culler.h>
 
-#include <hermes/storage/block.h>
+#include <hermes/geometry/transform.h>
+
+#include <optional>
 
 namespace venus::pipeline {
 
 /// \brief Rasterization pipeline
+/// \note Raster objects and materials are flat records (no heap memory), push
+///       constants are stored in a per rasterizer arena.
+/// \note Objects are retained between frames. Each object keeps an id (see
+///       insert) for incremental updates, and the draw order, instanced draws
+///       and culled buckets are only computed again when objects change.
 class Rasterizer {
 public:
   struct RasterMaterial {
     // material
     VkPipeline vk_pipeline{VK_NULL_HANDLE};
     VkPipelineLayout vk_pipeline_layout{VK_NULL_HANDLE};
-    /// Map of descritptor set groups indexed by the first set index of
-    /// the group.
-    /// The descriptor sets of each group are bound sequentially in the pipeline
-    /// with indices starting at the first set index (the key).
-    std::unordered_map<h_index, std::vector<VkDescriptorSet>>
-        global_descriptor_sets;
+    /// Depth only pipeline (same layout) drawing the objects of the material
+    /// in the depth prepass (see record), if any.
+    VkPipeline vk_depth_pipeline{VK_NULL_HANDLE};
+    /// Descriptor sets bound once per pipeline.
+    DescriptorSetBindings global_descriptor_sets;
   };
   struct RasterObject {
     // mesh
     u32 count{0}; //< index count or vertex count
     u32 first_index{0};
     VkBuffer index_buffer{VK_NULL_HANDLE};
+    VkIndexType index_type{VK_INDEX_TYPE_UINT32};
     VkBuffer vertex_buffer{VK_NULL_HANDLE};
+    /// If set, the indexed draw parameters (count and first index included)
+    /// are read from a VkDrawIndexedIndirectCommand in this buffer.
+    /// \note Indirect draws are never merged by instanceObjects.
+    VkBuffer indirect_buffer{VK_NULL_HANDLE};
+    VkDeviceSize indirect_offset{0};
     // material
-    /// Map of descritptor set groups indexed by the first set index of
-    /// the group.
-    /// The descriptor sets of each group are bound sequentially in the pipeline
-    /// with indices starting at the first set index (the key).
-    std::unordered_map<h_index, std::vector<VkDescriptorSet>> descriptor_sets;
-    hermes::mem::Block push_constants;
-    VkShaderStageFlags push_constants_stage_flags;
+    /// Descriptor sets bound per object.
+    DescriptorSetBindings descriptor_sets;
+    /// Range of the push constants arena (set by insert).
+    u32 push_constants_offset{0};
+    u32 push_constants_size{0};
+    VkShaderStageFlags push_constants_stage_flags{0};
+    // sorting (see SortKeyLayout)
+    u32 pass{0}; //< objects are ordered by pass first.
+    /// Distance to the camera.
+    /// \note Depth changes only reorder objects when their key changes (see
+    ///       SortKeyLayout::front_to_back_resort_bits).
+    f32 depth{0.f};
+    // instancing and culling (see instanceObjects and cullObjects)
+    hermes::geo::Transform transform;     //< object to world transform.
+    hermes::geo::bounds::bsphere3 bounds; //< object space bounds.
+  };
+  /// Bit widths of the fields packed into the 64-bit sort key of each object,
+  /// from the most to the least significant: pass, pipeline, material
+  /// instance (descriptor sets), mesh (vertex and index buffers) and depth.
+  /// \note Fields must fit in 64 bits, ids exceeding their field saturate
+  ///       (a warning is issued).
+  /// \note Zero bits leave the field out of the ordering.
+  /// \note Objects of back to front passes (transparent) are ordered by depth
+  ///       right after the pass, as blending requires a strict depth order.
+  struct SortKeyLayout {
+    u8 pass_bits{4};
+    u8 pipeline_bits{10};
+    u8 material_bits{14};
+    u8 mesh_bits{14};
+    u8 depth_bits{22};
+    /// Passes whose objects are ordered back to front (one bit per pass),
+    /// objects of other passes are ordered front to back.
+    u32 back_to_front_passes{0};
+    /// Front to back objects are only sorted again when the top bits of their
+    /// depth fields change, a coarse order is enough to avoid overdraw and
+    /// keeps small camera moves from sorting all objects.
+    u8 front_to_back_resort_bits{12};
   };
 
   /// Raster with dynamic rendering
@@ -69,17 +112,106 @@ public:
   Rasterizer &setClearColor(const VkClearColorValue &color);
   /// \param area Render area.
   Rasterizer &setRenderArea(const VkExtent2D &area);
+  /// \param layout Fields of the object sort keys (see sortObjects).
+  Rasterizer &setSortKeyLayout(const SortKeyLayout &layout);
+  /// \note Instance data is uploaded again as a whole after this call, only
+  ///       changed instances are uploaded otherwise.
+  /// \param buffer Storage buffer receiving the instance data of objects
+  ///        (see instanceObjects). It must outlive the recorded commands.
+  Rasterizer &setInstanceBuffer(const mem::Buffer &buffer);
   /// \param raster_object Object data.
   /// \param raster_material Raster material data
+  /// \param push_constants Object push constants data (copied into the arena).
+  /// \param push_constants_size Size in bytes of push_constants.
   /// \note Materials are considered equal by the rasterizer when both pipeline
   ///       and pipeline layouts are the same.
+  /// \return Id of the object (valid until the object is removed).
+  h_index insert(const RasterObject &raster_object,
+                 const RasterMaterial &raster_material,
+                 const void *push_constants = nullptr,
+                 u32 push_constants_size = 0);
+  /// Inserts an object (see insert).
   Rasterizer &add(const RasterObject &raster_object,
-                  const RasterMaterial &raster_material);
-  /// Sorts the interna cache of objects by materials.
-  /// \note This avoids binding the same objects consecutively.
+                  const RasterMaterial &raster_material,
+                  const void *push_constants = nullptr,
+                  u32 push_constants_size = 0);
+  /// Replaces the data of an object (material included), keeping its id.
+  /// \note Objects are left untouched when the data is the same, changes of
+  ///       transform and depth alone are handled by updateTransform (as are
+  ///       push constants of objects not merged into other draws).
+  /// \param id Object id.
+  /// \param raster_object Object data.
+  /// \param raster_material Raster material data
+  /// \param push_constants Object push constants data (copied into the arena).
+  /// \param push_constants_size Size in bytes of push_constants.
+  Rasterizer &update(h_index id, const RasterObject &raster_object,
+                     const RasterMaterial &raster_material,
+                     const void *push_constants = nullptr,
+                     u32 push_constants_size = 0);
+  /// Patches the transform of an object in place, instanced draws and culled
+  /// buckets are kept (see instanceObjects and cullObjects).
+  /// \param id Object id.
+  /// \param transform Object to world transform.
+  /// \param depth Distance to the camera.
+  Rasterizer &updateTransform(h_index id,
+                              const hermes::geo::Transform &transform,
+                              f32 depth);
+  /// \note Removed objects leave the draw order by the next sort, their ids
+  ///       may be given to objects inserted after it.
+  /// \param id Object id.
+  Rasterizer &remove(h_index id);
+  /// Removes all objects.
+  Rasterizer &clear();
+  /// \return Number of objects.
+  HERMES_NODISCARD h_size objectCount() const;
+  /// Sorts the internal cache of objects by their sort keys (see
+  /// SortKeyLayout), with a radix sort over a reused scratch buffer.
+  /// \note This groups objects sharing state, avoiding redundant binds.
+  /// \note Only objects changed since the last sort get new keys, merged into
+  ///       the kept order (everything is sorted again after layout changes or
+  ///       when most objects changed).
+  /// \note Objects inserted afterwards are drawn last until the next sort.
   Rasterizer &sortObjects();
+  /// Merges consecutive objects (in draw order) sharing all draw state
+  /// (material, descriptor sets, buffers, index range and push constants) into
+  /// single instanced draws. The transforms of all objects are grouped by draw
+  /// and uploaded (transposed) into the instance buffer during record, so
+  /// shaders read the transform of an object at gl_InstanceIndex.
+  /// \note Call after sortObjects, as only consecutive objects are merged.
+  /// \note Objects changed or reordered afterwards undo the merge, the merge is
+  ///       kept otherwise. Call every frame before record, transforms patched
+  ///       since the last call (see updateTransform) are uploaded by record.
+  /// \note Indirect draws read the instance given by the firstInstance of
+  ///       their commands.
+  Rasterizer &instanceObjects();
+  /// Replaces the objects of the culler by the indexed objects of this
+  /// rasterizer, grouped into buckets of objects sharing all draw state but
+  /// index ranges and transforms (material, descriptor sets, buffers and push
+  /// constants). Each bucket is then drawn by a single indirect count draw of
+  /// the commands written by the culler. Other objects are drawn as usual.
+  /// \note Call after sortObjects, buckets are drawn in the order of their
+  ///       first objects.
+  /// \note Objects of back to front passes are never culled, keeping their
+  ///       order.
+  /// \note The culler must be prepared and recorded before record, and
+  ///       outlive the recorded commands.
+  /// \note Buckets (and the culler objects) are kept until objects change.
+  /// \note With occlusion culling (see DrawCuller::setDepthPyramid), record
+  ///       renders twice: the second pass draws the buckets again with the
+  ///       commands of the second culling phase, recorded in between along
+  ///       with the depth pyramid. Objects of back to front passes are drawn
+  ///       by the second pass, after all culled objects.
+  /// \param culler
+  Rasterizer &cullObjects(DrawCuller &culler);
   /// Records the given command buffer with the rendering commands so output
   /// is draw into the given image.
+  /// \note Objects of materials with depth pipelines are first drawn by a
+  ///       depth only prepass, so their materials only shade visible
+  ///       fragments. The prepass draws in the same rendering scope (depth
+  ///       stays in the attachment), and only while such objects are
+  ///       registered. With occlusion culling, each pass has its own prepass.
+  /// \note Color and depth are cleared by the load ops of their first pass
+  ///       (no clear commands), depth is only stored when read afterwards.
   /// \param cb Command buffer being recorded.
   /// \param vk_color_image
   /// \param vk_color_image_view
@@ -89,13 +221,110 @@ public:
                                    const mem::Image::Handle &depth_image) const;
 
 private:
-  VeResult draw(const CommandBuffer &cb) const;
+  struct SortItem {
+    u64 key{0};
+    u32 object{0};
+  };
+
+  /// Retained object.
+  struct ObjectSlot {
+    RasterObject object;
+    h_index material{0};
+    bool live{false};
+    bool sort_pending{false}; //< key changed since the last sort.
+    /// Drawn by a culled bucket (set by cullObjects).
+    bool culled{false};
+    /// Instance transform index (set by instanceObjects and cullObjects).
+    u32 instance{0};
+  };
+
+  /// Grouping of objects into draws.
+  enum class DrawMode { OBJECTS, INSTANCED, CULLED };
+
+  /// Instanced draw of consecutive instances of the same object state.
+  struct Draw {
+    u32 object{0};
+    u32 first_instance{0};
+    u32 instance_count{1};
+    /// Culler bucket drawn instead of the object (see cullObjects).
+    std::optional<u32> bucket;
+  };
+
+  /// Stable LSD radix sort (8 bits per pass) of items by key.
+  static void radixSort(std::vector<SortItem> &items,
+                        std::vector<SortItem> &scratch);
+
+  /// \return true if objects of the pass are ordered back to front.
+  bool backToFront(u32 pass) const;
+  /// \return true if the depth gives the object a new key (see
+  ///         SortKeyLayout::front_to_back_resort_bits).
+  bool depthKeyChanged(const RasterObject &object, f32 depth) const;
+  /// \return Id of the material (cached on first use).
+  h_index materialId(const RasterMaterial &material);
+  /// \return Sort key of the object (see SortKeyLayout).
+  u64 sortKey(u32 object);
+  /// Writes the push constants of an object into the arena, reusing the range
+  /// of the object when sizes match.
+  void storePushConstants(u32 object, const void *push_constants,
+                          u32 push_constants_size);
+  /// Drops arena ranges no longer used by objects.
+  void compactPushConstants();
+  void markSortPending(u32 object);
+  /// Undoes instanced draws and culled buckets.
+  void invalidateDraws();
+  /// \return true if both objects share material, buffers, descriptor sets
+  ///         and push constants.
+  bool sameState(u32 a, u32 b) const;
+  /// \return true if both objects can be drawn by the same instanced draw.
+  bool sameDraw(u32 a, u32 b) const;
+  VeResult uploadInstances(const CommandBuffer &cb) const;
+  /// \param cb
+  /// \param phase Occlusion culling phase (the second only draws buckets).
+  /// \param depth_prepass Draws objects with depth pipelines only, with their
+  ///        depth pipelines.
+  VeResult draw(const CommandBuffer &cb, u32 phase, bool depth_prepass) const;
 
   std::unordered_map<VkPipeline, std::unordered_map<VkPipelineLayout, h_index>>
       material_indices_;
   std::vector<RasterMaterial> materials_;
-  /// object, material id pairs
-  std::vector<std::pair<RasterObject, h_index>> objects_;
+  /// objects by id (removed objects leave free slots)
+  std::vector<ObjectSlot> objects_;
+  std::vector<u32> free_objects_;
+  /// objects removed since the last sort (still in the draw order)
+  std::vector<u32> removed_objects_;
+  /// push constants of all objects
+  std::vector<u8> push_constants_;
+  /// arena bytes no longer used by objects
+  h_size unused_push_constants_size_{0};
+  /// ids of objects in draw order
+  std::vector<u32> draw_order_;
+  /// keys of the last sort in draw order
+  std::vector<SortItem> sort_items_;
+  std::vector<SortItem> sort_scratch_;
+  /// objects whose keys changed since the last sort
+  std::vector<u32> sort_pending_;
+  /// dense ids of descriptor sets and meshes (kept between sorts)
+  std::unordered_map<u64, u64> material_ids_;
+  std::unordered_map<u64, u64> mesh_ids_;
+  bool sorted_{false};
+  /// live objects of materials with depth pipelines (drawn by the prepass)
+  u32 depth_prepass_objects_{0};
+  SortKeyLayout sort_key_layout_;
+  /// sort key ids exceeded their fields (reported once per layout)
+  bool key_saturation_reported_{false};
+  DrawMode draw_mode_{DrawMode::OBJECTS};
+  /// instanced draws in draw order (empty when objects are not instanced)
+  std::vector<Draw> draws_;
+  /// transposed object transforms, grouped by draw
+  std::vector<hermes::geo::Transform> instance_transforms_;
+  /// instance transforms changed since the last instanceObjects
+  std::pair<u32, u32> changed_instances_{0, 0};
+  /// instance transforms uploaded by record
+  std::pair<u32, u32> instance_upload_{0, 0};
+  /// the instance buffer holds no instance data
+  bool upload_all_instances_{true};
+  const mem::Buffer *instance_buffer_{nullptr};
+  DrawCuller *draw_culler_{nullptr};
   // config
   VkExtent2D render_area_{};
   VkClearColorValue clear_color_ = {30.0f / 256.0f, 30.0f / 256.0f,
@@ -117,13 +346,9 @@ template <> struct DebugTraits<venus::pipeline::Rasterizer::RasterMaterial> {
         .add("vk_pipeline", VENUS_VK_HANDLE_STRING(data.vk_pipeline))
         .add("vk_pipeline_layout",
              VENUS_VK_HANDLE_STRING(data.vk_pipeline_layout))
-        .add("global descriptor sets")
-        .pushTab();
-    for (const auto &item : data.global_descriptor_sets) {
-      m.addFmt("first set index {}", item.first);
-      for (auto handle : item.second)
-        m.addFmt("{}", VENUS_VK_HANDLE_STRING(handle));
-    }
+        .add("vk_depth_pipeline",
+             VENUS_VK_HANDLE_STRING(data.vk_depth_pipeline))
+        .add("global descriptor sets", data.global_descriptor_sets);
     return m;
   }
 };
@@ -135,17 +360,18 @@ template <> struct DebugTraits<venus::pipeline::Rasterizer::RasterObject> {
     DebugMessage m;
     m.addTitle("Raster Object")
         .add("index_buffer", VENUS_VK_HANDLE_STRING(data.index_buffer))
+        .add("index_type", string_VkIndexType(data.index_type))
         .add("vertex_buffer", VENUS_VK_HANDLE_STRING(data.vertex_buffer))
         .add("count", data.count) //< index count or vertex count
         .add("first_index", data.first_index)
-        .add("push constants", data.push_constants)
-        .add("local descriptor sets")
-        .pushTab();
-    for (const auto &item : data.descriptor_sets) {
-      m.addFmt("first set index {}", item.first);
-      for (auto handle : item.second)
-        m.addFmt("{}", VENUS_VK_HANDLE_STRING(handle));
-    }
+        .add("indirect_buffer", VENUS_VK_HANDLE_STRING(data.indirect_buffer))
+        .add("indirect_offset", data.indirect_offset)
+        .add("pass", data.pass)
+        .add("depth", data.depth)
+        .add("transform", data.transform)
+        .add("push_constants_offset", data.push_constants_offset)
+        .add("push_constants_size", data.push_constants_size)
+        .add("local descriptor sets", data.descriptor_sets);
     return m;
   }
 };
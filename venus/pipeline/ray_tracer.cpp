@@ -42,6 +42,8 @@ RayTracer &RayTracer::operator=(RayTracer &&rhs) noexcept {
 }
 
 void RayTracer::destroy() noexcept {
+  objects_.clear();
+  dequantization_transforms_.destroy();
   tlas_.destroy();
   blas_.destroy();
   image_view_.destroy();
@@ -58,6 +60,8 @@ void RayTracer::destroy() noexcept {
 }
 
 void RayTracer::swap(RayTracer &rhs) {
+  VENUS_SWAP_FIELD_WITH_RHS(objects_);
+  VENUS_SWAP_FIELD_WITH_RHS(dequantization_transforms_);
   VENUS_SWAP_FIELD_WITH_RHS(blas_);
   VENUS_SWAP_FIELD_WITH_RHS(tlas_);
   VENUS_SWAP_FIELD_WITH_RHS(image_);
@@ -79,12 +83,24 @@ RayTracer &RayTracer::setResolution(const VkExtent2D &resolution) {
 }
 
 RayTracer &RayTracer::add(const RayTracer::TracerObject &tracer_object) {
+  objects_.emplace_back(tracer_object);
+  return *this;
+}
+
+void RayTracer::addGeometry(const RayTracer::TracerObject &tracer_object,
+                            VkDeviceAddress transform_data) {
   VkDeviceOrHostAddressConstKHR vertex_data_device_address{};
   VkDeviceOrHostAddressConstKHR index_data_device_address{};
   VkDeviceOrHostAddressConstKHR transform_matrix_device_address{};
-  vertex_data_device_address.deviceAddress = tracer_object.vertex_data;
+  const auto &vertex_layout = tracer_object.vertex_layout;
+  auto position_stream =
+      vertex_layout.componentStream(mem::VertexLayout::ComponentType::Position);
+  auto position_offset =
+      vertex_layout.componentOffset(mem::VertexLayout::ComponentType::Position);
+  vertex_data_device_address.deviceAddress =
+      tracer_object.vertex_data + (position_offset ? *position_offset : 0);
   index_data_device_address.deviceAddress = tracer_object.index_data;
-  transform_matrix_device_address.deviceAddress = tracer_object.transform_data;
+  transform_matrix_device_address.deviceAddress = transform_data;
 
   auto triangles_data =
       scene::AccelerationStructure::TrianglesData()
@@ -94,7 +110,8 @@ RayTracer &RayTracer::add(const RayTracer::TracerObject &tracer_object) {
               tracer_object.vertex_layout
                   .componentFormat(mem::VertexLayout::ComponentType::Position)
                   .value())
-          .setVertexStride(tracer_object.vertex_layout.stride())
+          .setVertexStride(
+              vertex_layout.stride(position_stream ? *position_stream : 0))
           .setMaxVertex(tracer_object.max_vertex)
           // transform
           .setTransformData(transform_matrix_device_address);
@@ -102,7 +119,7 @@ RayTracer &RayTracer::add(const RayTracer::TracerObject &tracer_object) {
   if (index_data_device_address.deviceAddress) {
     // index
     triangles_data.setIndexData(index_data_device_address)
-        .setIndexType(VK_INDEX_TYPE_UINT32);
+        .setIndexType(tracer_object.index_type);
   }
 
   blas_.addGeometry(
@@ -118,8 +135,6 @@ RayTracer &RayTracer::add(const RayTracer::TracerObject &tracer_object) {
           // Geometry Type
           .setType(VK_GEOMETRY_TYPE_TRIANGLES_KHR),
       tracer_object.primitive_count, tracer_object.transform_offset);
-
-  return *this;
 }
 
 VeResult RayTracer::createPipeline(VkDevice vk_device) {
@@ -289,6 +304,44 @@ VeResult RayTracer::prepare(const engine::GraphicsDevice &gd,
 
   // BLAS
 
+  // quantized positions (see mem::quantizeVertices) are normalized to the
+  // mesh bounds, their geometries are scaled back by their transforms
+  std::vector<VkTransformMatrixKHR> dequantization_transforms;
+  for (const auto &object : objects_) {
+    if (!object.dequantization.has_value())
+      continue;
+    if (object.transform_data) {
+      HERMES_ERROR("Quantized tracer objects can't have transform data.");
+      return VeResult::incompatible();
+    }
+    const auto &d = *object.dequantization;
+    dequantization_transforms.push_back({d.scale[0], 0.f, 0.f, d.offset[0], //
+                                         0.f, d.scale[1], 0.f, d.offset[1], //
+                                         0.f, 0.f, d.scale[2], d.offset[2]});
+  }
+  if (!dequantization_transforms.empty()) {
+    const h_size size =
+        sizeof(VkTransformMatrixKHR) * dequantization_transforms.size();
+    dequantization_transforms_.destroy();
+    VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
+        dequantization_transforms_,
+        mem::AllocatedBuffer::Config::forAccelerationStructure(size)
+            .addUsage(
+                VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR)
+            .build(*gd));
+    VENUS_RETURN_BAD_RESULT(dequantization_transforms_.copy(
+        dequantization_transforms.data(), size));
+  }
+  h_size dequantization_index = 0;
+  for (const auto &object : objects_) {
+    VkDeviceAddress transform_data = object.transform_data;
+    if (object.dequantization.has_value())
+      transform_data = dequantization_transforms_.deviceAddress() +
+                       sizeof(VkTransformMatrixKHR) * dequantization_index++;
+    addGeometry(object, transform_data);
+  }
+  objects_.clear();
+
   blas_.setType(VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR);
   VENUS_RETURN_BAD_RESULT(
       blas_.build(gd,                                                        //
@@ -45,8 +45,13 @@ public:
     // data
     VkDeviceAddress vertex_data{0};
     VkDeviceAddress index_data{0};
+    VkIndexType index_type{VK_INDEX_TYPE_UINT32};
     VkDeviceAddress transform_data{0};
     mem::VertexLayout vertex_layout;
+    /// Position dequantization (see mem::quantizeVertices), folded into the
+    /// geometry transform.
+    /// \note Quantized objects can't have transform data.
+    std::optional<mem::Dequantization> dequantization;
   };
   struct UniformBuffer {
     hermes::geo::Transform view_inverse;
@@ -58,6 +63,7 @@ public:
 
   /// \param area Output render image size (in pixels).
   RayTracer &setResolution(const VkExtent2D &resolution);
+  /// \note Geometries of added objects are created by prepare.
   /// \param tracer_object
   RayTracer &add(const TracerObject &tracer_object);
   /// Setup acceleration structures
@@ -73,11 +79,19 @@ public:
                                    VkImage vk_color_image) const;
 
 private:
+  /// \param tracer_object
+  /// \param transform_data Geometry transform (3x4 row major).
+  void addGeometry(const TracerObject &tracer_object,
+                   VkDeviceAddress transform_data);
   VeResult createPipeline(VkDevice vk_device);
   VeResult createShaderBindingTable(const core::Device &device);
   VeResult createDescriptorSets(VkDevice vk_device);
 
   VkExtent2D resolution_{};
+  /// objects added since the last prepare
+  std::vector<TracerObject> objects_;
+  /// dequantization transforms read by the BLAS build
+  mem::AllocatedBuffer dequantization_transforms_;
   scene::AccelerationStructure blas_;
   scene::AccelerationStructure tlas_;
   mem::AllocatedImage image_;
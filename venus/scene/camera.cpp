@@ -54,6 +54,15 @@ hermes::geo::Transform Camera::projectionTransform() const {
   return **projection_;
 }
 
+Frustum Camera::frustum() const {
+  if (needs_update_)
+    update();
+  return Frustum::fromTransform(
+      **projection_ * view_,
+      projection_->options().contain(
+          hermes::geo::transform_option_bits::zero_to_one));
+}
+
 hermes::math::mat3 Camera::normalMatrix() const {
   if (needs_update_)
     update();
@@ -157,6 +166,10 @@ VENUS_DEFINE_SET_FIELD_METHOD(Camera::Projection, addOptions,
                               hermes::geo::transform_options,
                               (needs_update_ = true, options_ |= value))
 
+hermes::geo::transform_options Camera::Projection::options() const {
+  return options_;
+}
+
 const hermes::geo::Transform &Camera::Projection::inverse() const {
   if (needs_update_) {
     transform_ = computeTransform();
@@ -27,6 +27,7 @@
 
 #pragma once
 
+#include <venus/scene/frustum.h>
 #include <venus/utils/debug.h>
 
 #include <hermes/core/ref.h>
@@ -73,6 +74,7 @@ public:
     Projection &setNear(f32 near);
     Projection &setFar(f32 far);
     Projection &addOptions(hermes::geo::transform_options options);
+    HERMES_NODISCARD hermes::geo::transform_options options() const;
     const hermes::geo::Transform &inverse() const;
     const hermes::geo::Transform &operator*() const;
 
@@ -119,6 +121,8 @@ public:
   /// \return  target position
   HERMES_NODISCARD virtual hermes::geo::point3 targetPosition() const;
   HERMES_NODISCARD virtual hermes::geo::vec3 direction() const;
+  /// \return world space view frustum (projection and view transforms)
+  HERMES_NODISCARD Frustum frustum() const;
 
   template <typename T, class... P> Camera &setProjection(P &&...params) {
     projection_ = std::make_shared<T>(std::forward<P>(params)...);
@@ -147,7 +151,6 @@ public:
 
 protected:
   virtual void update() const;
-  // hermes::Frustum frustum;
   mutable hermes::geo::vec3 up_{0, 1, 0};
   hermes::geo::point3 pos_;
   hermes::geo::point3 target_;
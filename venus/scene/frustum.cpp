@@ -0,0 +1,201 @@
+/* Copyright (c) 2025, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/// \file   frustum.cpp
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-18
+
+#include <venus/scene/frustum.h>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define VENUS_FRUSTUM_LANES 8
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define VENUS_FRUSTUM_LANES 4
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define VENUS_FRUSTUM_LANES 4
+#else
+#define VENUS_FRUSTUM_LANES 1
+#endif
+
+#include <algorithm>
+#include <cmath>
+
+namespace venus::scene {
+
+// spheres are stored in blocks of the widest lane count so the last block can
+// always be loaded as a whole
+static constexpr h_size k_padding = 8;
+
+Frustum Frustum::fromTransform(const hermes::geo::Transform &proj_view,
+                               bool zero_to_one) {
+  const auto &m = proj_view.matrix();
+  // planes are combinations of the rows of the clip matrix (Gribb/Hartmann)
+  auto row = [&](u32 i, u32 j) -> f32 { return m[i][j]; };
+  Frustum frustum;
+  for (u32 j = 0; j < 4; ++j) {
+    frustum.planes[0][j] = row(3, j) + row(0, j);
+    frustum.planes[1][j] = row(3, j) - row(0, j);
+    frustum.planes[2][j] = row(3, j) + row(1, j);
+    frustum.planes[3][j] = row(3, j) - row(1, j);
+    frustum.planes[4][j] = zero_to_one ? row(2, j) : row(3, j) + row(2, j);
+    frustum.planes[5][j] = row(3, j) - row(2, j);
+  }
+  for (auto &plane : frustum.planes) {
+    f32 length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] +
+                           plane[2] * plane[2]);
+    if (length <= 0.f)
+      continue;
+    for (auto &c : plane)
+      c /= length;
+  }
+  return frustum;
+}
+
+bool Frustum::intersects(const hermes::geo::bounds::bsphere3 &sphere) const {
+  auto center = sphere.center();
+  f32 radius = sphere.radius();
+  for (const auto &plane : planes)
+    if (plane[0] * center.x + plane[1] * center.y + plane[2] * center.z +
+            plane[3] <
+        -radius)
+      return false;
+  return true;
+}
+
+void SphereBatch::clear() { size_ = 0; }
+
+void SphereBatch::reserve(h_size count) {
+  count = (count + k_padding - 1) / k_padding * k_padding;
+  x_.reserve(count);
+  y_.reserve(count);
+  z_.reserve(count);
+  radius_.reserve(count);
+}
+
+h_index SphereBatch::add(const hermes::geo::bounds::bsphere3 &sphere) {
+  auto center = sphere.center();
+  if (x_.size() <= size_) {
+    h_size padded = size_ + k_padding;
+    x_.resize(padded, 0.f);
+    y_.resize(padded, 0.f);
+    z_.resize(padded, 0.f);
+    radius_.resize(padded, 0.f);
+  }
+  x_[size_] = center.x;
+  y_[size_] = center.y;
+  z_[size_] = center.z;
+  radius_[size_] = sphere.radius();
+  return size_++;
+}
+
+h_index SphereBatch::add(const hermes::geo::bounds::bsphere3 &sphere,
+                         const hermes::geo::Transform &transform) {
+  f32 radius = sphere.radius();
+  f32 scale = std::max(
+      transform(hermes::geo::vec3(1.f, 0.f, 0.f)).length(),
+      std::max(transform(hermes::geo::vec3(0.f, 1.f, 0.f)).length(),
+               transform(hermes::geo::vec3(0.f, 0.f, 1.f)).length()));
+  hermes::geo::bounds::bsphere3 world;
+  world.setCenter(transform(sphere.center()));
+  world.setRadius(radius * scale);
+  return add(world);
+}
+
+h_size SphereBatch::size() const { return size_; }
+
+// Writes the lane results of a block (bit i of mask) of spheres.
+static void storeMask(u32 mask, h_size first, h_size size,
+                      std::vector<u8> &visible) {
+  h_size lanes = std::min<h_size>(VENUS_FRUSTUM_LANES, size - first);
+  for (h_size i = 0; i < lanes; ++i)
+    visible[first + i] = (mask >> i) & 1u;
+}
+
+void SphereBatch::cull(const Frustum &frustum,
+                       std::vector<u8> &visible) const {
+  visible.resize(size_);
+  for (h_size i = 0; i < size_; i += VENUS_FRUSTUM_LANES) {
+#if defined(__AVX__)
+    __m256 x = _mm256_loadu_ps(&x_[i]);
+    __m256 y = _mm256_loadu_ps(&y_[i]);
+    __m256 z = _mm256_loadu_ps(&z_[i]);
+    __m256 neg_radius =
+        _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(&radius_[i]));
+    __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+    for (const auto &plane : frustum.planes) {
+      __m256 d = _mm256_add_ps(
+          _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane[0]), x),
+                        _mm256_mul_ps(_mm256_set1_ps(plane[1]), y)),
+          _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane[2]), z),
+                        _mm256_set1_ps(plane[3])));
+      inside =
+          _mm256_and_ps(inside, _mm256_cmp_ps(d, neg_radius, _CMP_GE_OQ));
+    }
+    storeMask(_mm256_movemask_ps(inside), i, size_, visible);
+#elif defined(__SSE2__) || defined(_M_X64)
+    __m128 x = _mm_loadu_ps(&x_[i]);
+    __m128 y = _mm_loadu_ps(&y_[i]);
+    __m128 z = _mm_loadu_ps(&z_[i]);
+    __m128 neg_radius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(&radius_[i]));
+    __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    for (const auto &plane : frustum.planes) {
+      __m128 d =
+          _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane[0]), x),
+                                _mm_mul_ps(_mm_set1_ps(plane[1]), y)),
+                     _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane[2]), z),
+                                _mm_set1_ps(plane[3])));
+      inside = _mm_and_ps(inside, _mm_cmpge_ps(d, neg_radius));
+    }
+    storeMask(_mm_movemask_ps(inside), i, size_, visible);
+#elif defined(__ARM_NEON)
+    float32x4_t x = vld1q_f32(&x_[i]);
+    float32x4_t y = vld1q_f32(&y_[i]);
+    float32x4_t z = vld1q_f32(&z_[i]);
+    float32x4_t neg_radius = vnegq_f32(vld1q_f32(&radius_[i]));
+    uint32x4_t inside = vdupq_n_u32(~0u);
+    for (const auto &plane : frustum.planes) {
+      float32x4_t d = vdupq_n_f32(plane[3]);
+      d = vmlaq_n_f32(d, x, plane[0]);
+      d = vmlaq_n_f32(d, y, plane[1]);
+      d = vmlaq_n_f32(d, z, plane[2]);
+      inside = vandq_u32(inside, vcgeq_f32(d, neg_radius));
+    }
+    u32 mask = (vgetq_lane_u32(inside, 0) & 1u) |
+               (vgetq_lane_u32(inside, 1) & 2u) |
+               (vgetq_lane_u32(inside, 2) & 4u) |
+               (vgetq_lane_u32(inside, 3) & 8u);
+    storeMask(mask, i, size_, visible);
+#else
+    u32 mask = 1u;
+    for (const auto &plane : frustum.planes)
+      if (plane[0] * x_[i] + plane[1] * y_[i] + plane[2] * z_[i] + plane[3] <
+          -radius_[i])
+        mask = 0u;
+    storeMask(mask, i, size_, visible);
+#endif
+  }
+}
+
+} // namespace venus::scene
@@ -0,0 +1,108 @@
+/* Copyright (c) 2025, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/// \file   frustum.h
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-18
+/// \brief  View frustum and batched frustum culling.
+
+#pragma once
+
+#include <venus/utils/debug.h>
+
+#include <hermes/geometry/bounds.h>
+#include <hermes/geometry/transform.h>
+
+namespace venus::scene {
+
+/// \brief View frustum described by six planes with normals pointing inside.
+/// A point p is inside plane i if dot(planes[i].xyz, p) + planes[i].w >= 0.
+struct Frustum {
+  /// Extracts (and normalizes) the planes of the clip volume of a transform.
+  /// \param proj_view Projection times view transform (world to clip space).
+  /// \param zero_to_one Clip depth range is [0,1] (instead of [-1,1]).
+  static Frustum fromTransform(const hermes::geo::Transform &proj_view,
+                               bool zero_to_one = true);
+
+  /// \param sphere
+  /// \return true if the sphere intersects or lies inside the frustum.
+  HERMES_NODISCARD bool
+  intersects(const hermes::geo::bounds::bsphere3 &sphere) const;
+
+  f32 planes[6][4]{}; //< left, right, bottom, top, near, far
+};
+
+/// \brief Bounding spheres packed as a structure of arrays, tested against a
+///        frustum in batches with SIMD instructions (AVX, SSE or NEON,
+///        whichever the target enables, with a scalar fallback).
+class SphereBatch {
+public:
+  /// Removes all spheres (memory is kept).
+  void clear();
+  /// \param count
+  void reserve(h_size count);
+  /// \param sphere
+  /// \return Index of the sphere.
+  h_index add(const hermes::geo::bounds::bsphere3 &sphere);
+  /// Appends the world space bounds of an object.
+  /// \note The radius is scaled by the largest axis scale of the transform.
+  /// \param sphere Object space bounds.
+  /// \param transform Object to world transform.
+  /// \return Index of the sphere.
+  h_index add(const hermes::geo::bounds::bsphere3 &sphere,
+              const hermes::geo::Transform &transform);
+  /// \return Number of spheres.
+  HERMES_NODISCARD h_size size() const;
+  /// Tests all spheres against the frustum.
+  /// \param frustum
+  /// \param visible Receives (size()) 1 for spheres intersecting the frustum
+  ///        and 0 for culled ones.
+  void cull(const Frustum &frustum, std::vector<u8> &visible) const;
+
+private:
+  h_size size_{0};
+  // padded to a multiple of the widest SIMD lane count
+  std::vector<f32> x_;
+  std::vector<f32> y_;
+  std::vector<f32> z_;
+  std::vector<f32> radius_;
+};
+
+} // namespace venus::scene
+
+#ifdef VENUS_INCLUDE_DEBUG_TRAITS
+namespace hermes {
+
+template <> struct DebugTraits<venus::scene::Frustum> {
+  static HERMES_CONST_OR_CONSTEXPR bool is_string_serializable = true;
+  static DebugMessage message(const venus::scene::Frustum &data) {
+    DebugMessage m;
+    m.addTitle("Frustum");
+    for (const auto &plane : data.planes)
+      m.addFmt("{} {} {} {}", plane[0], plane[1], plane[2], plane[3]);
+    return m;
+  }
+};
+
+} // namespace hermes
+
+#endif // VENUS_INCLUDE_DEBUG_TRAITS
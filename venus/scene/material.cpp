@@ -55,9 +55,11 @@ VENUS_DEFINE_SET_CONFIG_FIELD_METHOD(Material::Instance, addGlobalSetIndex,
 Material::Instance::Config &Material::Instance::Config::setWritePushConstants(
     VkShaderStageFlags stage_flags,
     const std::function<VeResult(hermes::mem::Block &,
-                                 const PushConstantsContext &)> &f) {
+                                 const PushConstantsContext &)> &f,
+    bool view_dependent) {
   push_constants_stage_flags_ = stage_flags;
   write_push_constants_ = f;
+  view_dependent_push_constants_ = view_dependent;
   return *this;
 }
 
@@ -68,6 +70,7 @@ Result<Material::Instance> Material::Instance::Config::build(
   instance.material_ = material_;
   instance.write_push_constants_ = write_push_constants_;
   instance.push_constants_stage_flags_ = push_constants_stage_flags_;
+  instance.view_dependent_push_constants_ = view_dependent_push_constants_;
   instance.global_set_indices_ = global_set_indices_;
 
   // allocate local descriptor sets
@@ -79,6 +82,17 @@ Result<Material::Instance> Material::Instance::Config::build(
                                        allocator.allocate(item.second));
     instance.descriptor_sets_[item.first] = std::move(descriptor_set);
   }
+  // group local descriptor sets into contiguous ranges of set indices
+  std::set<h_index> set_indices;
+  for (const auto &item : instance.descriptor_sets_)
+    set_indices.insert(item.first);
+  for (auto set_index : set_indices)
+    if (!instance.local_descriptor_set_bindings_.add(
+            static_cast<u32>(set_index),
+            *instance.descriptor_sets_[set_index])) {
+      HERMES_ERROR("Too many local descriptor sets in material instance.");
+      return Result<Material::Instance>::error(VeResult::outOfBounds());
+    }
 
   return Result<Material::Instance>(std::move(instance));
 }
@@ -99,15 +113,18 @@ Material::Instance::~Instance() noexcept { destroy(); }
 void Material::Instance::swap(Material::Instance &rhs) {
   VENUS_SWAP_FIELD_WITH_RHS(material_);
   VENUS_SWAP_FIELD_WITH_RHS(descriptor_sets_);
+  VENUS_SWAP_FIELD_WITH_RHS(local_descriptor_set_bindings_);
   VENUS_SWAP_FIELD_WITH_RHS(global_set_indices_);
   VENUS_SWAP_FIELD_WITH_RHS(write_push_constants_);
   VENUS_SWAP_FIELD_WITH_RHS(push_constants_stage_flags_);
+  VENUS_SWAP_FIELD_WITH_RHS(view_dependent_push_constants_);
 }
 
 void Material::Instance::destroy() noexcept {
   material_.destroy();
   for (auto &ds : descriptor_sets_)
     ds.second.destroy();
+  local_descriptor_set_bindings_ = {};
   write_push_constants_ = nullptr;
 }
 
@@ -117,6 +134,15 @@ const pipeline::GraphicsPipeline &Material::Instance::pipeline() const {
   return material_->pipeline().pipeline();
 }
 
+const pipeline::GraphicsPipeline &
+Material::Instance::depthPrepassPipeline() const {
+  return material_->pipeline().depthPrepassPipeline();
+}
+
+Material::Pass Material::Instance::pass() const {
+  return material_->pipeline().pass();
+}
+
 const pipeline::Pipeline::Layout &Material::Instance::pipelineLayout() const {
   return material_->pipeline().pipelineLayout();
 }
@@ -125,30 +151,9 @@ bool Material::Instance::hasGlobalDescriptors() const {
   return global_set_indices_.size();
 }
 
-std::unordered_map<h_index, std::vector<VkDescriptorSet>>
-Material::Instance::localDescriptorSetGroups() const {
-  if (descriptor_sets_.empty())
-    return {};
-  // get all set indices in increasing order so we can create the contiguous
-  // groups
-  std::set<h_index> set_indices;
-  for (const auto &item : descriptor_sets_)
-    set_indices.insert(item.first);
-
-  std::unordered_map<h_index, std::vector<VkDescriptorSet>> groups;
-  h_index last_set_index = 0;
-  for (auto set_index : set_indices) {
-    auto it = descriptor_sets_.find(set_index);
-    if (groups.empty()) {
-      groups[set_index] = {*(it->second)};
-    } else if (last_set_index + 1 == set_index) {
-      groups[set_index].emplace_back(*(it->second));
-    } else {
-      groups[set_index] = {*(it->second)};
-    }
-    last_set_index = set_index;
-  }
-  return groups;
+const pipeline::DescriptorSetBindings &
+Material::Instance::localDescriptorSetBindings() const {
+  return local_descriptor_set_bindings_;
 }
 
 const pipeline::DescriptorSet &
@@ -177,6 +182,10 @@ VkShaderStageFlags Material::Instance::pushConstantsStageFlags() const {
   return push_constants_stage_flags_;
 }
 
+bool Material::Instance::viewDependentPushConstants() const {
+  return view_dependent_push_constants_;
+}
+
 VENUS_DEFINE_SET_CONFIG_FIELD_METHOD(Material::Pipeline, setPipelineConfig,
                                      const pipeline::GraphicsPipeline::Config &,
                                      graphics_pipeline_config_ = value)
@@ -184,6 +193,11 @@ VENUS_DEFINE_SET_CONFIG_FIELD_METHOD(Material::Pipeline,
                                      setPipelineLayoutConfig,
                                      const pipeline::Pipeline::Layout::Config &,
                                      graphics_pipeline_layout_config_ = value)
+VENUS_DEFINE_SET_CONFIG_FIELD_METHOD(Material::Pipeline, setDepthPrepassConfig,
+                                     const pipeline::GraphicsPipeline::Config &,
+                                     depth_prepass_config_ = value)
+VENUS_DEFINE_SET_CONFIG_FIELD_METHOD(Material::Pipeline, setPass,
+                                     Material::Pass, pass_ = value)
 
 const pipeline::Pipeline::Layout::Config &
 Material::Pipeline::Config::graphicsPipelineLayoutConfig() const {
@@ -198,9 +212,38 @@ Material::Pipeline::Config::build(VkDevice vk_device,
   VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
       p.pipeline_layout_, graphics_pipeline_layout_config_.build(vk_device));
 
+  auto pipeline_config = graphics_pipeline_config_;
+  if (pass_ == Material::Pass::TRANSPARENT_COLOR) {
+    if (depth_prepass_config_.has_value()) {
+      HERMES_ERROR("Transparent materials can't have a depth prepass.");
+      return VeResult::inputError();
+    }
+    // blended fragments are tested against opaque depth but don't occlude
+    pipeline_config
+        .enableDepthTest(false, VK_COMPARE_OP_GREATER_OR_EQUAL)
+        .setColorBlend(pipeline::GraphicsPipeline::ColorBlend::alphaBlend());
+  }
+
+  if (depth_prepass_config_.has_value()) {
+    // the prepass writes the depth of visible fragments, so only those are
+    // shaded afterwards (equal depth is the same for reversed depth)
+    pipeline_config.enableDepthTest(false, VK_COMPARE_OP_EQUAL);
+
+    // the prepass draws within the color rendering of the material (see
+    // pipeline::Rasterizer::record), so it keeps its attachments
+    auto prepass_config = *depth_prepass_config_;
+    prepass_config
+        .setColorAttachmentFormats(pipeline_config.colorAttachmentFormats())
+        .disableColorWrites();
+    VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
+        p.depth_prepass_pipeline_,
+        prepass_config.build(vk_device, *p.pipeline_layout_, vk_renderpass));
+  }
+
   VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
-      p.pipeline_, graphics_pipeline_config_.build(
-                       vk_device, *p.pipeline_layout_, vk_renderpass));
+      p.pipeline_,
+      pipeline_config.build(vk_device, *p.pipeline_layout_, vk_renderpass));
+  p.pass_ = pass_;
 
 #ifdef VENUS_DEBUG
   p.config_ = *this;
@@ -258,11 +301,14 @@ Material::Pipeline::operator=(Material::Pipeline &&rhs) noexcept {
 void Material::Pipeline::swap(Material::Pipeline &rhs) {
 
   VENUS_SWAP_FIELD_WITH_RHS(pipeline_);
+  VENUS_SWAP_FIELD_WITH_RHS(depth_prepass_pipeline_);
   VENUS_SWAP_FIELD_WITH_RHS(pipeline_layout_);
+  VENUS_SWAP_FIELD_WITH_RHS(pass_);
 }
 
 void Material::Pipeline::destroy() noexcept {
   pipeline_.destroy();
+  depth_prepass_pipeline_.destroy();
   pipeline_layout_.destroy();
 }
 
@@ -276,6 +322,17 @@ const pipeline::GraphicsPipeline &Material::Pipeline::pipeline() const {
 
 VkPipeline Material::Pipeline::vkPipeline() const { return *pipeline_; }
 
+bool Material::Pipeline::hasDepthPrepass() const {
+  return *depth_prepass_pipeline_ != VK_NULL_HANDLE;
+}
+
+const pipeline::GraphicsPipeline &
+Material::Pipeline::depthPrepassPipeline() const {
+  return depth_prepass_pipeline_;
+}
+
+Material::Pass Material::Pipeline::pass() const { return pass_; }
+
 const pipeline::Pipeline::Layout &Material::Pipeline::pipelineLayout() const {
   return pipeline_layout_;
 }
@@ -35,6 +35,7 @@
 #include <hermes/geometry/transform.h>
 #include <hermes/storage/block.h>
 
+#include <optional>
 #include <set>
 
 namespace venus::scene {
@@ -80,6 +81,15 @@ struct PushConstantsContext {
   hermes::geo::Transform proj_view;
   hermes::geo::Transform model;
   hermes::geo::point3 eye;
+  /// Address of the object vertex buffer.
+  VkDeviceAddress vertex_buffer{0};
+  /// Address of the object position stream.
+  VkDeviceAddress position_buffer{0};
+  /// Position dequantization of quantized object vertices (empty if the
+  /// vertices are not quantized).
+  std::optional<mem::Dequantization> dequantization;
+  /// Address of the object instance transforms (0 if not instanced).
+  VkDeviceAddress instance_buffer{0};
 };
 
 // *****************************************************************************
@@ -94,16 +104,28 @@ class Material {
 public:
   using Ptr = hermes::Ref<Material>;
 
+  /// Rendering passes of materials, drawn in this order.
+  enum class Pass : u32 {
+    MAIN_COLOR = 0,       //< opaque, drawn front to back.
+    TRANSPARENT_COLOR = 1 //< alpha blended, drawn back to front.
+  };
+
   struct Instance {
     using Ptr = hermes::Ref<Instance>;
 
     struct Config {
       Config &setMaterial(Material::Ptr material);
       Config &addGlobalSetIndex(h_index global_set_index);
+      /// \param stage_flags
+      /// \param f Push constants writer.
+      /// \param view_dependent [def=true] The writer reads the camera fields
+      ///        of the context (push constants are written again whenever the
+      ///        camera changes), otherwise only object changes write them.
       Config &setWritePushConstants(
           VkShaderStageFlags stage_flags,
           const std::function<VeResult(hermes::mem::Block &,
-                                       const PushConstantsContext &)> &f);
+                                       const PushConstantsContext &)> &f,
+          bool view_dependent = true);
       Result<Instance> build(pipeline::DescriptorAllocator &allocator) const;
 
     private:
@@ -113,6 +135,7 @@ public:
       std::function<VeResult(hermes::mem::Block &,
                              const PushConstantsContext &)>
           write_push_constants_;
+      bool view_dependent_push_constants_{true};
     };
 
     VENUS_DECLARE_RAII_FUNCTIONS(Instance)
@@ -122,25 +145,37 @@ public:
 
     Material::Ptr material() const;
     const pipeline::GraphicsPipeline &pipeline() const;
+    /// \return The depth prepass pipeline of the material (empty if the
+    ///         material has no depth prepass).
+    const pipeline::GraphicsPipeline &depthPrepassPipeline() const;
+    /// \return The pass of the material.
+    Material::Pass pass() const;
     const pipeline::Pipeline::Layout &pipelineLayout() const;
     bool hasGlobalDescriptors() const;
-    std::unordered_map<h_index, std::vector<VkDescriptorSet>>
-    localDescriptorSetGroups() const;
+    /// \return Local descriptor sets grouped into contiguous set index ranges.
+    /// \note Ranges are computed once, when the instance is built.
+    const pipeline::DescriptorSetBindings &localDescriptorSetBindings() const;
     const pipeline::DescriptorSet &localDescriptorSet(h_index set_index) const;
     VeResult writePushConstants(hermes::mem::Block &block,
                                 const PushConstantsContext &ctx) const;
     VkShaderStageFlags pushConstantsStageFlags() const;
+    /// \return true if push constants depend on the camera (see
+    ///         Config::setWritePushConstants).
+    bool viewDependentPushConstants() const;
 
   private:
     Material::Ptr material_;
     /// set index -> descriptor set object map
     std::unordered_map<h_index, pipeline::DescriptorSet> descriptor_sets_;
+    /// local descriptor sets in set index order
+    pipeline::DescriptorSetBindings local_descriptor_set_bindings_;
     // TODO: this is weird (think in a better way to handle global set
     // descriptors)
     std::set<h_index> global_set_indices_;
     std::function<VeResult(hermes::mem::Block &, const PushConstantsContext &)>
         write_push_constants_;
     VkShaderStageFlags push_constants_stage_flags_{VK_SHADER_STAGE_VERTEX_BIT};
+    bool view_dependent_push_constants_{true};
 
 #ifdef VENUS_INCLUDE_DEBUG_TRAITS
     friend struct hermes::DebugTraits<Material::Instance>;
@@ -161,6 +196,23 @@ public:
       setPipelineConfig(const pipeline::GraphicsPipeline::Config &config);
       Config &
       setPipelineLayoutConfig(const pipeline::Pipeline::Layout::Config &config);
+      /// Enables a depth only prepass for the material. The prepass pipeline
+      /// is built from the given config with the color attachments of the
+      /// material pipeline (without color writes) and shares
+      /// the layout of the material pipeline, while the material pipeline
+      /// only shades fragments matching the prepass depth (equal depth test
+      /// without depth writes).
+      /// \note Prepass and material vertex stages must compute the same
+      ///       positions (invariant gl_Position), the built-in mesh shaders
+      ///       share their position path (see
+      ///       engine::GraphicsEngine::Globals::Shaders::vert_depth_prepass).
+      /// \param config Prepass pipeline config (with its own vertex stage).
+      Config &
+      setDepthPrepassConfig(const pipeline::GraphicsPipeline::Config &config);
+      /// Transparent materials are alpha blended and don't write depth.
+      /// \note Transparent materials can't have a depth prepass.
+      /// \param pass [def=MAIN_COLOR] Material pass.
+      Config &setPass(Material::Pass pass);
       const pipeline::Pipeline::Layout::Config &
       graphicsPipelineLayoutConfig() const;
       Result<Material::Pipeline> build(VkDevice vk_device,
@@ -169,6 +221,8 @@ public:
     private:
       pipeline::GraphicsPipeline::Config graphics_pipeline_config_;
       pipeline::Pipeline::Layout::Config graphics_pipeline_layout_config_;
+      std::optional<pipeline::GraphicsPipeline::Config> depth_prepass_config_;
+      Material::Pass pass_{Material::Pass::MAIN_COLOR};
 
 #ifdef VENUS_INCLUDE_DEBUG_TRAITS
       friend struct hermes::DebugTraits<Material::Pipeline::Config>;
@@ -188,10 +242,19 @@ public:
     HERMES_NODISCARD const pipeline::Pipeline::Layout &pipelineLayout() const;
     /// \return The underlying pipeline vulkan object.
     HERMES_NODISCARD VkPipeline vkPipeline() const;
+    /// \return true if the material draws a depth prepass.
+    HERMES_NODISCARD bool hasDepthPrepass() const;
+    /// \return The depth prepass pipeline (empty without depth prepass).
+    HERMES_NODISCARD const pipeline::GraphicsPipeline &
+    depthPrepassPipeline() const;
+    /// \return The pass of the material.
+    HERMES_NODISCARD Material::Pass pass() const;
 
   private:
     pipeline::GraphicsPipeline pipeline_;
+    pipeline::GraphicsPipeline depth_prepass_pipeline_;
     pipeline::Pipeline::Layout pipeline_layout_;
+    Material::Pass pass_{Material::Pass::MAIN_COLOR};
 
 #ifdef VENUS_DEBUG
     Config config_;
@@ -262,6 +325,7 @@ template <> struct DebugTraits<venus::scene::Material::Pipeline> {
     return DebugMessage()
         .addTitle("Scene Material Pipeline")
         .add("pipeline", data.pipeline_)
+        .add("depth prepass pipeline", data.depth_prepass_pipeline_)
         .add("pipeline layout", data.pipeline_layout_)
         .add("config", data.config_);
   }
@@ -48,6 +48,23 @@ HERMES_TO_STRING_DEBUG_METHOD_END
 
 namespace venus::scene::materials {
 
+VeResult writeDrawPushConstants(hermes::mem::Block &block,
+                                const PushConstantsContext &ctx) {
+  engine::GraphicsEngine::Globals::Types::DrawPushConstants push_constants;
+  if (!ctx.instance_buffer)
+    push_constants.world_matrix = hermes::math::transpose(ctx.model.matrix());
+  push_constants.vertex_buffer = ctx.vertex_buffer;
+  push_constants.instance_buffer = ctx.instance_buffer;
+  push_constants.position_buffer = ctx.position_buffer;
+  push_constants.quantized = ctx.dequantization.has_value();
+  push_constants.dequantization =
+      ctx.dequantization.value_or(mem::Dequantization());
+  push_constants.padding = 0;
+  VENUS_RETURN_BAD_HE_RESULT(block.resize(sizeof(push_constants)));
+  VENUS_RETURN_BAD_HE_RESULT(block.copy(&push_constants));
+  return VeResult::noError();
+}
+
 Result<Material> MAT_Empty::material(const engine::GraphicsDevice &gd) {
   auto &globals = engine::GraphicsEngine::globals();
 
@@ -197,7 +214,8 @@ Material_BindlessTest::material(const engine::GraphicsDevice &gd) {
 
 #ifdef VENUS_INCLUDE_GLTF
 Result<Material>
-GLTF_MetallicRoughness::material(const engine::GraphicsDevice &gd) {
+GLTF_MetallicRoughness::material(const engine::GraphicsDevice &gd,
+                                 bool depth_prepass, Material::Pass pass) {
   pipeline::DescriptorSet::Layout l;
   VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
       l, pipeline::DescriptorSet::Layout::Config()
@@ -226,14 +244,23 @@ GLTF_MetallicRoughness::material(const engine::GraphicsDevice &gd) {
                               .setStages(VK_SHADER_STAGE_FRAGMENT_BIT)
                               .build(globals.shaders.frag_mesh_pbr));
 
+  auto material_pipeline_config =
+      Material::Pipeline::Config()
+          .setPipelineConfig(pipeline_config)
+          .setPipelineLayoutConfig(pipeline_layout_config)
+          .setPass(pass);
+  if (depth_prepass)
+    material_pipeline_config.setDepthPrepassConfig(
+        pipeline::GraphicsPipeline::Config::forDynamicRendering(gd.swapchain())
+            .addShaderStage(pipeline::Pipeline::ShaderStage()
+                                .setStages(VK_SHADER_STAGE_VERTEX_BIT)
+                                .build(globals.shaders.vert_depth_prepass)));
+
   VENUS_DECLARE_OR_RETURN_BAD_RESULT(
       Material, m,
       Material::Config()
           .setDescriptorSetLayout(std::move(l))
-          .setMaterialPipelineConfig(
-              Material::Pipeline::Config()
-                  .setPipelineConfig(pipeline_config)
-                  .setPipelineLayoutConfig(pipeline_layout_config))
+          .setMaterialPipelineConfig(material_pipeline_config)
           .build(**gd, *gd.renderpass()));
 
   return Result<Material>(std::move(m));
@@ -247,8 +274,12 @@ GLTF_MetallicRoughness::write(pipeline::DescriptorAllocator &allocator,
   Material::Instance instance;
 
   VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
-      instance,
-      Material::Instance::Config().setMaterial(material).build(allocator))
+      instance, Material::Instance::Config()
+                    .setMaterial(material)
+                    // push constants only hold object data
+                    .setWritePushConstants(VK_SHADER_STAGE_VERTEX_BIT,
+                                           writeDrawPushConstants, false)
+                    .build(allocator))
 
   descriptor_writer_.clear();
   descriptor_writer_.writeBuffer(
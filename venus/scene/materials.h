@@ -36,6 +36,16 @@
 
 namespace venus::scene::materials {
 
+/// Writes the push constants of the built-in mesh shaders
+/// (engine::GraphicsEngine::Globals::Types::DrawPushConstants).
+/// \note The object transform is left out (identity) when instance transforms
+///       are given, so instances of a mesh get equal push constants and can
+///       be merged into instanced draws.
+/// \note Camera fields are not read, so writers can be registered as view
+///       independent (see Material::Instance::Config::setWritePushConstants).
+VeResult writeDrawPushConstants(hermes::mem::Block &block,
+                                const PushConstantsContext &ctx);
+
 class MAT_Empty : public Material::Writer {
 public:
   static Result<Material> material(const engine::GraphicsDevice &gd);
@@ -76,7 +86,14 @@ public:
 #ifdef VENUS_INCLUDE_GLTF
 class GLTF_MetallicRoughness : public Material::Writer {
 public:
-  static Result<Material> material(const engine::GraphicsDevice &gd);
+  /// \param gd
+  /// \param depth_prepass [def=false] Draws a depth prepass before shading
+  ///        (see Material::Pipeline::Config::setDepthPrepassConfig).
+  /// \param pass [def=MAIN_COLOR] Material pass (transparent materials can't
+  ///        have a depth prepass).
+  static Result<Material>
+  material(const engine::GraphicsDevice &gd, bool depth_prepass = false,
+           Material::Pass pass = Material::Pass::MAIN_COLOR);
 
   struct Data {
     hermes::geo::vec4 color_factors;
@@ -0,0 +1,417 @@
+/* Copyright (c) 2025, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+/// \file   mesh_optimizer.cpp
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-18
+
+#include <venus/scene/mesh_optimizer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+
+namespace venus::scene {
+
+// cache size assumed by the vertex cache scores (Forsyth)
+static constexpr u32 k_forsyth_cache_size = 32;
+// cache size simulated by the overdraw cluster split
+static constexpr u32 k_fifo_cache_size = 16;
+static constexpr u32 k_unused = ~0u;
+
+// Rewrites vertices and indices so vertex i goes to position remap[i].
+// Vertices mapped to k_unused are dropped.
+static void remapVertices(const std::vector<u32> &remap, u32 new_vertex_count,
+                          u32 stride, std::vector<u8> &vertices,
+                          std::vector<u32> &indices) {
+  std::vector<u8> remapped(static_cast<size_t>(new_vertex_count) * stride);
+  for (u32 i = 0; i < remap.size(); ++i)
+    if (remap[i] != k_unused)
+      std::memcpy(remapped.data() + static_cast<size_t>(remap[i]) * stride,
+                  vertices.data() + static_cast<size_t>(i) * stride, stride);
+  vertices = std::move(remapped);
+  for (auto &index : indices)
+    index = remap[index];
+}
+
+static u32 deduplicateVertices(const std::vector<u8> &vertices, u32 stride,
+                               u32 vertex_count, std::vector<u32> &remap) {
+  std::unordered_map<std::string_view, u32> unique;
+  unique.reserve(vertex_count);
+  remap.resize(vertex_count);
+  for (u32 i = 0; i < vertex_count; ++i) {
+    std::string_view key(reinterpret_cast<const char *>(vertices.data()) +
+                             static_cast<size_t>(i) * stride,
+                         stride);
+    auto it = unique.emplace(key, static_cast<u32>(unique.size())).first;
+    remap[i] = it->second;
+  }
+  return static_cast<u32>(unique.size());
+}
+
+static f32 forsythVertexScore(i32 cache_position, u32 live_triangles) {
+  if (!live_triangles)
+    return -1.f;
+  f32 score = 0.f;
+  if (cache_position >= 0) {
+    // the last triangle vertices get a fixed score, so the next triangle
+    // does not reuse them right away
+    if (cache_position < 3)
+      score = 0.75f;
+    else
+      score = std::pow(1.f - static_cast<f32>(cache_position - 3) /
+                                 (k_forsyth_cache_size - 3),
+                       1.5f);
+  }
+  // favour vertices with few triangles left
+  return score + 2.f / std::sqrt(static_cast<f32>(live_triangles));
+}
+
+// Linear-speed vertex cache optimization (Tom Forsyth).
+static std::vector<u32> optimizeVertexCache(const std::vector<u32> &indices,
+                                            u32 vertex_count) {
+  const u32 triangle_count = static_cast<u32>(indices.size() / 3);
+
+  // vertex -> live triangles adjacency
+  std::vector<u32> live(vertex_count, 0);
+  for (u32 index : indices)
+    live[index]++;
+  std::vector<u32> offsets(vertex_count + 1, 0);
+  for (u32 v = 0; v < vertex_count; ++v)
+    offsets[v + 1] = offsets[v] + live[v];
+  std::vector<u32> adjacency(indices.size());
+  {
+    std::vector<u32> fill(offsets.begin(), offsets.end() - 1);
+    for (u32 t = 0; t < triangle_count; ++t)
+      for (u32 k = 0; k < 3; ++k)
+        adjacency[fill[indices[t * 3 + k]]++] = t;
+  }
+
+  std::vector<i32> cache_position(vertex_count, -1);
+  std::vector<f32> vertex_score(vertex_count);
+  for (u32 v = 0; v < vertex_count; ++v)
+    vertex_score[v] = forsythVertexScore(-1, live[v]);
+  std::vector<f32> triangle_score(triangle_count, 0.f);
+  for (u32 t = 0; t < triangle_count; ++t)
+    for (u32 k = 0; k < 3; ++k)
+      triangle_score[t] += vertex_score[indices[t * 3 + k]];
+  std::vector<bool> emitted(triangle_count, false);
+
+  std::vector<u32> cache, new_cache;
+  cache.reserve(k_forsyth_cache_size + 3);
+  new_cache.reserve(k_forsyth_cache_size + 3);
+
+  std::vector<u32> result;
+  result.reserve(indices.size());
+
+  u32 best = k_unused;
+  u32 cursor = 0;
+  while (result.size() < indices.size()) {
+    if (best == k_unused) {
+      // no candidate around the cache, restart from the next triangle
+      while (emitted[cursor])
+        ++cursor;
+      best = cursor;
+    }
+    emitted[best] = true;
+    const u32 *triangle = &indices[best * 3];
+    result.insert(result.end(), triangle, triangle + 3);
+
+    // remove the triangle from the adjacency of its vertices
+    for (u32 k = 0; k < 3; ++k) {
+      u32 v = triangle[k];
+      auto begin = adjacency.begin() + offsets[v];
+      auto end = begin + live[v];
+      std::iter_swap(std::find(begin, end, best), end - 1);
+      live[v]--;
+    }
+
+    // triangle vertices go to the front of the (LRU) cache
+    new_cache.assign(triangle, triangle + 3);
+    for (u32 v : cache)
+      if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+        new_cache.push_back(v);
+
+    // update scores of every vertex that moved (or got evicted)
+    for (u32 i = 0; i < new_cache.size(); ++i) {
+      u32 v = new_cache[i];
+      cache_position[v] =
+          i < k_forsyth_cache_size ? static_cast<i32>(i) : -1;
+      f32 score = forsythVertexScore(cache_position[v], live[v]);
+      f32 delta = score - vertex_score[v];
+      vertex_score[v] = score;
+      for (u32 j = offsets[v]; j < offsets[v] + live[v]; ++j)
+        triangle_score[adjacency[j]] += delta;
+    }
+    if (new_cache.size() > k_forsyth_cache_size)
+      new_cache.resize(k_forsyth_cache_size);
+    std::swap(cache, new_cache);
+
+    // next triangle is the best one touching the cache
+    best = k_unused;
+    f32 best_score = -1.f;
+    for (u32 v : cache)
+      for (u32 j = offsets[v]; j < offsets[v] + live[v]; ++j)
+        if (triangle_score[adjacency[j]] > best_score) {
+          best_score = triangle_score[adjacency[j]];
+          best = adjacency[j];
+        }
+  }
+  return result;
+}
+
+// Simulates a FIFO cache, returns the number of misses of a triangle.
+static u32 fifoCacheMisses(const u32 *triangle, std::vector<u32> &timestamps,
+                           u32 &time, u32 cache_size) {
+  u32 misses = 0;
+  for (u32 k = 0; k < 3; ++k)
+    if (time - timestamps[triangle[k]] > cache_size) {
+      timestamps[triangle[k]] = time++;
+      misses++;
+    }
+  return misses;
+}
+
+// Splits triangles into clusters that can be reordered without degrading the
+// cache efficiency more than threshold. Returns the first triangle of each
+// cluster.
+static std::vector<u32> clusterTriangles(const std::vector<u32> &indices,
+                                         u32 vertex_count, f32 threshold) {
+  const u32 triangle_count = static_cast<u32>(indices.size() / 3);
+  std::vector<u32> timestamps(vertex_count, 0);
+  u32 time = k_fifo_cache_size + 1;
+
+  // hard boundaries: triangles missing all vertices do not depend on the
+  // cache state left by previous triangles
+  std::vector<u32> hard;
+  for (u32 t = 0; t < triangle_count; ++t)
+    if (fifoCacheMisses(&indices[t * 3], timestamps, time,
+                        k_fifo_cache_size) == 3)
+      hard.push_back(t);
+  hard.push_back(triangle_count);
+
+  // soft boundaries: split hard clusters where the (cold cache) ACMR of the
+  // current piece stays within the threshold
+  std::vector<u32> clusters;
+  for (u32 c = 0; c + 1 < hard.size(); ++c) {
+    u32 start = hard[c];
+    u32 end = hard[c + 1];
+    time += k_fifo_cache_size + 1;
+    u32 misses = 0;
+    for (u32 t = start; t < end; ++t)
+      misses += fifoCacheMisses(&indices[t * 3], timestamps, time,
+                                k_fifo_cache_size);
+    f32 limit = threshold * static_cast<f32>(misses) / (end - start);
+
+    clusters.push_back(start);
+    time += k_fifo_cache_size + 1;
+    misses = 0;
+    u32 count = 0;
+    for (u32 t = start; t < end; ++t) {
+      misses += fifoCacheMisses(&indices[t * 3], timestamps, time,
+                                k_fifo_cache_size);
+      count++;
+      if (t + 1 < end && static_cast<f32>(misses) <= limit * count) {
+        clusters.push_back(t + 1);
+        time += k_fifo_cache_size + 1;
+        misses = 0;
+        count = 0;
+      }
+    }
+  }
+  return clusters;
+}
+
+// Sorts triangle clusters so clusters facing away from the mesh center are
+// drawn first, they are more likely to occlude the rest.
+static std::vector<u32> optimizeOverdraw(const std::vector<u32> &indices,
+                                         const std::vector<u8> &vertices,
+                                         u32 stride, u32 position_offset,
+                                         u32 vertex_count, f32 threshold) {
+  auto position = [&](u32 v) {
+    f32 p[3];
+    std::memcpy(p,
+                vertices.data() + static_cast<size_t>(v) * stride +
+                    position_offset,
+                sizeof(p));
+    return hermes::geo::vec3(p[0], p[1], p[2]);
+  };
+
+  hermes::geo::vec3 mesh_centroid;
+  for (u32 v = 0; v < vertex_count; ++v)
+    mesh_centroid += position(v);
+  mesh_centroid = mesh_centroid / static_cast<f32>(vertex_count);
+
+  const u32 triangle_count = static_cast<u32>(indices.size() / 3);
+  std::vector<u32> clusters =
+      clusterTriangles(indices, vertex_count, threshold);
+  clusters.push_back(triangle_count);
+
+  std::vector<f32> sort_keys(clusters.size() - 1);
+  for (u32 c = 0; c + 1 < clusters.size(); ++c) {
+    hermes::geo::vec3 centroid, normal;
+    f32 area = 0.f;
+    for (u32 t = clusters[c]; t < clusters[c + 1]; ++t) {
+      auto p0 = position(indices[t * 3 + 0]);
+      auto p1 = position(indices[t * 3 + 1]);
+      auto p2 = position(indices[t * 3 + 2]);
+      auto n = hermes::geo::cross(p1 - p0, p2 - p0);
+      f32 triangle_area = n.length();
+      centroid += (p0 + p1 + p2) * (triangle_area / 3.f);
+      normal += n;
+      area += triangle_area;
+    }
+    if (area > 0.f)
+      centroid = centroid / area;
+    f32 normal_length = normal.length();
+    if (normal_length > 0.f)
+      normal = normal / normal_length;
+    sort_keys[c] = hermes::geo::dot(centroid - mesh_centroid, normal);
+  }
+
+  std::vector<u32> order(sort_keys.size());
+  for (u32 c = 0; c < order.size(); ++c)
+    order[c] = c;
+  std::stable_sort(order.begin(), order.end(), [&](u32 a, u32 b) {
+    return sort_keys[a] > sort_keys[b];
+  });
+
+  std::vector<u32> result;
+  result.reserve(indices.size());
+  for (u32 c : order)
+    result.insert(result.end(), indices.begin() + clusters[c] * 3,
+                  indices.begin() + clusters[c + 1] * 3);
+  return result;
+}
+
+static u32 optimizeVertexFetch(const std::vector<u32> &indices,
+                               u32 vertex_count, std::vector<u32> &remap) {
+  remap.assign(vertex_count, k_unused);
+  u32 next = 0;
+  for (u32 index : indices)
+    if (remap[index] == k_unused)
+      remap[index] = next++;
+  return next;
+}
+
+Result<OptimizedMesh> optimizeMesh(const mem::VertexLayout &layout,
+                                   const void *vertices, u32 vertex_count,
+                                   const std::vector<u32> &indices,
+                                   Model::Mesh::PrimitiveType primitive_type,
+                                   const MeshOptimization &options) {
+  const u32 stride = static_cast<u32>(layout.stride());
+  if (!vertices || !vertex_count || !stride)
+    return VeResult::inputError();
+  if (layout.streamCount() > 1)
+    return VeResult::incompatible();
+  for (u32 index : indices)
+    if (index >= vertex_count) {
+      HERMES_ERROR("Mesh index {} out of bounds ({} vertices).", index,
+                   vertex_count);
+      return VeResult::outOfBounds();
+    }
+
+  const bool is_triangle_list =
+      primitive_type == Model::Mesh::PrimitiveType::TRIANGLES &&
+      (indices.empty() ? vertex_count : indices.size()) % 3 == 0;
+
+  OptimizedMesh optimized;
+  optimized.vertex_count = vertex_count;
+  optimized.vertices.resize(static_cast<size_t>(vertex_count) * stride);
+  std::memcpy(optimized.vertices.data(), vertices, optimized.vertices.size());
+  optimized.indices = indices;
+  if (optimized.indices.empty()) {
+    optimized.indices.resize(vertex_count);
+    for (u32 i = 0; i < vertex_count; ++i)
+      optimized.indices[i] = i;
+  }
+
+  std::vector<u32> remap;
+
+  // 1. vertex deduplication (duplicates are identical, so they can all be
+  //    written to the same place)
+  if (options.deduplicate) {
+    u32 unique_count = deduplicateVertices(optimized.vertices, stride,
+                                           optimized.vertex_count, remap);
+    if (unique_count < optimized.vertex_count) {
+      remapVertices(remap, unique_count, stride, optimized.vertices,
+                    optimized.indices);
+      optimized.vertex_count = unique_count;
+    }
+  }
+
+  // 2. post-transform vertex cache
+  if (options.vertex_cache && is_triangle_list)
+    optimized.indices =
+        optimizeVertexCache(optimized.indices, optimized.vertex_count);
+
+  // 3. overdraw
+  if (options.overdraw && is_triangle_list) {
+    auto position_offset =
+        layout.componentOffset(mem::VertexLayout::ComponentType::Position);
+    auto position_format =
+        layout.componentFormat(mem::VertexLayout::ComponentType::Position);
+    if (position_offset && position_format &&
+        *position_format == VK_FORMAT_R32G32B32_SFLOAT &&
+        !layout.isQuantized())
+      optimized.indices = optimizeOverdraw(
+          optimized.indices, optimized.vertices, stride,
+          static_cast<u32>(*position_offset), optimized.vertex_count,
+          options.overdraw_threshold);
+  }
+
+  // 4. vertex fetch and 5. index remap
+  if (options.vertex_fetch) {
+    u32 used_count =
+        optimizeVertexFetch(optimized.indices, optimized.vertex_count, remap);
+    remapVertices(remap, used_count, stride, optimized.vertices,
+                  optimized.indices);
+    optimized.vertex_count = used_count;
+  }
+
+  return Result<OptimizedMesh>(std::move(optimized));
+}
+
+Result<OptimizedMesh> optimizeMesh(const Model::Mesh &mesh,
+                                   const MeshOptimization &options) {
+  return optimizeMesh(mesh.vertex_layout, *mesh.aos.data(),
+                      static_cast<u32>(mesh.aos.size()), mesh.indices,
+                      mesh.primitive_type, options);
+}
+
+f32 averageCacheMissRatio(const std::vector<u32> &indices, u32 vertex_count,
+                          u32 cache_size) {
+  const u32 triangle_count = static_cast<u32>(indices.size() / 3);
+  if (!triangle_count)
+    return 0.f;
+  std::vector<u32> timestamps(vertex_count, 0);
+  u32 time = cache_size + 1;
+  u32 misses = 0;
+  for (u32 t = 0; t < triangle_count; ++t)
+    misses += fifoCacheMisses(&indices[t * 3], timestamps, time, cache_size);
+  return static_cast<f32>(misses) / triangle_count;
+}
+
+} // namespace venus::scene
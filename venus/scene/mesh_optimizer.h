@@ -0,0 +1,98 @@
+/* Copyright (c) 2025, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+/// \file   mesh_optimizer.h
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-18
+/// \brief  Import-time optimization of mesh vertex and index data.
+
+#pragma once
+
+#include <venus/scene/model.h>
+
+namespace venus::scene {
+
+/// Steps performed by optimizeMesh. All steps are enabled by default.
+struct MeshOptimization {
+  /// Merges binary identical vertices.
+  bool deduplicate{true};
+  /// Reorders triangles for the post-transform vertex cache (Forsyth).
+  bool vertex_cache{true};
+  /// Reorders triangle clusters so outward facing clusters come first.
+  /// \note Requires a R32G32B32_SFLOAT position component.
+  bool overdraw{true};
+  /// Max ACMR increase (ratio) allowed by the cluster split of the overdraw
+  /// step. Larger values produce smaller clusters.
+  f32 overdraw_threshold{1.05f};
+  /// Reorders vertices by first use in the index buffer.
+  bool vertex_fetch{true};
+};
+
+/// Vertex and index data produced by optimizeMesh.
+struct OptimizedMesh {
+  std::vector<u8> vertices; //< interleaved vertex data.
+  std::vector<u32> indices;
+  u32 vertex_count{0};
+};
+
+/// \brief Optimizes vertex and index data for rendering.
+/// Steps run in order:
+///   1. vertex deduplication
+///   2. post-transform vertex cache reordering of triangles
+///   3. overdraw-aware ordering of triangle clusters
+///   4. vertex fetch reordering
+///   5. index buffer remapping to the final vertex order
+/// \note Triangle reordering (steps 2 and 3) only applies to triangle lists.
+/// \note Non-indexed data gets indices on output.
+/// \note Vertices not referenced by indices are removed by step 4.
+/// \param layout Layout of the input (single stream) vertex data.
+/// \param vertices Interleaved input vertex data.
+/// \param vertex_count Number of vertices in data.
+/// \param indices Input indices (may be empty).
+/// \param primitive_type [def=TRIANGLES]
+/// \param options [def={}] Steps to perform.
+/// \return Optimized vertex and index data, or error.
+HERMES_NODISCARD Result<OptimizedMesh>
+optimizeMesh(const mem::VertexLayout &layout, const void *vertices,
+             u32 vertex_count, const std::vector<u32> &indices,
+             Model::Mesh::PrimitiveType primitive_type =
+                 Model::Mesh::PrimitiveType::TRIANGLES,
+             const MeshOptimization &options = {});
+/// \brief Optimizes mesh vertex and index data for rendering.
+/// \note This can be used as an offline step, the result holds the data
+///       laid out as mesh.vertex_layout.
+/// \param mesh
+/// \param options [def={}] Steps to perform.
+/// \return Optimized vertex and index data, or error.
+HERMES_NODISCARD Result<OptimizedMesh>
+optimizeMesh(const Model::Mesh &mesh, const MeshOptimization &options = {});
+/// \brief Computes the average cache miss ratio (misses per triangle) of a
+///        FIFO post-transform vertex cache.
+/// \param indices Triangle list indices.
+/// \param vertex_count
+/// \param cache_size [def=16]
+/// \return ACMR, in [0.5, 3] for non-empty meshes.
+f32 averageCacheMissRatio(const std::vector<u32> &indices, u32 vertex_count,
+                          u32 cache_size = 16);
+
+} // namespace venus::scene
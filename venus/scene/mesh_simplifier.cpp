@@ -0,0 +1,450 @@
+/* Copyright (c) 2025, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+/// \file   mesh_simplifier.cpp
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-18
+
+#include <venus/scene/mesh_simplifier.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <queue>
+#include <string_view>
+#include <unordered_map>
+
+namespace venus::scene {
+
+// border planes weight, relative to the area of their triangle
+static constexpr f64 k_border_weight = 10.0;
+static constexpr u32 k_unused = ~0u;
+
+// Symmetric 4x4 quadric (upper triangle) and the sum of plane weights.
+struct Quadric {
+  f64 a[10]{};
+  f64 weight{0.0};
+};
+
+static void addPlane(Quadric &q, const hermes::geo::vec3 &n, f64 d, f64 w) {
+  const f64 p[4] = {n.x, n.y, n.z, d};
+  u32 k = 0;
+  for (u32 i = 0; i < 4; ++i)
+    for (u32 j = i; j < 4; ++j)
+      q.a[k++] += w * p[i] * p[j];
+  q.weight += w;
+}
+
+static void addQuadric(Quadric &q, const Quadric &r) {
+  for (u32 k = 0; k < 10; ++k)
+    q.a[k] += r.a[k];
+  q.weight += r.weight;
+}
+
+// mean squared distance between p and the quadric planes
+static f64 evaluate(const Quadric &q, const Quadric &r,
+                    const hermes::geo::vec3 &p) {
+  const f64 v[4] = {p.x, p.y, p.z, 1.0};
+  f64 e = 0.0;
+  u32 k = 0;
+  for (u32 i = 0; i < 4; ++i)
+    for (u32 j = i; j < 4; ++j, ++k)
+      e += (i == j ? 1.0 : 2.0) * (q.a[k] + r.a[k]) * v[i] * v[j];
+  f64 weight = q.weight + r.weight;
+  return weight > 0.0 ? std::max(e, 0.0) / weight : 0.0;
+}
+
+static u64 edgeKey(u32 a, u32 b) {
+  return a < b ? (static_cast<u64>(a) << 32) | b
+               : (static_cast<u64>(b) << 32) | a;
+}
+
+Result<SimplifiedMesh> simplifyMesh(const mem::VertexLayout &layout,
+                                    const void *vertices, u32 vertex_count,
+                                    const std::vector<u32> &indices,
+                                    const MeshSimplification &options) {
+  using ComponentType = mem::VertexLayout::ComponentType;
+
+  const u32 stride = static_cast<u32>(layout.stride());
+  if (!vertices || !vertex_count || !stride || indices.size() % 3)
+    return VeResult::inputError();
+  auto position_offset = layout.componentOffset(ComponentType::Position);
+  auto position_format = layout.componentFormat(ComponentType::Position);
+  if (layout.streamCount() > 1 || layout.isQuantized() || !position_offset ||
+      !position_format || *position_format != VK_FORMAT_R32G32B32_SFLOAT)
+    return VeResult::incompatible();
+
+  SimplifiedMesh simplified;
+  simplified.indices = indices;
+  if (indices.size() <= options.target_index_count)
+    return Result<SimplifiedMesh>(std::move(simplified));
+
+  // local vertices (only referenced vertices are processed)
+
+  std::unordered_map<u32, u32> local_of;
+  std::vector<u32> source_of;
+  std::vector<u32> triangles(indices.size());
+  for (u32 i = 0; i < indices.size(); ++i) {
+    if (indices[i] >= vertex_count)
+      return VeResult::outOfBounds();
+    auto it =
+        local_of.emplace(indices[i], static_cast<u32>(source_of.size())).first;
+    if (it->second == source_of.size())
+      source_of.emplace_back(indices[i]);
+    triangles[i] = it->second;
+  }
+  const u32 local_count = static_cast<u32>(source_of.size());
+  const u32 triangle_count = static_cast<u32>(triangles.size() / 3);
+
+  const u8 *data = reinterpret_cast<const u8 *>(vertices);
+  auto vertexData = [&](u32 v) {
+    return data + static_cast<size_t>(source_of[v]) * stride;
+  };
+
+  // positions, normalized by the mesh extent
+
+  std::vector<hermes::geo::vec3> positions(local_count);
+  for (u32 v = 0; v < local_count; ++v) {
+    f32 p[3];
+    std::memcpy(p, vertexData(v) + *position_offset, sizeof(p));
+    positions[v] = hermes::geo::vec3(p[0], p[1], p[2]);
+  }
+  hermes::geo::vec3 lower = positions[0], upper = positions[0];
+  for (const auto &p : positions)
+    for (u32 j = 0; j < 3; ++j) {
+      lower[j] = std::min(lower[j], p[j]);
+      upper[j] = std::max(upper[j], p[j]);
+    }
+  f32 extent = (upper - lower).length();
+  if (extent <= 0.f)
+    return Result<SimplifiedMesh>(std::move(simplified));
+  for (auto &p : positions)
+    p = (p - lower) / extent;
+
+  // attributes
+
+  std::vector<std::pair<u32, u32>> attribute_components; // offset, size
+  for (const auto &c : layout.components()) {
+    u32 size = 0;
+    if (c.type == ComponentType::Normal &&
+        c.format == VK_FORMAT_R32G32B32_SFLOAT)
+      size = 3;
+    else if (c.type == ComponentType::UV && c.format == VK_FORMAT_R32G32_SFLOAT)
+      size = 2;
+    else if (c.type == ComponentType::Color &&
+             c.format == VK_FORMAT_R32G32B32A32_SFLOAT)
+      size = 4;
+    else if (c.type == ComponentType::Color &&
+             c.format == VK_FORMAT_R32G32B32_SFLOAT)
+      size = 3;
+    if (size)
+      attribute_components.emplace_back(static_cast<u32>(c.offset), size);
+  }
+  u32 attribute_size = 0;
+  for (const auto &c : attribute_components)
+    attribute_size += c.second;
+  std::vector<f32> attributes(static_cast<size_t>(local_count) *
+                              attribute_size);
+  for (u32 v = 0, k = 0; v < local_count; ++v)
+    for (const auto &c : attribute_components) {
+      std::memcpy(&attributes[k], vertexData(v) + c.first,
+                  c.second * sizeof(f32));
+      k += c.second;
+    }
+  auto attributeDistance = [&](u32 a, u32 b) {
+    f32 d = 0.f;
+    for (u32 i = 0; i < attribute_size; ++i) {
+      f32 delta = attributes[a * attribute_size + i] -
+                  attributes[b * attribute_size + i];
+      d += delta * delta;
+    }
+    return d;
+  };
+
+  // welded topology: vertices sharing a position are wedges of the same
+  // welded vertex
+
+  std::vector<u32> welded(local_count);
+  std::vector<std::vector<u32>> wedges;
+  {
+    std::unordered_map<std::string_view, u32> unique;
+    for (u32 v = 0; v < local_count; ++v) {
+      std::string_view key(reinterpret_cast<const char *>(&positions[v]),
+                           sizeof(hermes::geo::vec3));
+      auto it = unique.emplace(key, static_cast<u32>(wedges.size())).first;
+      if (it->second == wedges.size())
+        wedges.emplace_back();
+      welded[v] = it->second;
+      wedges[it->second].emplace_back(v);
+    }
+  }
+  const u32 welded_count = static_cast<u32>(wedges.size());
+
+  std::vector<bool> alive(triangle_count, true);
+  u32 alive_count = triangle_count;
+  auto isDegenerate = [&](u32 t) {
+    u32 a = welded[triangles[t * 3]], b = welded[triangles[t * 3 + 1]],
+        c = welded[triangles[t * 3 + 2]];
+    return a == b || b == c || a == c;
+  };
+  for (u32 t = 0; t < triangle_count; ++t)
+    if (isDegenerate(t)) {
+      alive[t] = false;
+      alive_count--;
+    }
+
+  std::unordered_map<u64, u32> edge_use;
+  for (u32 t = 0; t < triangle_count; ++t)
+    if (alive[t])
+      for (u32 k = 0; k < 3; ++k)
+        edge_use[edgeKey(welded[triangles[t * 3 + k]],
+                         welded[triangles[t * 3 + (k + 1) % 3]])]++;
+
+  enum class Kind : u8 { Free, Border, Locked };
+  std::vector<Kind> kind(welded_count, Kind::Free);
+  for (u32 w = 0; w < welded_count; ++w)
+    if (wedges[w].size() > 1)
+      kind[w] = Kind::Locked;
+  for (const auto &edge : edge_use) {
+    u32 a = static_cast<u32>(edge.first >> 32);
+    u32 b = static_cast<u32>(edge.first & 0xffffffff);
+    for (u32 w : {a, b})
+      if (edge.second > 2)
+        kind[w] = Kind::Locked;
+      else if (edge.second == 1 && kind[w] == Kind::Free)
+        kind[w] = Kind::Border;
+  }
+
+  // quadrics
+
+  std::vector<Quadric> quadrics(welded_count);
+  for (u32 t = 0; t < triangle_count; ++t) {
+    if (!alive[t])
+      continue;
+    const u32 *tri = &triangles[t * 3];
+    const auto &p0 = positions[tri[0]];
+    auto normal = hermes::geo::cross(positions[tri[1]] - p0,
+                                     positions[tri[2]] - p0);
+    f32 area = normal.length();
+    if (area <= 0.f)
+      continue;
+    normal = normal / area;
+    for (u32 k = 0; k < 3; ++k)
+      addPlane(quadrics[welded[tri[k]]], normal,
+               -hermes::geo::dot(normal, positions[tri[k]]), area);
+    // border edges get a plane perpendicular to the triangle
+    for (u32 k = 0; k < 3; ++k) {
+      u32 a = tri[k], b = tri[(k + 1) % 3];
+      if (edge_use[edgeKey(welded[a], welded[b])] != 1)
+        continue;
+      auto edge = positions[b] - positions[a];
+      f32 length = edge.length();
+      if (length <= 0.f)
+        continue;
+      auto border_normal = hermes::geo::cross(edge / length, normal);
+      f64 d = -hermes::geo::dot(border_normal, positions[a]);
+      f64 w = k_border_weight * length * length;
+      addPlane(quadrics[welded[a]], border_normal, d, w);
+      addPlane(quadrics[welded[b]], border_normal, d, w);
+    }
+  }
+
+  // vertex -> triangles adjacency
+
+  std::vector<std::vector<u32>> adjacency(local_count);
+  for (u32 t = 0; t < triangle_count; ++t)
+    if (alive[t])
+      for (u32 k = 0; k < 3; ++k)
+        adjacency[triangles[t * 3 + k]].emplace_back(t);
+
+  // collapses (v -> u), cheapest first
+
+  struct Collapse {
+    f32 cost;
+    f32 error;
+    u32 v, u;
+    u32 v_version, u_version;
+    bool operator>(const Collapse &rhs) const { return cost > rhs.cost; }
+  };
+  std::priority_queue<Collapse, std::vector<Collapse>, std::greater<>> heap;
+  std::vector<u32> version(welded_count, 0);
+  std::vector<bool> collapsed(welded_count, false);
+
+  auto pushCollapse = [&](u32 v, u32 u) {
+    u32 wv = welded[v], wu = welded[u];
+    if (wv == wu || collapsed[wv] || collapsed[wu] || kind[wv] == Kind::Locked)
+      return;
+    if (kind[wv] == Kind::Border) {
+      auto it = edge_use.find(edgeKey(wv, wu));
+      if (it == edge_use.end() || it->second != 1)
+        return;
+    }
+    f64 error = evaluate(quadrics[wv], quadrics[wu], positions[u]);
+    Collapse collapse;
+    collapse.error = static_cast<f32>(std::sqrt(error));
+    collapse.cost = static_cast<f32>(
+        error + options.attribute_weight * attributeDistance(v, u));
+    collapse.v = v;
+    collapse.u = u;
+    collapse.v_version = version[wv];
+    collapse.u_version = version[wu];
+    heap.push(collapse);
+  };
+  auto pushNeighbourhood = [&](u32 v) {
+    for (u32 t : adjacency[v])
+      if (alive[t])
+        for (u32 k = 0; k < 3; ++k)
+          if (triangles[t * 3 + k] != v) {
+            pushCollapse(v, triangles[t * 3 + k]);
+            pushCollapse(triangles[t * 3 + k], v);
+          }
+  };
+  for (u32 v = 0; v < local_count; ++v)
+    pushNeighbourhood(v);
+
+  const f32 max_cost = options.max_error * options.max_error;
+  f32 max_error = 0.f;
+  while (!heap.empty() && alive_count * 3 > options.target_index_count) {
+    Collapse collapse = heap.top();
+    heap.pop();
+    if (collapse.cost > max_cost)
+      break;
+    const u32 v = collapse.v, u = collapse.u;
+    const u32 wv = welded[v], wu = welded[u];
+    if (collapsed[wv] || collapsed[wu] || version[wv] != collapse.v_version ||
+        version[wu] != collapse.u_version)
+      continue;
+
+    // v and u must still share a triangle, and moving v onto u must not
+    // flip the remaining triangles
+    bool adjacent = false;
+    bool flips = false;
+    for (u32 t : adjacency[v]) {
+      if (!alive[t])
+        continue;
+      const u32 *tri = &triangles[t * 3];
+      hermes::geo::vec3 p[3], q[3];
+      bool touches_u = false;
+      for (u32 k = 0; k < 3; ++k) {
+        touches_u |= welded[tri[k]] == wu;
+        p[k] = q[k] = positions[tri[k]];
+        if (tri[k] == v)
+          q[k] = positions[u];
+      }
+      adjacent |= touches_u;
+      if (touches_u)
+        continue;
+      auto n0 = hermes::geo::cross(p[1] - p[0], p[2] - p[0]);
+      auto n1 = hermes::geo::cross(q[1] - q[0], q[2] - q[0]);
+      if (hermes::geo::dot(n0, n1) <= 0.f) {
+        flips = true;
+        break;
+      }
+    }
+    if (!adjacent || flips)
+      continue;
+
+    // collapse (border edges of v become border edges of u)
+    if (kind[wv] == Kind::Border)
+      for (u32 t : adjacency[v]) {
+        if (!alive[t])
+          continue;
+        for (u32 k = 0; k < 3; ++k) {
+          u32 wx = welded[triangles[t * 3 + k]];
+          if (wx != wv && wx != wu && edge_use[edgeKey(wv, wx)] == 1)
+            edge_use[edgeKey(wu, wx)] = 1;
+        }
+      }
+    for (u32 t : adjacency[v]) {
+      if (!alive[t])
+        continue;
+      for (u32 k = 0; k < 3; ++k)
+        if (triangles[t * 3 + k] == v)
+          triangles[t * 3 + k] = u;
+      if (isDegenerate(t)) {
+        alive[t] = false;
+        alive_count--;
+      } else
+        adjacency[u].emplace_back(t);
+    }
+    adjacency[v].clear();
+    std::erase_if(adjacency[u], [&](u32 t) { return !alive[t]; });
+    addQuadric(quadrics[wu], quadrics[wv]);
+    collapsed[wv] = true;
+    version[wu]++;
+    max_error = std::max(max_error, collapse.error);
+
+    for (u32 w : wedges[wu])
+      pushNeighbourhood(w);
+  }
+
+  simplified.indices.clear();
+  simplified.indices.reserve(alive_count * 3);
+  for (u32 t = 0; t < triangle_count; ++t)
+    if (alive[t])
+      for (u32 k = 0; k < 3; ++k)
+        simplified.indices.emplace_back(source_of[triangles[t * 3 + k]]);
+  simplified.error = max_error * extent;
+  return Result<SimplifiedMesh>(std::move(simplified));
+}
+
+Result<std::vector<Model::Shape::Lod>>
+generateLods(const mem::VertexLayout &layout, const void *vertices,
+             u32 vertex_count, std::vector<u32> &indices, u32 index_base,
+             u32 index_count, const MeshLodGeneration &options) {
+  if (static_cast<size_t>(index_base) + index_count > indices.size())
+    return VeResult::outOfBounds();
+
+  std::vector<Model::Shape::Lod> lods;
+  std::vector<u32> source(indices.begin() + index_base,
+                          indices.begin() + index_base + index_count);
+  f32 error = 0.f;
+  for (u32 level = 0; level < options.lod_count; ++level) {
+    MeshSimplification simplification;
+    simplification.target_index_count =
+        static_cast<u32>(source.size() * options.reduction) / 3 * 3;
+    simplification.max_error = options.max_error;
+    simplification.attribute_weight = options.attribute_weight;
+    VENUS_DECLARE_OR_RETURN_BAD_RESULT(
+        SimplifiedMesh, simplified,
+        simplifyMesh(layout, vertices, vertex_count, source, simplification));
+    // stop when the simplification stalls
+    if (simplified.indices.empty() ||
+        simplified.indices.size() > source.size() * 0.95f)
+      break;
+    // each level simplifies the previous one, errors add up
+    error += simplified.error;
+
+    Model::Shape::Lod lod;
+    lod.index_base = static_cast<u32>(indices.size());
+    lod.index_count = static_cast<u32>(simplified.indices.size());
+    lod.error = error;
+    lods.emplace_back(lod);
+    indices.insert(indices.end(), simplified.indices.begin(),
+                   simplified.indices.end());
+    source = std::move(simplified.indices);
+  }
+  return Result<std::vector<Model::Shape::Lod>>(std::move(lods));
+}
+
+} // namespace venus::scene
@@ -0,0 +1,100 @@
+/* Copyright (c) 2025, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+/// \file   mesh_simplifier.h
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-18
+/// \brief  Mesh simplification and level of detail generation.
+
+#pragma once
+
+#include <venus/scene/model.h>
+
+namespace venus::scene {
+
+/// Options of simplifyMesh.
+struct MeshSimplification {
+  /// Number of indices to stop at (the error limit may stop it earlier).
+  u32 target_index_count{0};
+  /// Max collapse error, relative to the mesh extent (bounding box diagonal).
+  f32 max_error{1e-2f};
+  /// Weight of attribute (normal, uv, color) differences in the collapse
+  /// error. Larger values preserve attribute discontinuities.
+  f32 attribute_weight{1e-2f};
+};
+
+/// Indices produced by simplifyMesh.
+struct SimplifiedMesh {
+  std::vector<u32> indices;
+  f32 error{0.f}; //< geometric error, in object space units.
+};
+
+/// \brief Simplifies a triangle list through edge collapses.
+/// Vertices are collapsed onto neighbour vertices (half edge collapses)
+/// ordered by a quadric error metric (Garland-Heckbert) plus the difference
+/// of the vertex attributes. Only indices change, so the result can share the
+/// vertex buffer of the source mesh.
+/// \note Vertices on attribute seams (same position, different attributes)
+///       and non-manifold edges are kept, border vertices only slide along
+///       the border.
+/// \note Requires a R32G32B32_SFLOAT position component.
+/// \param layout Layout of the input (single stream) vertex data.
+/// \param vertices Interleaved vertex data.
+/// \param vertex_count Number of vertices in data.
+/// \param indices Triangle list indices (only referenced vertices are read).
+/// \param options
+/// \return Simplified indices and the resulting error, or error.
+HERMES_NODISCARD Result<SimplifiedMesh>
+simplifyMesh(const mem::VertexLayout &layout, const void *vertices,
+             u32 vertex_count, const std::vector<u32> &indices,
+             const MeshSimplification &options);
+
+/// Options of generateLods.
+struct MeshLodGeneration {
+  /// Max number of levels of detail, besides the source indices.
+  u32 lod_count{0};
+  /// Index count ratio between consecutive levels.
+  f32 reduction{0.5f};
+  /// Max collapse error of each level, relative to the mesh extent.
+  f32 max_error{5e-2f};
+  /// See MeshSimplification::attribute_weight.
+  f32 attribute_weight{1e-2f};
+};
+
+/// \brief Generates a chain of levels of detail from an index range. Each
+///        level simplifies the previous one and is appended to indices.
+/// \note Generation stops early when a level cannot be simplified further.
+/// \param layout Layout of the input (single stream) vertex data.
+/// \param vertices Interleaved vertex data.
+/// \param vertex_count Number of vertices in data.
+/// \param indices Index buffer receiving the new ranges.
+/// \param index_base First index of the source range.
+/// \param index_count Index count of the source range.
+/// \param options
+/// \return Generated levels (finest first), or error.
+HERMES_NODISCARD Result<std::vector<Model::Shape::Lod>>
+generateLods(const mem::VertexLayout &layout, const void *vertices,
+             u32 vertex_count, std::vector<u32> &indices, u32 index_base,
+             u32 index_count, const MeshLodGeneration &options);
+
+} // namespace venus::scene
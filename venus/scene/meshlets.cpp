@@ -0,0 +1,181 @@
+/* Copyright (c) 2025, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+/// \file   meshlets.cpp
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-18
+
+#include <venus/scene/meshlets.h>
+
+#include <hermes/geometry/point.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace venus::scene {
+
+static void computeMeshletBounds(
+    Meshlet &meshlet, const std::vector<hermes::geo::point3> &positions,
+    const std::vector<u32> &indices) {
+  const u32 first = meshlet.index_offset;
+  const u32 last = meshlet.index_offset + meshlet.index_count;
+
+  // bounding sphere (centered at the box center)
+
+  hermes::geo::point3 lower = positions[indices[first]];
+  hermes::geo::point3 upper = lower;
+  for (u32 i = first; i < last; ++i)
+    for (u32 d = 0; d < 3; ++d) {
+      lower[d] = std::min(lower[d], positions[indices[i]][d]);
+      upper[d] = std::max(upper[d], positions[indices[i]][d]);
+    }
+  hermes::geo::point3 center = lower + (upper - lower) * 0.5f;
+  f32 radius = 0.f;
+  for (u32 i = first; i < last; ++i)
+    radius = std::max(radius, (positions[indices[i]] - center).length());
+
+  // normal cone
+
+  std::vector<hermes::geo::vec3> normals;
+  std::vector<hermes::geo::point3> origins;
+  normals.reserve(meshlet.index_count / 3);
+  origins.reserve(meshlet.index_count / 3);
+  hermes::geo::vec3 axis;
+  for (u32 i = first; i + 2 < last; i += 3) {
+    const auto &p0 = positions[indices[i]];
+    auto n = hermes::geo::cross(positions[indices[i + 1]] - p0,
+                                positions[indices[i + 2]] - p0);
+    f32 length = n.length();
+    if (length <= 0.f)
+      continue;
+    normals.emplace_back(n / length);
+    origins.emplace_back(p0);
+    axis += normals.back();
+  }
+
+  for (u32 d = 0; d < 3; ++d) {
+    meshlet.center[d] = center[d];
+    meshlet.cone_apex[d] = center[d];
+  }
+  meshlet.radius = radius;
+  meshlet.cone_cutoff = 2.f;
+
+  f32 axis_length = axis.length();
+  if (normals.empty() || axis_length <= 0.f)
+    return;
+  axis = axis / axis_length;
+  f32 min_dp = 1.f;
+  for (const auto &n : normals)
+    min_dp = std::min(min_dp, hermes::geo::dot(axis, n));
+  // wide cones would rarely cull anything
+  if (min_dp <= 0.1f)
+    return;
+
+  // move the apex back until it sees all triangle planes from behind
+  f32 max_t = 0.f;
+  for (h_size t = 0; t < normals.size(); ++t) {
+    f32 dn = hermes::geo::dot(axis, normals[t]);
+    max_t = std::max(max_t,
+                     hermes::geo::dot(center - origins[t], normals[t]) / dn);
+  }
+  for (u32 d = 0; d < 3; ++d) {
+    meshlet.cone_apex[d] = center[d] - axis[d] * max_t;
+    meshlet.cone_axis[d] = axis[d];
+  }
+  meshlet.cone_cutoff = std::sqrt(1.f - min_dp * min_dp);
+}
+
+static u32 newVertexCount(const u32 *triangle, const std::vector<u32> &stamp,
+                          u32 id) {
+  u32 count = 0;
+  for (u32 k = 0; k < 3; ++k)
+    if (stamp[triangle[k]] != id && (k < 1 || triangle[k] != triangle[0]) &&
+        (k < 2 || triangle[k] != triangle[1]))
+      ++count;
+  return count;
+}
+
+Result<std::vector<Meshlet>>
+buildMeshlets(const mem::VertexLayout &layout, const void *vertices,
+              u32 vertex_count, const std::vector<u32> &indices,
+              u32 index_base, u32 index_count,
+              const MeshletGeneration &options) {
+  using ComponentType = mem::VertexLayout::ComponentType;
+
+  const u32 stride = static_cast<u32>(layout.stride());
+  if (!vertices || !vertex_count || !stride || index_count % 3 ||
+      options.max_vertices < 3 || !options.max_triangles)
+    return VeResult::inputError();
+  if (index_base + index_count > indices.size())
+    return VeResult::outOfBounds();
+  auto position_offset = layout.componentOffset(ComponentType::Position);
+  auto position_format = layout.componentFormat(ComponentType::Position);
+  if (layout.streamCount() > 1 || layout.isQuantized() || !position_offset ||
+      !position_format || *position_format != VK_FORMAT_R32G32B32_SFLOAT)
+    return VeResult::incompatible();
+
+  const u8 *data = reinterpret_cast<const u8 *>(vertices);
+  std::vector<hermes::geo::point3> positions(vertex_count);
+  for (u32 v = 0; v < vertex_count; ++v) {
+    f32 p[3];
+    std::memcpy(p, data + v * stride + *position_offset, sizeof(p));
+    positions[v] = hermes::geo::point3(p[0], p[1], p[2]);
+  }
+
+  // greedy scan: a vertex belongs to the current meshlet if it was stamped
+  // with the current meshlet id
+
+  std::vector<Meshlet> meshlets;
+  std::vector<u32> stamp(vertex_count, ~0u);
+  Meshlet meshlet;
+  meshlet.index_offset = index_base;
+  for (u32 i = index_base; i < index_base + index_count; i += 3) {
+    const u32 *triangle = &indices[i];
+    if (triangle[0] >= vertex_count || triangle[1] >= vertex_count ||
+        triangle[2] >= vertex_count)
+      return VeResult::outOfBounds();
+    auto id = static_cast<u32>(meshlets.size());
+    u32 new_vertices = newVertexCount(triangle, stamp, id);
+    if (meshlet.vertex_count + new_vertices > options.max_vertices ||
+        meshlet.index_count / 3 + 1 > options.max_triangles) {
+      computeMeshletBounds(meshlet, positions, indices);
+      meshlets.emplace_back(meshlet);
+      meshlet = {};
+      meshlet.index_offset = i;
+      new_vertices = newVertexCount(triangle, stamp, ++id);
+    }
+    for (u32 k = 0; k < 3; ++k)
+      stamp[triangle[k]] = id;
+    meshlet.vertex_count += new_vertices;
+    meshlet.index_count += 3;
+  }
+  if (meshlet.index_count) {
+    computeMeshletBounds(meshlet, positions, indices);
+    meshlets.emplace_back(meshlet);
+  }
+
+  return Result<std::vector<Meshlet>>(std::move(meshlets));
+}
+
+} // namespace venus::scene
@@ -0,0 +1,83 @@
+/* Copyright (c) 2025, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+/// \file   meshlets.h
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-18
+/// \brief  Meshlet (triangle cluster) generation.
+
+#pragma once
+
+#include <venus/mem/layout.h>
+
+namespace venus::scene {
+
+/// \brief Small cluster of triangles with its culling bounds.
+/// Meshlets address a contiguous range of the index buffer, so they can be
+/// drawn (or discarded) separately from the rest of the mesh.
+/// \note The layout matches the std430 struct read by
+///       shaders/meshlet_cull.comp.
+struct Meshlet {
+  f32 center[3]{};      //< bounding sphere center.
+  f32 radius{0.f};      //< bounding sphere radius.
+  f32 cone_apex[3]{};   //< normal cone apex.
+  f32 cone_cutoff{2.f}; //< cos of the cone angle (> 1 disables cone culling).
+  f32 cone_axis[3]{};   //< normal cone axis.
+  u32 padding0{0};
+  u32 index_offset{0}; //< first index of the meshlet in the index buffer.
+  u32 index_count{0};  //< index count (3 per triangle).
+  u32 vertex_count{0}; //< number of unique vertices.
+  u32 padding1{0};
+};
+
+static_assert(sizeof(Meshlet) == 64);
+
+/// Options of buildMeshlets.
+struct MeshletGeneration {
+  u32 max_vertices{64};   //< max unique vertices per meshlet.
+  u32 max_triangles{124}; //< max triangles per meshlet.
+};
+
+/// \brief Splits an index range into meshlets.
+/// Triangles are scanned in index order and grouped until a meshlet reaches
+/// its vertex or triangle limit. Each meshlet gets a bounding sphere and a
+/// normal cone: a meshlet is back facing from every point p for which
+/// dot(normalize(apex - p), axis) >= cutoff.
+/// \note Run after vertex cache optimization (see optimizeMesh), consecutive
+///       triangles then share most of their vertices.
+/// \note Requires a R32G32B32_SFLOAT position component.
+/// \param layout Layout of the input (single stream) vertex data.
+/// \param vertices Interleaved vertex data.
+/// \param vertex_count Number of vertices in data.
+/// \param indices Triangle list index buffer.
+/// \param index_base First index of the range.
+/// \param index_count Index count of the range.
+/// \param options
+/// \return Meshlets of the range (offsets relative to indices), or error.
+HERMES_NODISCARD Result<std::vector<Meshlet>>
+buildMeshlets(const mem::VertexLayout &layout, const void *vertices,
+              u32 vertex_count, const std::vector<u32> &indices,
+              u32 index_base, u32 index_count,
+              const MeshletGeneration &options = {});
+
+} // namespace venus::scene
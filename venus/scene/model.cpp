@@ -25,14 +25,162 @@
 /// \date   2025-07-30
 
 #include <venus/scene/model.h>
+
+#include <venus/scene/mesh_optimizer.h>
+#include <venus/scene/meshlets.h>
+#include <venus/scene/mesh_simplifier.h>
 #include <venus/utils/macros.h>
 
 #include <hermes/geometry/transform.h>
 
+#include <algorithm>
+#include <cstring>
+
 namespace venus::scene {
 
+static void writeVarint(std::vector<u8> &out, u32 value) {
+  while (value >= 0x80) {
+    out.emplace_back(static_cast<u8>(value | 0x80));
+    value >>= 7;
+  }
+  out.emplace_back(static_cast<u8>(value));
+}
+
+static u32 readVarint(const std::vector<u8> &in, h_size &pos) {
+  u32 value = 0;
+  for (u32 shift = 0; pos < in.size() && shift < 32; shift += 7) {
+    u8 byte = in[pos++];
+    value |= static_cast<u32>(byte & 0x7f) << shift;
+    if (!(byte & 0x80))
+      break;
+  }
+  return value;
+}
+
+// Vertex bytes are delta encoded per byte column (the same byte of the same
+// attribute tends to vary little between consecutive vertices) and the
+// resulting zero runs are collapsed into (0, run length) pairs.
+static std::vector<u8> compressVertices(const u8 *data, u32 stride,
+                                        u32 count) {
+  std::vector<u8> out;
+  u32 zero_run = 0;
+  for (u32 b = 0; b < stride; ++b) {
+    u8 previous = 0;
+    for (u32 i = 0; i < count; ++i) {
+      u8 value = data[i * stride + b];
+      u8 delta = static_cast<u8>(value - previous);
+      previous = value;
+      if (!delta) {
+        zero_run++;
+        continue;
+      }
+      if (zero_run) {
+        out.emplace_back(0);
+        writeVarint(out, zero_run);
+        zero_run = 0;
+      }
+      out.emplace_back(delta);
+    }
+  }
+  if (zero_run) {
+    out.emplace_back(0);
+    writeVarint(out, zero_run);
+  }
+  return out;
+}
+
+static std::vector<u8> decompressVertices(const std::vector<u8> &in,
+                                          u32 stride, u32 count) {
+  std::vector<u8> deltas;
+  deltas.reserve(static_cast<h_size>(stride) * count);
+  h_size pos = 0;
+  while (pos < in.size()) {
+    u8 byte = in[pos++];
+    if (byte)
+      deltas.emplace_back(byte);
+    else
+      deltas.resize(deltas.size() + readVarint(in, pos), 0);
+  }
+  deltas.resize(static_cast<h_size>(stride) * count, 0);
+
+  std::vector<u8> out(deltas.size());
+  h_size k = 0;
+  for (u32 b = 0; b < stride; ++b) {
+    u8 previous = 0;
+    for (u32 i = 0; i < count; ++i) {
+      previous = static_cast<u8>(previous + deltas[k++]);
+      out[i * stride + b] = previous;
+    }
+  }
+  return out;
+}
+
+// Indices are stored as zigzag varints of the difference to the previous
+// index, which is small for meshes with good vertex locality.
+static std::vector<u8> compressIndices(const std::vector<u32> &indices) {
+  std::vector<u8> out;
+  out.reserve(indices.size());
+  u32 previous = 0;
+  for (u32 index : indices) {
+    i32 delta = static_cast<i32>(index - previous);
+    previous = index;
+    writeVarint(out, (static_cast<u32>(delta) << 1) ^
+                         static_cast<u32>(delta >> 31));
+  }
+  return out;
+}
+
+static std::vector<u32> decompressIndices(const std::vector<u8> &in,
+                                          u32 count) {
+  std::vector<u32> out;
+  out.reserve(count);
+  h_size pos = 0;
+  u32 previous = 0;
+  for (u32 i = 0; i < count; ++i) {
+    u32 zigzag = readVarint(in, pos);
+    u32 delta = (zigzag >> 1) ^ (0u - (zigzag & 1));
+    previous += delta;
+    out.emplace_back(previous);
+  }
+  return out;
+}
+
 hermes::geo::bounds::bsphere3 Model::Mesh::computeBounds() const {
+  using ComponentType = mem::VertexLayout::ComponentType;
   hermes::geo::bounds::bsphere3 bounds;
+  const h_size vertex_count = aos.size();
+  auto position_offset = vertex_layout.componentOffset(ComponentType::Position);
+  auto position_format = vertex_layout.componentFormat(ComponentType::Position);
+  auto position_encoding =
+      vertex_layout.componentEncoding(ComponentType::Position);
+  if (!vertex_count || !position_offset || !position_format ||
+      !position_encoding)
+    return bounds;
+
+  hermes::geo::point3 lower, upper;
+  if (*position_encoding == mem::VertexLayout::Encoding::Quantized) {
+    // quantized positions cover [-1,1] of the dequantized box
+    for (u32 j = 0; j < 3; ++j) {
+      lower[j] = dequantization.offset[j] - dequantization.scale[j];
+      upper[j] = dequantization.offset[j] + dequantization.scale[j];
+    }
+  } else if (*position_format == VK_FORMAT_R32G32B32_SFLOAT ||
+             *position_format == VK_FORMAT_R32G32B32A32_SFLOAT) {
+    const u8 *data = reinterpret_cast<const u8 *>(*aos.data());
+    const h_size stride = aos.dataSize() / vertex_count;
+    for (h_size i = 0; i < vertex_count; ++i) {
+      f32 p[3];
+      std::memcpy(p, data + i * stride + *position_offset, sizeof(p));
+      for (u32 j = 0; j < 3; ++j) {
+        lower[j] = i ? std::min(lower[j], p[j]) : p[j];
+        upper[j] = i ? std::max(upper[j], p[j]) : p[j];
+      }
+    }
+  } else
+    return bounds;
+
+  bounds.setCenter((upper + hermes::geo::vec3(lower)) / 2.f);
+  bounds.setRadius(((upper - lower) / 2.f).length());
   return bounds;
 }
 
@@ -43,6 +191,17 @@ Result<Model> Model::Config::build() const {
   model.vertex_layout_ = vertex_layout_;
   model.vk_vertex_buffer_address_ = vk_vertex_buffer_address_;
   model.vk_index_buffer_address_ = vk_index_buffer_address_;
+  model.vk_transform_buffer_ = vk_transform_buffer_;
+  model.vk_transform_buffer_address_ = vk_transform_buffer_address_;
+  // positions are interleaved with other components by default
+  model.vk_position_buffer_ =
+      vk_position_buffer_ ? vk_position_buffer_ : vk_vertex_buffer_;
+  model.vk_position_buffer_address_ = vk_position_buffer_
+                                          ? vk_position_buffer_address_
+                                          : vk_vertex_buffer_address_;
+  model.vk_meshlet_buffer_ = vk_meshlet_buffer_;
+  model.vk_meshlet_buffer_address_ = vk_meshlet_buffer_address_;
+  model.dequantization_ = dequantization_;
   model.shapes_ = shapes_;
   return Result<Model>(std::move(model));
 }
@@ -80,14 +239,93 @@ VkDeviceAddress Model::transformBufferAddress() const {
   return vk_transform_buffer_address_;
 }
 
+VkBuffer Model::positionBuffer() const { return vk_position_buffer_; }
+
+VkDeviceAddress Model::positionBufferAddress() const {
+  return vk_position_buffer_address_;
+}
+
+VkDeviceSize Model::positionStride() const {
+  auto stream = vertex_layout_.componentStream(
+      mem::VertexLayout::ComponentType::Position);
+  return vertex_layout_.stride(stream ? *stream : 0);
+}
+
+VkBuffer Model::meshletBuffer() const { return vk_meshlet_buffer_; }
+
+VkDeviceAddress Model::meshletBufferAddress() const {
+  return vk_meshlet_buffer_address_;
+}
+
 const mem::VertexLayout &Model::vertexLayout() const { return vertex_layout_; }
 
+const mem::Dequantization &Model::dequantization() const {
+  return dequantization_;
+}
+
+void Model::relocate(const std::vector<mem::Relocation> &relocations) {
+  for (const auto &relocation : relocations) {
+    if (!relocation.old_buffer)
+      continue;
+    if (vk_vertex_buffer_ == relocation.old_buffer) {
+      vk_vertex_buffer_ = relocation.new_buffer;
+      vk_vertex_buffer_address_ = relocation.new_address;
+    }
+    if (vk_index_buffer_ == relocation.old_buffer) {
+      vk_index_buffer_ = relocation.new_buffer;
+      vk_index_buffer_address_ = relocation.new_address;
+    }
+    if (vk_transform_buffer_ == relocation.old_buffer) {
+      vk_transform_buffer_ = relocation.new_buffer;
+      vk_transform_buffer_address_ = relocation.new_address;
+    }
+    if (vk_position_buffer_ == relocation.old_buffer) {
+      vk_position_buffer_ = relocation.new_buffer;
+      vk_position_buffer_address_ = relocation.new_address;
+    }
+    if (vk_meshlet_buffer_ == relocation.old_buffer) {
+      vk_meshlet_buffer_ = relocation.new_buffer;
+      vk_meshlet_buffer_address_ = relocation.new_address;
+    }
+  }
+}
+
 AllocatedModel::Config AllocatedModel::Config::fromMesh(const Mesh &mesh) {
   AllocatedModel::Config config;
   config.mesh_ = mesh;
   return config;
 }
 
+VENUS_DEFINE_SET_CONFIG_FIELD_METHOD(AllocatedModel, setResidency, Residency,
+                                     residency_ = value)
+
+AllocatedModel::Config &AllocatedModel::Config::enableQuantization() {
+  quantize_ = true;
+  return *this;
+}
+
+AllocatedModel::Config &AllocatedModel::Config::enablePositionStream() {
+  separate_positions_ = true;
+  return *this;
+}
+
+AllocatedModel::Config &AllocatedModel::Config::enableOptimization() {
+  optimize_ = true;
+  return *this;
+}
+
+AllocatedModel::Config &AllocatedModel::Config::enableLods(u32 lod_count,
+                                                           f32 max_error) {
+  lod_count_ = lod_count;
+  lod_max_error_ = max_error;
+  return *this;
+}
+
+AllocatedModel::Config &AllocatedModel::Config::enableMeshlets() {
+  meshlets_ = true;
+  return *this;
+}
+
 Result<AllocatedModel>
 AllocatedModel::Config::build(const engine::GraphicsDevice &gd) const {
   AllocatedModel model;
@@ -97,78 +335,225 @@ AllocatedModel::Config::build(const engine::GraphicsDevice &gd) const {
     return VeResult::inputError();
   }
 
-  auto vertex_buffer_size = mesh_.aos.dataSize();
-  auto index_buffer_size = sizeof(u32) * mesh_.indices.size();
+  u32 vertex_count = static_cast<u32>(mesh_.aos.size());
+  const u8 *vertex_data = reinterpret_cast<const u8 *>(*mesh_.aos.data());
+  auto vertex_data_size = mesh_.aos.dataSize();
+  const std::vector<u32> *indices = &mesh_.indices;
+  mem::VertexLayout vertex_layout = mesh_.vertex_layout;
+  mem::Dequantization dequantization = mesh_.dequantization;
+
+  // optimization
+
+  OptimizedMesh optimized;
+  if (optimize_) {
+    VENUS_ASSIGN_OR_RETURN_BAD_RESULT(optimized, optimizeMesh(mesh_));
+    vertex_count = optimized.vertex_count;
+    vertex_data = optimized.vertices.data();
+    vertex_data_size = optimized.vertices.size();
+    indices = &optimized.indices;
+  }
+
+  // levels of detail (simplification reads the source float positions)
+
+  const u32 base_index_count = static_cast<u32>(indices->size());
+  std::vector<u32> lod_indices;
+  std::vector<Model::Shape::Lod> lods;
+  if (lod_count_ && base_index_count &&
+      mesh_.primitive_type == Mesh::PrimitiveType::TRIANGLES) {
+    lod_indices = *indices;
+    MeshLodGeneration lod_generation;
+    lod_generation.lod_count = lod_count_;
+    lod_generation.max_error = lod_max_error_;
+    VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
+        lods, generateLods(vertex_layout, vertex_data, vertex_count,
+                           lod_indices, 0, base_index_count, lod_generation));
+    indices = &lod_indices;
+  }
+
+  // meshlets (built on the full detail range)
+
+  std::vector<Meshlet> meshlets;
+  if (meshlets_ && base_index_count &&
+      mesh_.primitive_type == Mesh::PrimitiveType::TRIANGLES) {
+    VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
+        meshlets, buildMeshlets(vertex_layout, vertex_data, vertex_count,
+                                *indices, 0, base_index_count));
+  }
+
+  // 16-bit indices whenever the vertex count allows it
+
+  const VkIndexType index_type = mem::indexTypeFor(vertex_count);
+  VENUS_DECLARE_OR_RETURN_BAD_RESULT(std::vector<u8>, packed_indices,
+                                     mem::packIndices(*indices, index_type));
+  auto index_buffer_size = packed_indices.size();
+
+  // quantization
+
+  mem::QuantizedVertices quantized;
+  if (quantize_) {
+    VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
+        quantized,
+        mem::quantizeVertices(vertex_layout, vertex_data, vertex_count));
+    vertex_data = quantized.data.data();
+    vertex_data_size = quantized.data.size();
+    vertex_layout = quantized.layout;
+    dequantization = quantized.dequantization;
+  }
+
+  // vertex streams (the host copy stays interleaved)
+
+  const mem::VertexLayout host_vertex_layout = vertex_layout;
+  const u8 *vertex_buffer_data = vertex_data;
+  auto vertex_buffer_size = vertex_data_size;
+  // a position only layout is already a dense position stream
+  bool separate_positions =
+      separate_positions_ && vertex_layout.components().size() > 1;
+  mem::VertexStreams streams;
+  if (separate_positions) {
+    VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
+        streams,
+        mem::separateStream(vertex_layout, vertex_data, vertex_count));
+    vertex_layout = streams.layout;
+    vertex_buffer_data = streams.data[0].data();
+    vertex_buffer_size = streams.data[0].size();
+  }
 
   VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
       model.storage_.vertices,
-      mem::AllocatedBuffer::Config ::forStorage(
-          vertex_buffer_size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT)
-          .enableShaderDeviceAddress()
+      mem::AllocatedBuffer::Config ::forVertices(vertex_buffer_size)
           // TODO this is RT only
           //.addUsage(
           //    VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR)
-          .setDeviceLocal()
+          .enableRelocation()
           .build(*gd));
 
+  if (separate_positions) {
+    VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
+        model.storage_.positions,
+        mem::AllocatedBuffer::Config ::forVertices(streams.data[1].size())
+            .enableRelocation()
+            .build(*gd));
+  }
+
   if (index_buffer_size) {
     VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
         model.storage_.indices,
-        mem::AllocatedBuffer::Config ::forStorage(
+        mem::AllocatedBuffer::Config ::forDirectWrite(
             index_buffer_size, VK_BUFFER_USAGE_INDEX_BUFFER_BIT)
-            .enableShaderDeviceAddress()
             // TODO this is RT only
             //.addUsage(
             //    VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR)
-            .setDeviceLocal()
+            .enableRelocation()
+            .build(*gd));
+  }
+
+  if (!meshlets.empty()) {
+    VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
+        model.storage_.meshlets,
+        mem::AllocatedBuffer::Config ::forDirectWrite(
+            sizeof(Meshlet) * meshlets.size(), 0)
+            .enableRelocation()
             .build(*gd));
   }
 
   VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
       model.storage_.transform,
-      mem::AllocatedBuffer::Config ::forStorage(
+      mem::AllocatedBuffer::Config ::forDirectWrite(
           sizeof(hermes::geo::Transform), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT)
-          .enableShaderDeviceAddress()
           // TODO this is RT only
           //.addUsage(
           //    VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR)
-          .setDeviceLocal()
           .build(*gd));
 
-  // copy data
+  // copy data (host visible buffers are written directly)
 
   pipeline::BufferWritter buffer_writter;
-  buffer_writter.addBuffer(*model.storage_.vertices, *mesh_.aos.data(),
+  buffer_writter.addBuffer(model.storage_.vertices, vertex_buffer_data,
                            static_cast<u32>(vertex_buffer_size));
 
+  if (separate_positions) {
+    buffer_writter.addBuffer(model.storage_.positions, streams.data[1].data(),
+                             static_cast<u32>(streams.data[1].size()));
+  }
+
   if (index_buffer_size) {
-    buffer_writter.addBuffer(*model.storage_.indices, mesh_.indices.data(),
+    buffer_writter.addBuffer(model.storage_.indices, packed_indices.data(),
                              static_cast<u32>(index_buffer_size));
   }
 
+  if (!meshlets.empty()) {
+    buffer_writter.addBuffer(
+        model.storage_.meshlets, meshlets.data(),
+        static_cast<u32>(sizeof(Meshlet) * meshlets.size()));
+  }
+
   hermes::geo::Transform identity;
-  buffer_writter.addBuffer(*model.storage_.transform, &identity,
+  buffer_writter.addBuffer(model.storage_.transform, &identity,
                            sizeof(hermes::geo::Transform));
 
   VENUS_RETURN_BAD_RESULT(buffer_writter.immediateSubmit(gd));
 
-  model.mesh_ = mesh_;
+  // host residency
+
+  model.residency_ = residency_;
+  model.vertex_count_ = vertex_count;
+  model.index_count_ = static_cast<u32>(indices->size());
+  model.index_type_ = index_type;
+  model.vertex_stride_ =
+      vertex_count ? static_cast<u32>(vertex_data_size / vertex_count) : 0;
+  model.host_vertex_layout_ = host_vertex_layout;
+  model.primitive_type_ = mesh_.primitive_type;
+  model.bounds_ = mesh_.computeBounds();
+  switch (residency_) {
+  case Residency::KEEP:
+    if (!quantize_ && !optimize_ && lods.empty()) {
+      model.mesh_ = mesh_;
+      break;
+    }
+    // the source data is replaced by the uploaded (converted) one
+    model.host_vertices_.assign(vertex_data, vertex_data + vertex_data_size);
+    model.mesh_.vertex_layout = host_vertex_layout;
+    model.mesh_.indices = *indices;
+    model.mesh_.primitive_type = mesh_.primitive_type;
+    model.mesh_.dequantization = dequantization;
+    break;
+  case Residency::COMPRESS:
+    model.compressed_vertices_ = compressVertices(
+        vertex_data, model.vertex_stride_, model.vertex_count_);
+    model.compressed_indices_ = compressIndices(*indices);
+    break;
+  case Residency::RELEASE:
+    break;
+  }
+
   model.vk_vertex_buffer_ = *model.storage_.vertices;
   model.vk_index_buffer_ = *model.storage_.indices;
   model.vk_transform_buffer_ = *model.storage_.transform;
   model.vk_vertex_buffer_address_ = model.storage_.vertices.deviceAddress();
   model.vk_index_buffer_address_ = model.storage_.indices.deviceAddress();
   model.vk_transform_buffer_address_ = model.storage_.transform.deviceAddress();
-  model.vertex_layout_ = mesh_.vertex_layout;
+  const auto &position_storage =
+      separate_positions ? model.storage_.positions : model.storage_.vertices;
+  model.vk_position_buffer_ = *position_storage;
+  model.vk_position_buffer_address_ = position_storage.deviceAddress();
+  if (!meshlets.empty()) {
+    model.vk_meshlet_buffer_ = *model.storage_.meshlets;
+    model.vk_meshlet_buffer_address_ = model.storage_.meshlets.deviceAddress();
+  }
+  model.vertex_layout_ = vertex_layout;
+  model.dequantization_ = dequantization;
 
   // setup single shape for whole model
 
   Model::Shape shape;
-  shape.bounds = model.mesh_.computeBounds();
+  shape.bounds = model.bounds_;
   shape.material_instance = {};
-  shape.index_count = static_cast<u32>(model.mesh_.indices.size());
+  shape.index_count = base_index_count;
   shape.index_base = 0;
-  shape.vertex_count = static_cast<u32>(model.mesh_.aos.size());
+  shape.vertex_count = model.vertex_count_;
+  shape.lods = std::move(lods);
+  shape.meshlet_count = static_cast<u32>(meshlets.size());
+  shape.index_type = index_type;
 
   model.shapes_.emplace_back(shape);
 
@@ -188,9 +573,23 @@ AllocatedModel &AllocatedModel::operator=(AllocatedModel &&rhs) noexcept {
 void AllocatedModel::destroy() noexcept {
   storage_.vertices.destroy();
   storage_.indices.destroy();
+  storage_.transform.destroy();
+  storage_.positions.destroy();
+  storage_.meshlets.destroy();
   HERMES_CHECK_HE_RESULT(mesh_.aos.clear());
   mesh_.indices.clear();
   mesh_.vertex_layout.clear();
+  host_vertex_layout_.clear();
+  host_vertices_.clear();
+  host_vertices_.shrink_to_fit();
+  compressed_vertices_.clear();
+  compressed_vertices_.shrink_to_fit();
+  compressed_indices_.clear();
+  compressed_indices_.shrink_to_fit();
+  vertex_stride_ = 0;
+  vertex_count_ = 0;
+  index_count_ = 0;
+  index_type_ = VK_INDEX_TYPE_UINT32;
 
   vk_index_buffer_ = VK_NULL_HANDLE;
   vk_vertex_buffer_ = VK_NULL_HANDLE;
@@ -199,18 +598,96 @@ void AllocatedModel::destroy() noexcept {
   vk_vertex_buffer_address_ = 0;
   vk_index_buffer_address_ = 0;
   vk_transform_buffer_address_ = 0;
+  vk_position_buffer_ = VK_NULL_HANDLE;
+  vk_position_buffer_address_ = 0;
+  vk_meshlet_buffer_ = VK_NULL_HANDLE;
+  vk_meshlet_buffer_address_ = 0;
 }
 
 void AllocatedModel::swap(AllocatedModel &rhs) {
   VENUS_SWAP_FIELD_WITH_RHS(storage_.vertices);
   VENUS_SWAP_FIELD_WITH_RHS(storage_.indices);
+  VENUS_SWAP_FIELD_WITH_RHS(storage_.transform);
+  VENUS_SWAP_FIELD_WITH_RHS(storage_.positions);
+  VENUS_SWAP_FIELD_WITH_RHS(storage_.meshlets);
   VENUS_SWAP_FIELD_WITH_RHS(mesh_);
   VENUS_SWAP_FIELD_WITH_RHS(shapes_);
   VENUS_SWAP_FIELD_WITH_RHS(vk_vertex_buffer_);
   VENUS_SWAP_FIELD_WITH_RHS(vk_index_buffer_);
   VENUS_SWAP_FIELD_WITH_RHS(vk_vertex_buffer_address_);
   VENUS_SWAP_FIELD_WITH_RHS(vk_index_buffer_address_);
+  VENUS_SWAP_FIELD_WITH_RHS(vk_transform_buffer_);
+  VENUS_SWAP_FIELD_WITH_RHS(vk_transform_buffer_address_);
+  VENUS_SWAP_FIELD_WITH_RHS(vk_position_buffer_);
+  VENUS_SWAP_FIELD_WITH_RHS(vk_position_buffer_address_);
+  VENUS_SWAP_FIELD_WITH_RHS(vk_meshlet_buffer_);
+  VENUS_SWAP_FIELD_WITH_RHS(vk_meshlet_buffer_address_);
   VENUS_SWAP_FIELD_WITH_RHS(vertex_layout_);
+  VENUS_SWAP_FIELD_WITH_RHS(dequantization_);
+  VENUS_SWAP_FIELD_WITH_RHS(residency_);
+  VENUS_SWAP_FIELD_WITH_RHS(host_vertex_layout_);
+  VENUS_SWAP_FIELD_WITH_RHS(host_vertices_);
+  VENUS_SWAP_FIELD_WITH_RHS(compressed_vertices_);
+  VENUS_SWAP_FIELD_WITH_RHS(compressed_indices_);
+  VENUS_SWAP_FIELD_WITH_RHS(vertex_stride_);
+  VENUS_SWAP_FIELD_WITH_RHS(vertex_count_);
+  VENUS_SWAP_FIELD_WITH_RHS(index_count_);
+  VENUS_SWAP_FIELD_WITH_RHS(index_type_);
+  VENUS_SWAP_FIELD_WITH_RHS(primitive_type_);
+  VENUS_SWAP_FIELD_WITH_RHS(bounds_);
+}
+
+AllocatedModel::Residency AllocatedModel::residency() const {
+  return residency_;
+}
+
+u32 AllocatedModel::vertexCount() const { return vertex_count_; }
+
+u32 AllocatedModel::indexCount() const { return index_count_; }
+
+VkIndexType AllocatedModel::indexType() const { return index_type_; }
+
+Model::Mesh::PrimitiveType AllocatedModel::primitiveType() const {
+  return primitive_type_;
+}
+
+const hermes::geo::bounds::bsphere3 &AllocatedModel::bounds() const {
+  return bounds_;
+}
+
+Result<std::vector<u8>> AllocatedModel::vertexData() const {
+  switch (residency_) {
+  case Residency::KEEP: {
+    if (!host_vertices_.empty())
+      return Result<std::vector<u8>>(host_vertices_);
+    auto data = reinterpret_cast<const u8 *>(*mesh_.aos.data());
+    return Result<std::vector<u8>>(
+        std::vector<u8>(data, data + mesh_.aos.dataSize()));
+  }
+  case Residency::COMPRESS:
+    return Result<std::vector<u8>>(decompressVertices(
+        compressed_vertices_, vertex_stride_, vertex_count_));
+  case Residency::RELEASE:
+    break;
+  }
+  return VeResult::notFound();
+}
+
+const mem::VertexLayout &AllocatedModel::hostVertexLayout() const {
+  return host_vertex_layout_;
+}
+
+Result<std::vector<u32>> AllocatedModel::indexData() const {
+  switch (residency_) {
+  case Residency::KEEP:
+    return Result<std::vector<u32>>(mesh_.indices);
+  case Residency::COMPRESS:
+    return Result<std::vector<u32>>(
+        decompressIndices(compressed_indices_, index_count_));
+  case Residency::RELEASE:
+    break;
+  }
+  return VeResult::notFound();
 }
 
 } // namespace venus::scene
@@ -53,6 +53,8 @@ public:
     hermes::mem::AoS aos;
     std::vector<u32> indices;
     PrimitiveType primitive_type{PrimitiveType::TRIANGLES};
+    /// Position dequantization (identity for non-quantized meshes).
+    mem::Dequantization dequantization;
 
     hermes::geo::bounds::bsphere3 computeBounds() const;
   };
@@ -61,6 +63,8 @@ public:
     BufferType vertices;
     BufferType indices;
     BufferType transform;
+    BufferType positions; //< position stream (if positions are separated).
+    BufferType meshlets;  //< meshlet descriptors (if meshlets are built).
   };
 
   /// Model surface/piece that may be treated as a separate mesh.
@@ -68,12 +72,25 @@ public:
   ///       count must be greater than zero. This determines how this shape
   ///       will be rendered.
   struct Shape {
+    /// Coarser index range of the shape, sharing the shape vertices.
+    struct Lod {
+      u32 index_base{0};  //< where this level starts in the index buffer.
+      u32 index_count{0}; //< index count of this level.
+      f32 error{0.f};     //< geometric error (object space) of this level.
+    };
     hermes::geo::bounds::bsphere3 bounds; //< spatial bounds of this shape.
     scene::Material::Instance::Ptr
         material_instance; //< material for this shape.
     u32 index_base{0};     //< where this shape starts in the index buffer.
     u32 index_count{0};    //< index count of this shape in the index buffer.
     u32 vertex_count{0};   //< vertex count of this shape in the vertex buffer
+    std::vector<Lod> lods; //< levels of detail (finest first), if any.
+    u32 meshlet_base{0};   //< first meshlet of the shape.
+    u32 meshlet_count{0};  //< meshlet count of the shape (zero if none).
+
+    /// Type of the indices in the index buffer.
+    /// \note Shapes of the same model share the index buffer index type.
+    VkIndexType index_type{VK_INDEX_TYPE_UINT32};
   };
 
   /// Builder for model.
@@ -87,20 +104,37 @@ public:
     /// \param format
     Derived &pushVertexComponent(mem::VertexLayout::ComponentType component,
                                  VkFormat format);
+    /// Sets the whole vertex layout (replacing pushed components).
+    /// \param vertex_layout
+    Derived &setVertexLayout(const mem::VertexLayout &vertex_layout);
     Derived &setVertices(VkBuffer vk_vertex_buffer, VkDeviceAddress vk_address);
     Derived &setIndices(VkBuffer vk_index_buffer, VkDeviceAddress vk_address);
     Derived &setTransform(VkBuffer vk_transform_buffer,
                           VkDeviceAddress vk_address);
+    /// Sets the buffer holding the position stream.
+    /// \note If not set, positions are read from the vertex buffer.
+    Derived &setPositions(VkBuffer vk_position_buffer,
+                          VkDeviceAddress vk_address);
+    /// \param dequantization Position dequantization of quantized vertices.
+    Derived &setDequantization(const mem::Dequantization &dequantization);
+    /// Sets the buffer holding the meshlets of the shapes (see Meshlet).
+    Derived &setMeshlets(VkBuffer vk_meshlet_buffer,
+                         VkDeviceAddress vk_address);
 
   protected:
     VkBuffer vk_vertex_buffer_{VK_NULL_HANDLE};
     VkBuffer vk_index_buffer_{VK_NULL_HANDLE};
     VkBuffer vk_transform_buffer_{VK_NULL_HANDLE};
+    VkBuffer vk_position_buffer_{VK_NULL_HANDLE};
+    VkBuffer vk_meshlet_buffer_{VK_NULL_HANDLE};
     VkDeviceAddress vk_vertex_buffer_address_{0};
     VkDeviceAddress vk_index_buffer_address_{0};
     VkDeviceAddress vk_transform_buffer_address_{0};
+    VkDeviceAddress vk_position_buffer_address_{0};
+    VkDeviceAddress vk_meshlet_buffer_address_{0};
     std::vector<Shape> shapes_;
     mem::VertexLayout vertex_layout_;
+    mem::Dequantization dequantization_;
   };
 
   struct Config : public Setup<Config> {
@@ -121,17 +155,41 @@ public:
   VkDeviceAddress vertexBufferAddress() const;
   VkDeviceAddress indexBufferAddress() const;
   VkDeviceAddress transformBufferAddress() const;
+  /// \note This is the vertex buffer, unless positions are stored in a
+  ///       separate stream.
+  /// \return Buffer holding vertex positions.
+  VkBuffer positionBuffer() const;
+  /// \return Device address of the buffer holding vertex positions.
+  VkDeviceAddress positionBufferAddress() const;
+  /// \return Distance (in bytes) between consecutive positions.
+  VkDeviceSize positionStride() const;
+  /// \note Shape meshlets start at Shape::meshlet_base in this buffer.
+  /// \return Buffer holding meshlets, if any.
+  VkBuffer meshletBuffer() const;
+  /// \return Device address of the meshlet buffer, if any.
+  VkDeviceAddress meshletBufferAddress() const;
   const mem::VertexLayout &vertexLayout() const;
+  /// \note Shaders reading quantized vertices need this to recover positions.
+  /// \return Position dequantization of the vertex buffer.
+  const mem::Dequantization &dequantization() const;
+  /// Replaces buffer handles and device addresses of moved buffers.
+  /// \param relocations Handles replaced by a defragmentation pass.
+  void relocate(const std::vector<mem::Relocation> &relocations);
 
 protected:
   std::vector<Shape> shapes_;
   VkBuffer vk_vertex_buffer_{VK_NULL_HANDLE};
   VkBuffer vk_index_buffer_{VK_NULL_HANDLE};
   VkBuffer vk_transform_buffer_{VK_NULL_HANDLE};
+  VkBuffer vk_position_buffer_{VK_NULL_HANDLE};
+  VkBuffer vk_meshlet_buffer_{VK_NULL_HANDLE};
   VkDeviceAddress vk_vertex_buffer_address_{0};
   VkDeviceAddress vk_index_buffer_address_{0};
   VkDeviceAddress vk_transform_buffer_address_{0};
+  VkDeviceAddress vk_position_buffer_address_{0};
+  VkDeviceAddress vk_meshlet_buffer_address_{0};
   mem::VertexLayout vertex_layout_;
+  mem::Dequantization dequantization_;
 
 #ifdef VENUS_INCLUDE_DEBUG_TRAITS
   friend struct hermes::DebugTraits<Model>;
@@ -140,6 +198,11 @@ protected:
 
 VENUS_DEFINE_SETUP_METHOD(Model, addShape, const Model::Shape &,
                           shapes_.emplace_back(value));
+VENUS_DEFINE_SETUP_SET_FIELD_METHOD(Model, setVertexLayout,
+                                    const mem::VertexLayout &, vertex_layout_);
+VENUS_DEFINE_SETUP_SET_FIELD_METHOD(Model, setDequantization,
+                                    const mem::Dequantization &,
+                                    dequantization_);
 
 template <typename Derived>
 Derived &Model::Setup<Derived>::setVertices(VkBuffer vk_vertex_buffer,
@@ -165,6 +228,22 @@ Derived &Model::Setup<Derived>::setTransform(VkBuffer vk_transform_buffer,
   return static_cast<Derived &>(*this);
 }
 
+template <typename Derived>
+Derived &Model::Setup<Derived>::setPositions(VkBuffer vk_position_buffer,
+                                             VkDeviceAddress vk_address) {
+  vk_position_buffer_ = vk_position_buffer;
+  vk_position_buffer_address_ = vk_address;
+  return static_cast<Derived &>(*this);
+}
+
+template <typename Derived>
+Derived &Model::Setup<Derived>::setMeshlets(VkBuffer vk_meshlet_buffer,
+                                            VkDeviceAddress vk_address) {
+  vk_meshlet_buffer_ = vk_meshlet_buffer;
+  vk_meshlet_buffer_address_ = vk_address;
+  return static_cast<Derived &>(*this);
+}
+
 template <typename Derived>
 Derived &Model::Setup<Derived>::pushVertexComponent(
     mem::VertexLayout::ComponentType component, VkFormat format) {
@@ -176,6 +255,14 @@ class AllocatedModel : public Model {
 public:
   using Ptr = hermes::Ref<AllocatedModel>;
 
+  /// Defines how the host copy of the mesh is kept once uploaded to the
+  /// device. Bounds, counts and vertex layout are always kept.
+  enum class Residency {
+    KEEP,     //< keep the full mesh in host memory.
+    RELEASE,  //< free vertex and index data after upload.
+    COMPRESS, //< keep a losslessly compressed copy of vertex and index data.
+  };
+
   struct Config {
     /// Sets the model mesh from the resulting mesh a given function and its
     /// parameters.
@@ -197,6 +284,37 @@ public:
     /// Sets material_instance for all shapes in this model.
     /// \param material_instance
     Config &setMaterial(const Material::Instance::Ptr material_instance);
+    /// Sets how mesh data is kept in host memory after upload.
+    /// \note Default is Residency::KEEP.
+    /// \param residency
+    Config &setResidency(Residency residency);
+    /// Converts vertices into compact formats before upload (see
+    /// mem::quantizeVertices). The model vertex layout and dequantization
+    /// then describe the quantized data.
+    /// \note Shaders must decode vertices (see shaders/venus/quantization.glsl)
+    /// \note The built-in mesh shader decodes quantized vertices of the glTF
+    ///       import layout (see graph::GLTF_Node::from).
+    Config &enableQuantization();
+    /// Stores positions in a separate buffer (stream 1), the remaining
+    /// components stay interleaved in the vertex buffer (stream 0).
+    /// \note See mem::separateStream.
+    /// \note The built-in mesh shader reads positions from the position
+    ///       stream (see scene::materials::writeDrawPushConstants).
+    Config &enablePositionStream();
+    /// Optimizes vertex and index order before upload (see optimizeMesh).
+    /// \note Vertex and index counts may change (deduplication).
+    Config &enableOptimization();
+    /// Generates levels of detail of the mesh (see generateLods). Levels are
+    /// stored as extra index ranges in the index buffer (see Shape::lods).
+    /// \note Requires a triangle list with a R32G32B32_SFLOAT position.
+    /// \param lod_count Max number of levels besides the full mesh.
+    /// \param max_error [def=5e-2] Max error of each level, relative to the
+    ///        mesh extent.
+    Config &enableLods(u32 lod_count, f32 max_error = 5e-2f);
+    /// Splits the mesh into meshlets (see buildMeshlets), so it can be culled
+    /// per cluster. Meshlets cover the full detail index range.
+    /// \note Requires a triangle list with a R32G32B32_SFLOAT position.
+    Config &enableMeshlets();
     /// Creates an allocated model from this configuration.
     /// \note If no shapes are defined, a single shape encompassing the whole
     ///       model is created.
@@ -205,16 +323,59 @@ public:
   private:
     Model::Mesh mesh_;
     Material::Instance::Ptr material_instance_;
+    Residency residency_{Residency::KEEP};
+    bool quantize_{false};
+    bool separate_positions_{false};
+    bool optimize_{false};
+    u32 lod_count_{0};
+    f32 lod_max_error_{5e-2f};
+    bool meshlets_{false};
   };
 
   VENUS_DECLARE_RAII_FUNCTIONS(AllocatedModel);
 
   void destroy() noexcept;
   void swap(AllocatedModel &rhs);
+  /// \return How mesh data is kept in host memory.
+  Residency residency() const;
+  /// \return Number of vertices in the vertex buffer.
+  u32 vertexCount() const;
+  /// \note This includes the index ranges of levels of detail.
+  /// \return Number of indices in the index buffer.
+  u32 indexCount() const;
+  /// \note Host copies (see indexData()) are always 32-bit.
+  /// \return Type of the indices in the index buffer.
+  VkIndexType indexType() const;
+  /// \return Mesh primitive type.
+  Mesh::PrimitiveType primitiveType() const;
+  /// \return Spatial bounds of the whole model.
+  const hermes::geo::bounds::bsphere3 &bounds() const;
+  /// \note Compressed data is decompressed on every call.
+  /// \note Vertex streams are merged into a single interleaved stream.
+  /// \return Host copy of the interleaved vertex data laid out as
+  ///         hostVertexLayout(), or error if mesh data was released.
+  HERMES_NODISCARD Result<std::vector<u8>> vertexData() const;
+  /// \note Compressed data is decompressed on every call.
+  /// \return Host copy of the indices, or error if mesh data was released.
+  HERMES_NODISCARD Result<std::vector<u32>> indexData() const;
+  /// \return Layout of the data returned by vertexData().
+  const mem::VertexLayout &hostVertexLayout() const;
 
 private:
   Model::Storage<mem::AllocatedBuffer> storage_;
   Model::Mesh mesh_;
+  // host residency
+  Residency residency_{Residency::KEEP};
+  mem::VertexLayout host_vertex_layout_;
+  std::vector<u8> host_vertices_;
+  std::vector<u8> compressed_vertices_;
+  std::vector<u8> compressed_indices_;
+  u32 vertex_stride_{0};
+  u32 vertex_count_{0};
+  u32 index_count_{0};
+  VkIndexType index_type_{VK_INDEX_TYPE_UINT32};
+  Mesh::PrimitiveType primitive_type_{Mesh::PrimitiveType::TRIANGLES};
+  hermes::geo::bounds::bsphere3 bounds_;
 
 #ifdef VENUS_INCLUDE_DEBUG_TRAITS
   friend struct hermes::DebugTraits<AllocatedModel>;
@@ -260,6 +421,10 @@ template <> struct DebugTraits<venus::scene::Model::Shape> {
         .add("index base", data.index_base)
         .add("index count", data.index_count)
         .add("bounds", data.bounds)
+        .add("lods", data.lods.size())
+        .add("meshlet base", data.meshlet_base)
+        .add("meshlet count", data.meshlet_count)
+        .add("index type", string_VkIndexType(data.index_type))
         .addFmt("material: 0x{:x}", (uintptr_t)data.material_instance.get());
   }
 };
@@ -273,16 +438,39 @@ template <> struct DebugTraits<venus::scene::Model> {
         .add("vk_vertex_buffer", data.vk_index_buffer_)
         .add("vk_vertex_buffer_address", data.vk_vertex_buffer_address_)
         .add("vk_index_buffer_address", data.vk_index_buffer_address_)
+        .add("vk_position_buffer_address", data.vk_position_buffer_address_)
+        .add("vk_meshlet_buffer_address", data.vk_meshlet_buffer_address_)
         .add("vertex layout", data.vertex_layout_)
         .addArray("shapes", data.shapes_);
   }
 };
 
+template <> struct DebugTraits<venus::scene::AllocatedModel::Residency> {
+  static HERMES_CONST_OR_CONSTEXPR bool is_string_serializable = true;
+  static DebugMessage
+  message(const venus::scene::AllocatedModel::Residency &data) {
+#define TO_STR(A)                                                              \
+  if (data == A)                                                               \
+  return DebugMessage(#A)
+    TO_STR(venus::scene::AllocatedModel::Residency::KEEP);
+    TO_STR(venus::scene::AllocatedModel::Residency::RELEASE);
+    TO_STR(venus::scene::AllocatedModel::Residency::COMPRESS);
+#undef TO_STR
+    return DebugMessage("<invalid residency>");
+  }
+};
+
 template <> struct DebugTraits<venus::scene::AllocatedModel> {
   static HERMES_CONST_OR_CONSTEXPR bool is_string_serializable = true;
   static DebugMessage message(const venus::scene::AllocatedModel &data) {
     return DebugMessage()
         .addTitle("Allocated Model")
+        .add("residency", data.residency_)
+        .add("vertex count", data.vertex_count_)
+        .add("index count", data.index_count_)
+        .add("index type", string_VkIndexType(data.index_type_))
+        .add("compressed vertices size", data.compressed_vertices_.size())
+        .add("compressed indices size", data.compressed_indices_.size())
         .add("mesh aos", data.mesh_.aos);
   }
 };
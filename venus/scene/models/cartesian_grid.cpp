@@ -132,39 +132,32 @@ CartesianGrid::Config::build(const engine::GraphicsDevice &gd) const {
   // vertices
   VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
       cg.storage_.vertices,
-      mem::AllocatedBuffer::Config ::forStorage(
-          vertex_buffer_size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT)
-          .enableShaderDeviceAddress()
-          .setDeviceLocal()
+      mem::AllocatedBuffer::Config ::forVertices(vertex_buffer_size)
           .build(*gd));
   // indices
   VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
       cg.storage_.indices,
-      mem::AllocatedBuffer::Config ::forStorage(
+      mem::AllocatedBuffer::Config ::forDirectWrite(
           index_buffer_size, VK_BUFFER_USAGE_INDEX_BUFFER_BIT)
-          .enableShaderDeviceAddress()
-          .setDeviceLocal()
           .build(*gd));
 
   VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
       cg.storage_.transform,
-      mem::AllocatedBuffer::Config ::forStorage(
+      mem::AllocatedBuffer::Config ::forDirectWrite(
           sizeof(hermes::geo::Transform), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT)
-          .enableShaderDeviceAddress()
-          .setDeviceLocal()
           .build(*gd));
 
-  // copy data
+  // copy data (host visible buffers are written directly)
 
   pipeline::BufferWritter buffer_writter;
-  buffer_writter.addBuffer(*cg.storage_.vertices, *mesh.aos.data(),
+  buffer_writter.addBuffer(cg.storage_.vertices, *mesh.aos.data(),
                            static_cast<u32>(mesh.aos.dataSize()));
 
-  buffer_writter.addBuffer(*cg.storage_.indices, mesh.indices.data(),
+  buffer_writter.addBuffer(cg.storage_.indices, mesh.indices.data(),
                            sizeof(u32) * static_cast<u32>(mesh.indices.size()));
 
   hermes::geo::Transform identity;
-  buffer_writter.addBuffer(*cg.storage_.transform, &identity,
+  buffer_writter.addBuffer(cg.storage_.transform, &identity,
                            sizeof(hermes::geo::Transform));
 
   VENUS_RETURN_BAD_RESULT(buffer_writter.immediateSubmit(gd));
@@ -34,6 +34,9 @@
 #ifdef VENUS_INCLUDE_GLTF
 #include <hermes/geometry/quaternion.h>
 
+#include <cstring>
+#include <functional>
+
 #ifdef __linux__
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wredundant-move"
@@ -99,6 +102,20 @@ HERMES_TO_STRING_DEBUG_METHOD_END
 
 namespace venus::scene {
 
+RasterContext::LodSelection
+RasterContext::LodSelection::fromCamera(const Camera &camera,
+                                        f32 viewport_height,
+                                        f32 error_threshold) {
+  LodSelection selection;
+  selection.eye = camera.position();
+  // a perspective projection maps y / distance to [-1, 1] scaled by [1][1]
+  selection.projection_scale =
+      std::abs(camera.projectionTransform().matrix()[1][1]) *
+      viewport_height * 0.5f;
+  selection.error_threshold = error_threshold;
+  return selection;
+}
+
 void Renderable::setVisible(bool visible) { visible_ = visible; }
 
 } // namespace venus::scene
@@ -111,22 +128,47 @@ void Node::draw(const hermes::geo::Transform &top_matrix,
                 DrawContext &context) {
   if (!visible_)
     return;
+  // children report again while drawing (see setViewDependent)
+  for (Node *child : view_dependent_children_)
+    child->view_dependent_reported_ = false;
+  view_dependent_children_.clear();
   auto node_matrix = top_matrix * world_matrix_;
   for (auto &child : children_)
     child->draw(node_matrix, context);
 }
 
 void Node::destroy() noexcept {
-  for (auto &child : children_)
+  for (auto &child : children_) {
     child->destroy();
+    child->graph_parent_ = nullptr;
+    child->change_reported_ = child->view_dependent_reported_ = false;
+  }
   children_.clear();
+  changed_children_.clear();
+  view_dependent_children_.clear();
+  markChanged(true);
+}
+
+void Node::setVisible(bool visible) {
+  if (visible != visible_)
+    markChanged(true);
+  Renderable::setVisible(visible);
 }
 
 Node::Ptr Node::parent() { return parent_; }
 
 void Node::setParent(Node::Ptr _parent) { parent_ = Node::Ptr::weak(_parent); }
 
-void Node::addChild(Node::Ptr child) { children_.push_back(child); }
+void Node::addChild(Node::Ptr child) {
+  // changes reported to a previous parent no longer reach this graph
+  if (child->graph_parent_ != this)
+    child->change_reported_ = child->view_dependent_reported_ = false;
+  child->graph_parent_ = this;
+  children_.push_back(child);
+  child->markChanged(true);
+  if (child->view_dependent_)
+    child->setViewDependent(true);
+}
 
 void Node::setLocalTransform(const hermes::geo::Transform &transform) {
   local_matrix_ = transform;
@@ -136,12 +178,120 @@ const hermes::geo::Transform &Node::localTransform() const {
   return local_matrix_;
 }
 
+const hermes::geo::Transform &Node::worldTransform() const {
+  return world_matrix_;
+}
+
 void Node::updateTrasform(const hermes::geo::Transform &parent_matrix) {
-  world_matrix_ = parent_matrix * local_matrix_;
+  auto world_matrix = parent_matrix * local_matrix_;
+  if (std::memcmp(&world_matrix, &world_matrix_, sizeof(world_matrix_))) {
+    world_matrix_ = world_matrix;
+    markChanged();
+  }
   for (auto &child : children_)
     child->updateTrasform(world_matrix_);
 }
 
+void Node::relocate(const std::vector<mem::Relocation> &relocations) {
+  for (auto &child : children_)
+    child->relocate(relocations);
+}
+
+void Node::markChanged(bool structure) {
+  changed_ = true;
+  structure_changed_ |= structure;
+  // report upwards until reaching an ancestor that already knows
+  for (Node *node = this; node->graph_parent_; node = node->graph_parent_) {
+    Node *parent = node->graph_parent_;
+    if (node->change_reported_ && (!structure || parent->structure_changed_))
+      break;
+    if (!node->change_reported_) {
+      parent->changed_children_.emplace_back(node);
+      node->change_reported_ = true;
+    }
+    parent->structure_changed_ |= structure;
+  }
+}
+
+bool Node::structureChanged() const { return structure_changed_; }
+
+void Node::drawChanges(const hermes::geo::Transform &top_matrix,
+                       DrawContext &context, bool view_changed) {
+  if (changed_ || (view_changed && view_dependent_))
+    draw(top_matrix, context);
+  else if (visible_) {
+    auto child_matrix = childMatrix(top_matrix);
+    for (Node *child : changed_children_)
+      if (child->graph_parent_ == this)
+        child->drawChanges(child_matrix, context, view_changed);
+    if (view_changed)
+      for (Node *child : view_dependent_children_)
+        if (child->graph_parent_ == this && !child->change_reported_)
+          child->drawChanges(child_matrix, context, view_changed);
+  }
+  clearChanges();
+}
+
+void Node::clearChanges() {
+  for (Node *child : changed_children_)
+    if (child->graph_parent_ == this) {
+      child->clearChanges();
+      child->change_reported_ = false;
+    }
+  changed_children_.clear();
+  changed_ = structure_changed_ = false;
+}
+
+hermes::geo::Transform
+Node::childMatrix(const hermes::geo::Transform &top_matrix) const {
+  return top_matrix * world_matrix_;
+}
+
+void Node::setViewDependent(bool view_dependent) {
+  view_dependent_ = view_dependent;
+  // stale entries are dropped when the parent draws again
+  if (!view_dependent)
+    return;
+  for (Node *node = this;
+       node->graph_parent_ && !node->view_dependent_reported_;
+       node = node->graph_parent_) {
+    node->graph_parent_->view_dependent_children_.emplace_back(node);
+    node->view_dependent_reported_ = true;
+  }
+}
+
+// Identifies the raster objects of a node shape across frames.
+static u64 renderObjectId(const Node *node, size_t shape_index) {
+  return static_cast<u64>(reinterpret_cast<uintptr_t>(node)) ^
+         (static_cast<u64>(shape_index) << 48);
+}
+
+// Picks the index range of the coarsest level of detail whose error, scaled
+// by the projected size of the shape bounds, stays below the threshold.
+static std::pair<u32, u32>
+selectLod(const Model::Shape &shape, const hermes::geo::Transform &model_matrix,
+          const RasterContext::LodSelection &selection) {
+  std::pair<u32, u32> range = {shape.index_base, shape.index_count};
+  f32 radius = shape.bounds.radius();
+  if (shape.lods.empty() || selection.projection_scale <= 0.f ||
+      radius <= 0.f)
+    return range;
+  auto center = model_matrix(shape.bounds.center());
+  f32 world_radius =
+      model_matrix(hermes::geo::vec3(radius, 0.f, 0.f)).length();
+  f32 distance =
+      std::max((center - selection.eye).length() - world_radius, 1e-3f);
+  // projected radius (in pixels) per object space unit
+  f32 projected_radius = world_radius * selection.projection_scale / distance;
+  f32 pixels_per_unit = projected_radius / radius;
+  for (const auto &lod : shape.lods) {
+    if (lod.error * pixels_per_unit > selection.error_threshold)
+      break;
+    range = {lod.index_base, lod.index_count};
+  }
+  return range;
+}
+
 ModelNode::ModelNode(Model::Ptr model) : model_{model} {}
 
 void ModelNode::draw(const hermes::geo::Transform &top_matrix,
@@ -149,30 +299,61 @@ void ModelNode::draw(const hermes::geo::Transform &top_matrix,
   if (!visible_)
     return;
   auto model_matrix = top_matrix * world_matrix_;
+  // the model may have been merged into a static batch
+  if (!model_) {
+    Node::draw(model_matrix, context);
+    return;
+  }
 
   std::visit(
       DrawContextOverloaded{
           [&](RasterContext &ctx) {
-            for (const auto &shape : model_->shapes()) {
+            const auto &shapes = model_->shapes();
+            bool has_lods = false;
+            for (size_t i = 0; i < shapes.size(); ++i) {
+              const auto &shape = shapes[i];
               RasterContext::RenderObject render_object;
               // scene
+              render_object.id = renderObjectId(this, i);
               render_object.bounds = shape.bounds;
               render_object.transform = model_matrix;
               // mesh
-              render_object.first_index = shape.index_base;
+              auto lod = selectLod(shape, model_matrix, ctx.lod_selection);
+              render_object.first_index = lod.first;
               render_object.count =
-                  shape.index_count ? shape.index_count : shape.vertex_count;
+                  lod.second ? lod.second : shape.vertex_count;
               if (model_->vertexBuffer()) {
                 render_object.vertex_buffer = model_->vertexBuffer();
                 render_object.vertex_buffer_address =
                     model_->vertexBufferAddress();
+                render_object.position_buffer_address =
+                    model_->positionBufferAddress();
+                if (model_->vertexLayout().isQuantized())
+                  render_object.dequantization = model_->dequantization();
               }
-              if (model_->indexBuffer())
+              if (model_->indexBuffer()) {
                 render_object.index_buffer = model_->indexBuffer();
+                render_object.index_buffer_address =
+                    model_->indexBufferAddress();
+                render_object.index_type = shape.index_type;
+              }
+              // meshlets only cover the full detail range
+              if (shape.meshlet_count && lod.first == shape.index_base &&
+                  lod.second == shape.index_count) {
+                render_object.meshlet_buffer_address =
+                    model_->meshletBufferAddress() +
+                    sizeof(Meshlet) * shape.meshlet_base;
+                render_object.meshlet_count = shape.meshlet_count;
+              }
               //  shading
-              render_object.material_instance = shape.material_instance;
+              render_object.material_instance = material_instance_
+                                                    ? material_instance_
+                                                    : shape.material_instance;
               ctx.objects.push_back(render_object);
+              has_lods |= !shape.lods.empty();
             }
+            // levels of detail follow the camera
+            setViewDependent(has_lods);
           },
           [&](TracerContext &ctx) {
             for (const auto &shape : model_->shapes()) {
@@ -188,8 +369,13 @@ void ModelNode::draw(const hermes::geo::Transform &top_matrix,
                   3;
               render_object.vertex_buffer_address =
                   model_->vertexBufferAddress();
+              render_object.position_buffer_address =
+                  model_->positionBufferAddress();
               render_object.index_buffer_address = model_->indexBufferAddress();
+              render_object.index_type = shape.index_type;
               render_object.max_vertex = shape.vertex_count;
+              if (model_->vertexLayout().isQuantized())
+                render_object.dequantization = model_->dequantization();
               // transform
               //  shading
               ctx.objects.push_back(render_object);
@@ -203,12 +389,42 @@ void ModelNode::draw(const hermes::geo::Transform &top_matrix,
 
 void ModelNode::destroy() noexcept {
   model_ = Model::Ptr();
+  material_instance_ = Material::Instance::Ptr();
   Node::destroy();
 }
 
+void ModelNode::relocate(const std::vector<mem::Relocation> &relocations) {
+  if (model_)
+    model_->relocate(relocations);
+  Node::relocate(relocations);
+}
+
+hermes::geo::Transform
+ModelNode::childMatrix(const hermes::geo::Transform &top_matrix) const {
+  // draw hands the model matrix to Node::draw
+  return Node::childMatrix(top_matrix * world_matrix_);
+}
+
 Model::Ptr ModelNode::model() { return model_; }
 
-void ModelNode::setModel(Model::Ptr model) { model_ = model; }
+void ModelNode::setModel(Model::Ptr model) {
+  model_ = model;
+  markChanged(true);
+}
+
+void ModelNode::setMaterialInstance(
+    const Material::Instance::Ptr &material_instance) {
+  material_instance_ = material_instance;
+  markChanged();
+}
+
+StaticBatchNode::StaticBatchNode(Model::Ptr model,
+                                 std::vector<StaticBatch::Source> sources)
+    : ModelNode(model), sources_{std::move(sources)} {}
+
+const std::vector<StaticBatch::Source> &StaticBatchNode::sources() const {
+  return sources_;
+}
 
 CameraNode::CameraNode(Camera::Ptr camera) : camera_{camera} {}
 
@@ -225,6 +441,12 @@ void CameraNode::destroy() noexcept {
   Node::destroy();
 }
 
+hermes::geo::Transform
+CameraNode::childMatrix(const hermes::geo::Transform &top_matrix) const {
+  // draw hands the model matrix to Node::draw
+  return Node::childMatrix(top_matrix * world_matrix_);
+}
+
 Camera::Ptr CameraNode::camera() { return camera_; }
 
 void CameraNode::setCamera(Camera::Ptr camera) { camera_ = camera; }
@@ -425,13 +647,24 @@ loadMaterialResources(fastgltf::Material &material, fastgltf::Asset &asset,
   return resources;
 }
 
+// Host copy of a mesh, kept for static batching.
+struct GLTF_HostMesh {
+  mem::VertexLayout vertex_layout;
+  std::vector<u8> vertices;
+  u32 vertex_count{0};
+  std::vector<u32> indices;
+};
+
 VeResult
 loadMeshes(fastgltf::Asset &asset, const engine::GraphicsDevice &gd,
            const std::vector<Material::Instance::Ptr> &materials,
            std::unordered_map<std::string, Model::Ptr> &meshes,
            std::unordered_map<std::string, Model::Storage<mem::AllocatedBuffer>>
                &mesh_storage,
-           std::vector<Model::Ptr> &flatten_meshes) {
+           std::vector<Model::Ptr> &flatten_meshes,
+           const MeshOptimization &optimization,
+           const MeshLodGeneration &lod_generation, bool build_meshlets,
+           bool quantize, std::vector<GLTF_HostMesh> *host_meshes) {
   struct Vertex {
     hermes::geo::point3 position;
     f32 uv_x;
@@ -440,12 +673,30 @@ loadMeshes(fastgltf::Asset &asset, const engine::GraphicsDevice &gd,
     hermes::colors::RGBA_Color color;
   };
 
+  mem::VertexLayout vertex_layout;
+  vertex_layout
+      .pushComponent(mem::VertexLayout::ComponentType::Position,
+                     VK_FORMAT_R32G32B32_SFLOAT)
+      .pushComponent(mem::VertexLayout::ComponentType::Scalar,
+                     VK_FORMAT_R32_SFLOAT)
+      .pushComponent(mem::VertexLayout::ComponentType::Normal,
+                     VK_FORMAT_R32G32B32_SFLOAT)
+      .pushComponent(mem::VertexLayout::ComponentType::Scalar,
+                     VK_FORMAT_R32_SFLOAT)
+      .pushComponent(mem::VertexLayout::ComponentType::Color,
+                     VK_FORMAT_R32G32B32A32_SFLOAT);
+  HERMES_ASSERT(vertex_layout.stride() == sizeof(Vertex));
+
   std::vector<u32> indices;
   std::vector<Vertex> vertices;
+  std::vector<Meshlet> meshlets;
+  std::vector<Model::Shape> surfaces;
 
   for (fastgltf::Mesh &mesh : asset.meshes) {
     indices.clear();
     vertices.clear();
+    meshlets.clear();
+    surfaces.clear();
 
     Model::Config model_config;
 
@@ -525,10 +776,58 @@ loadMeshes(fastgltf::Asset &asset, const engine::GraphicsDevice &gd,
             });
       }
 
+      // optimize primitive data (primitive indices start at initial_vtx)
+      if (p.type == fastgltf::PrimitiveType::Triangles &&
+          vertices.size() > initial_vtx) {
+        std::vector<u32> primitive_indices(
+            indices.begin() + surface.index_base, indices.end());
+        for (auto &index : primitive_indices)
+          index -= initial_vtx;
+        VENUS_DECLARE_OR_RETURN_BAD_RESULT(
+            OptimizedMesh, optimized,
+            optimizeMesh(vertex_layout, vertices.data() + initial_vtx,
+                         static_cast<u32>(vertices.size() - initial_vtx),
+                         primitive_indices,
+                         Model::Mesh::PrimitiveType::TRIANGLES,
+                         optimization));
+        vertices.resize(initial_vtx + optimized.vertex_count);
+        std::memcpy(vertices.data() + initial_vtx, optimized.vertices.data(),
+                    optimized.vertices.size());
+        indices.resize(surface.index_base);
+        for (u32 index : optimized.indices)
+          indices.push_back(index + initial_vtx);
+        surface.index_count = static_cast<u32>(optimized.indices.size());
+      }
+
+      // meshlets of the full detail range
+      if (p.type == fastgltf::PrimitiveType::Triangles && build_meshlets &&
+          surface.index_count) {
+        VENUS_DECLARE_OR_RETURN_BAD_RESULT(
+            std::vector<Meshlet>, primitive_meshlets,
+            buildMeshlets(vertex_layout, vertices.data(),
+                          static_cast<u32>(vertices.size()), indices,
+                          surface.index_base, surface.index_count));
+        surface.meshlet_base = static_cast<u32>(meshlets.size());
+        surface.meshlet_count = static_cast<u32>(primitive_meshlets.size());
+        meshlets.insert(meshlets.end(), primitive_meshlets.begin(),
+                        primitive_meshlets.end());
+      }
+
+      // levels of detail (appended right after the primitive indices)
+      if (p.type == fastgltf::PrimitiveType::Triangles &&
+          lod_generation.lod_count) {
+        VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
+            surface.lods,
+            generateLods(vertex_layout, vertices.data(),
+                         static_cast<u32>(vertices.size()), indices,
+                         surface.index_base, surface.index_count,
+                         lod_generation));
+      }
+
       if (p.materialIndex.has_value()) {
-        surface.material = materials[p.materialIndex.value()];
+        surface.material_instance = materials[p.materialIndex.value()];
       } else {
-        surface.material = materials[0];
+        surface.material_instance = materials[0];
       }
 
       hermes::geo::point3 minpos = vertices[initial_vtx].position;
@@ -541,40 +840,82 @@ loadMeshes(fastgltf::Asset &asset, const engine::GraphicsDevice &gd,
       surface.bounds.setCenter((maxpos + hermes::geo::vec3(minpos)) / 2.f);
       surface.bounds.setRadius(((maxpos - minpos) / 2.f).length());
 
+      surfaces.emplace_back(surface);
+    }
+
+    // all primitives of the mesh share the index buffer
+
+    const VkIndexType index_type =
+        mem::indexTypeFor(static_cast<u32>(vertices.size()));
+    VENUS_DECLARE_OR_RETURN_BAD_RESULT(std::vector<u8>, packed_indices,
+                                       mem::packIndices(indices, index_type));
+    for (auto &surface : surfaces) {
+      surface.index_type = index_type;
       model_config.addShape(surface);
     }
 
+    // quantization (host meshes kept for batching stay in floats)
+
+    const void *vertex_data = vertices.data();
+    VkDeviceSize vertex_data_size = sizeof(Vertex) * vertices.size();
+    mem::QuantizedVertices quantized;
+    if (quantize && !vertices.empty()) {
+      VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
+          quantized,
+          mem::quantizeVertices(vertex_layout, vertices.data(),
+                                static_cast<u32>(vertices.size())));
+      vertex_data = quantized.data.data();
+      vertex_data_size = quantized.data.size();
+      model_config.setVertexLayout(quantized.layout)
+          .setDequantization(quantized.dequantization);
+    } else {
+      model_config.setVertexLayout(vertex_layout);
+    }
+
     Model::Storage<mem::AllocatedBuffer> storage;
 
     VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
         storage.vertices,
         mem::AllocatedBuffer::Config::forStorage(
-            sizeof(Vertex) * vertices.size(), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT)
+            vertex_data_size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT)
             .build(*gd));
 
     VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
         storage.indices,
         mem::AllocatedBuffer::Config::forStorage(
-            sizeof(u32) * indices.size(), VK_BUFFER_USAGE_INDEX_BUFFER_BIT)
+            packed_indices.size(), VK_BUFFER_USAGE_INDEX_BUFFER_BIT)
             .build(*gd));
 
+    if (!meshlets.empty()) {
+      VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
+          storage.meshlets,
+          mem::AllocatedBuffer::Config::forStorage(
+              sizeof(Meshlet) * meshlets.size(), 0)
+              .build(*gd));
+    }
+
     // copy data
 
-    VENUS_RETURN_BAD_RESULT(pipeline::BufferWritter()
-                                .addBuffer(*storage.vertices, vertices.data(),
-                                           sizeof(Vertex) * vertices.size())
-                                .addBuffer(*storage.indices, indices.data(),
-                                           sizeof(u32) * indices.size())
-                                .immediateSubmit(gd));
+    pipeline::BufferWritter buffer_writter;
+    buffer_writter
+        .addBuffer(*storage.vertices, vertex_data,
+                   static_cast<u32>(vertex_data_size))
+        .addBuffer(*storage.indices, packed_indices.data(),
+                   packed_indices.size());
+    if (!meshlets.empty())
+      buffer_writter.addBuffer(*storage.meshlets, meshlets.data(),
+                               sizeof(Meshlet) * meshlets.size());
+    VENUS_RETURN_BAD_RESULT(buffer_writter.immediateSubmit(gd));
 
     Model model;
 
-    VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
-        model,
-        model_config
-            .setVertices(*storage.vertices, storage.vertices.deviceAddress())
-            .setIndices(*storage.indices, storage.indices.deviceAddress())
-            .build());
+    model_config
+        .setVertices(*storage.vertices, storage.vertices.deviceAddress())
+        .setIndices(*storage.indices, storage.indices.deviceAddress());
+    if (!meshlets.empty())
+      model_config.setMeshlets(*storage.meshlets,
+                               storage.meshlets.deviceAddress());
+    VENUS_ASSIGN_OR_RETURN_BAD_RESULT(model, model_config.build());
 
     auto mesh_key = mesh.name.c_str();
 
@@ -584,12 +925,28 @@ loadMeshes(fastgltf::Asset &asset, const engine::GraphicsDevice &gd,
     mesh_storage[mesh.name.c_str()] = std::move(storage);
 
     flatten_meshes.emplace_back(meshes[mesh_key]);
+
+    if (host_meshes) {
+      GLTF_HostMesh host_mesh;
+      host_mesh.vertex_layout = vertex_layout;
+      host_mesh.vertices.resize(sizeof(Vertex) * vertices.size());
+      std::memcpy(host_mesh.vertices.data(), vertices.data(),
+                  host_mesh.vertices.size());
+      host_mesh.vertex_count = static_cast<u32>(vertices.size());
+      host_mesh.indices = indices;
+      host_meshes->emplace_back(std::move(host_mesh));
+    }
   }
   return VeResult::noError();
 }
 
 Result<GLTF_Node::Ptr> GLTF_Node::from(const std::filesystem::path &path,
-                                       const engine::GraphicsDevice &gd) {
+                                       const engine::GraphicsDevice &gd,
+                                       const MeshOptimization &optimization,
+                                       const MeshLodGeneration &lods,
+                                       bool meshlets,
+                                       const StaticBatching &batching,
+                                       bool quantize, bool depth_prepass) {
   if (!std::filesystem::exists(path)) {
 #ifdef __linux__
     HERMES_ERROR("File does not exist: {}", path.c_str());
@@ -700,6 +1057,10 @@ Result<GLTF_Node::Ptr> GLTF_Node::from(const std::filesystem::path &path,
   // MATERIALS
   /////////////////////////////////////////////////////////////////////////////
   std::vector<Material::Instance::Ptr> materials(asset->materials.size());
+  auto &gltf_materials = engine::GraphicsEngine::globals().materials;
+  const Material *pbr_material =
+      depth_prepass ? &gltf_materials.gltf_metallic_roughness_prepass
+                    : &gltf_materials.gltf_metallic_roughness;
 
   VENUS_DECLARE_OR_RETURN_BAD_RESULT(mem::DeviceMemory::ScopedMap, d,
                                      scene->material_data_buffer_.scopedMap());
@@ -717,11 +1078,11 @@ Result<GLTF_Node::Ptr> GLTF_Node::from(const std::filesystem::path &path,
     // GLTF_Material::Ptr new_material = GLTF_Material::Ptr();
     // scene->materials_[material.name.c_str()] = new_material;
 
-    // TODO: transparency support
-    // MaterialPass passType = MaterialPass::MainColor;
-    // if (mat.alphaMode == fastgltf::AlphaMode::Blend) {
-    //   passType = MaterialPass::Transparent;
-    // }
+    // blended materials are drawn in the transparent pass
+    const Material *material =
+        gltf_material.alphaMode == fastgltf::AlphaMode::Blend
+            ? &gltf_materials.gltf_metallic_roughness_transparent
+            : pbr_material;
     materials::GLTF_MetallicRoughness parameters;
     // resources
     parameters.resources = loadMaterialResources(
@@ -734,9 +1095,7 @@ Result<GLTF_Node::Ptr> GLTF_Node::from(const std::filesystem::path &path,
     // write material
     VENUS_DECLARE_SHARED_PTR_FROM_RESULT_OR_RETURN_BAD_RESULT(
         Material::Instance, m_instance,
-        parameters.write(scene->descriptor_allocator_,
-                         &engine::GraphicsEngine::globals()
-                              .materials.gltf_metallic_roughness));
+        parameters.write(scene->descriptor_allocator_, material));
 
     materials[material_index] = scene->materials_[gltf_material.name.c_str()] =
         m_instance;
@@ -747,8 +1106,11 @@ Result<GLTF_Node::Ptr> GLTF_Node::from(const std::filesystem::path &path,
   /////////////////////////////////////////////////////////////////////////////
 
   std::vector<Model::Ptr> meshes;
-  VENUS_CHECK_VE_RESULT(loadMeshes(asset.get(), gd, materials, scene->meshes_,
-                                   scene->mesh_storage_, meshes));
+  std::vector<GLTF_HostMesh> host_meshes;
+  VENUS_CHECK_VE_RESULT(loadMeshes(
+      asset.get(), gd, materials, scene->meshes_, scene->mesh_storage_, meshes,
+      optimization, lods, meshlets, quantize,
+      batching.max_batch_size ? &host_meshes : nullptr));
 
   /////////////////////////////////////////////////////////////////////////////
   // NODES
@@ -812,10 +1174,123 @@ Result<GLTF_Node::Ptr> GLTF_Node::from(const std::filesystem::path &path,
   for (auto &node : nodes) {
     if (!node->parent()) {
       scene->top_nodes_.push_back(node);
+      scene->addChild(node);
       node->updateTrasform(hermes::geo::Transform());
     }
   }
 
+  /////////////////////////////////////////////////////////////////////////////
+  // STATIC BATCHING
+  /////////////////////////////////////////////////////////////////////////////
+  if (!batching.max_batch_size || host_meshes.empty())
+    return Result<GLTF_Node::Ptr>(std::move(scene));
+
+  // nodes targeted by animations or skins make their subtrees dynamic
+  std::vector<bool> dynamic(asset->nodes.size(), false);
+  for (const auto &animation : asset->animations)
+    for (const auto &channel : animation.channels)
+      if (channel.nodeIndex.has_value())
+        dynamic[*channel.nodeIndex] = true;
+  for (u32 i = 0; i < asset->nodes.size(); i++)
+    if (asset->nodes[i].skinIndex.has_value())
+      dynamic[i] = true;
+
+  // shapes of static mesh nodes, with the same matrices used by draw
+  std::vector<StaticBatchSource> sources;
+  std::vector<u32> batched_nodes;
+  std::function<void(u32, const hermes::geo::Transform &, bool)> collect =
+      [&](u32 i, const hermes::geo::Transform &top_matrix, bool is_static) {
+        is_static = is_static && !dynamic[i];
+        const fastgltf::Node &node = asset->nodes[i];
+        auto model_matrix = top_matrix * nodes[i]->worldTransform();
+        auto children_matrix = model_matrix;
+        if (node.meshIndex.has_value()) {
+          // see ModelNode::draw
+          children_matrix = model_matrix * nodes[i]->worldTransform();
+          if (is_static) {
+            const auto &host_mesh = host_meshes[*node.meshIndex];
+            for (const auto &shape : meshes[*node.meshIndex]->shapes()) {
+              StaticBatchSource source;
+              source.vertices = host_mesh.vertices.data();
+              source.vertex_count = host_mesh.vertex_count;
+              source.indices = host_mesh.indices.data() + shape.index_base;
+              source.index_count = shape.index_count;
+              source.transform = model_matrix;
+              source.material_instance = shape.material_instance;
+              source.id = i;
+              sources.emplace_back(source);
+            }
+            batched_nodes.emplace_back(i);
+          }
+        }
+        for (auto c : node.children)
+          collect(static_cast<u32>(c), children_matrix, is_static);
+      };
+  for (u32 i = 0; i < nodes.size(); i++)
+    if (!nodes[i]->parent())
+      collect(i, hermes::geo::Transform(), true);
+
+  VENUS_DECLARE_OR_RETURN_BAD_RESULT(
+      std::vector<StaticBatch>, batches,
+      buildStaticBatches(host_meshes.front().vertex_layout, sources, batching));
+
+  for (auto &batch : batches) {
+    const VkIndexType index_type = mem::indexTypeFor(batch.vertex_count);
+    VENUS_DECLARE_OR_RETURN_BAD_RESULT(
+        std::vector<u8>, packed_indices,
+        mem::packIndices(batch.indices, index_type));
+
+    Model::Storage<mem::AllocatedBuffer> storage;
+    VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
+        storage.vertices,
+        mem::AllocatedBuffer::Config::forStorage(
+            batch.vertices.size(), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT)
+            .build(*gd));
+    VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
+        storage.indices,
+        mem::AllocatedBuffer::Config::forStorage(
+            packed_indices.size(), VK_BUFFER_USAGE_INDEX_BUFFER_BIT)
+            .build(*gd));
+    VENUS_RETURN_BAD_RESULT(
+        pipeline::BufferWritter()
+            .addBuffer(*storage.vertices, batch.vertices.data(),
+                       batch.vertices.size())
+            .addBuffer(*storage.indices, packed_indices.data(),
+                       packed_indices.size())
+            .immediateSubmit(gd));
+
+    // a single shape draws the whole batch
+    Model::Shape shape;
+    shape.bounds = batch.bounds;
+    shape.material_instance = batch.material_instance;
+    shape.index_count = static_cast<u32>(batch.indices.size());
+    shape.vertex_count = batch.vertex_count;
+    shape.index_type = index_type;
+
+    Model model;
+    VENUS_ASSIGN_OR_RETURN_BAD_RESULT(
+        model,
+        Model::Config()
+            .addShape(shape)
+            .setVertices(*storage.vertices, storage.vertices.deviceAddress())
+            .setIndices(*storage.indices, storage.indices.deviceAddress())
+            .build());
+    auto batch_model = Model::Ptr::shared();
+    *batch_model = std::move(model);
+
+    scene->static_batches_.emplace_back(
+        StaticBatchNode::Ptr::shared(batch_model, std::move(batch.sources)));
+    scene->addChild(scene->static_batches_.back());
+    scene->static_batch_storage_.emplace_back(std::move(storage));
+  }
+
+  // batched nodes keep their children but no longer draw their shapes
+  for (u32 i : batched_nodes)
+    static_cast<ModelNode *>(nodes[i].get())->setModel(Model::Ptr());
+
+  HERMES_INFO("Static batching: {} shapes merged into {} batches.",
+              sources.size(), batches.size());
+
   return Result<GLTF_Node::Ptr>(std::move(scene));
 }
 
@@ -827,8 +1302,10 @@ GLTF_Node::~GLTF_Node() noexcept {
 void GLTF_Node::destroy() noexcept {
   nodes_.clear();
   top_nodes_.clear();
+  static_batches_.clear();
   meshes_.clear();
   mesh_storage_.clear();
+  static_batch_storage_.clear();
   materials_.clear();
   descriptor_allocator_.destroy();
   material_data_buffer_.destroy();
@@ -839,15 +1316,26 @@ void GLTF_Node::destroy() noexcept {
   }
   images_.clear();
   samplers_.clear();
+  Node::destroy();
 }
 
 void GLTF_Node::draw(const hermes::geo::Transform &top_matrix,
                      DrawContext &ctx) {
   if (!visible_)
     return;
+  for (Node *child : view_dependent_children_)
+    child->view_dependent_reported_ = false;
+  view_dependent_children_.clear();
   for (auto &n : top_nodes_) {
     n->draw(top_matrix, ctx);
   }
+  for (auto &batch : static_batches_)
+    batch->draw(top_matrix, ctx);
+}
+
+hermes::geo::Transform
+GLTF_Node::childMatrix(const hermes::geo::Transform &top_matrix) const {
+  return top_matrix;
 }
 
 std::string GLTF_Node::toString(u32 tab_size) const {
@@ -910,6 +1398,7 @@ Result<VDB_Node::Ptr> VDB_Node::from(const std::filesystem::path &vdb_file_path,
         vdb_node->bounds_model_,
         AllocatedModel::Config::fromShape(shapes::box, box,
                                           shape_option_bits::vertices)
+            .setResidency(AllocatedModel::Residency::RELEASE)
             .build(gd));
 
     // send grid to gpu
@@ -918,6 +1407,7 @@ Result<VDB_Node::Ptr> VDB_Node::from(const std::filesystem::path &vdb_file_path,
         vdb_node->gpu_vdb_data_,
         mem::AllocatedBuffer::Config::forStorage(
             handle.size(), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT)
+            .setMemoryCategory(core::MemoryCategory::Grids)
             .build(*gd));
 
     // uniform buffer
@@ -979,9 +1469,12 @@ void VDB_Node::draw(const hermes::geo::Transform &top_matrix,
 
   std::visit(DrawContextOverloaded{
                  [&](RasterContext &ctx) {
-                   for (const auto &shape : bounds_model_.shapes()) {
+                   const auto &shapes = bounds_model_.shapes();
+                   for (size_t i = 0; i < shapes.size(); ++i) {
+                     const auto &shape = shapes[i];
                      RasterContext::RenderObject render_object;
                      // scene
+                     render_object.id = renderObjectId(this, i);
                      render_object.bounds = shape.bounds;
                      render_object.transform = model_matrix;
                      // mesh
@@ -994,9 +1487,12 @@ void VDB_Node::draw(const hermes::geo::Transform &top_matrix,
                            bounds_model_.vertexBuffer();
                        render_object.vertex_buffer_address =
                            bounds_model_.vertexBufferAddress();
+                       render_object.position_buffer_address =
+                           bounds_model_.positionBufferAddress();
                      }
                      if (bounds_model_.indexBuffer()) {
                        render_object.index_buffer = bounds_model_.indexBuffer();
+                       render_object.index_type = shape.index_type;
                      }
                      //  shading
                      render_object.material_instance = shape.material;
@@ -1017,6 +1513,17 @@ void VDB_Node::destroy() noexcept {
   Node::destroy();
 }
 
+void VDB_Node::relocate(const std::vector<mem::Relocation> &relocations) {
+  bounds_model_.relocate(relocations);
+  Node::relocate(relocations);
+}
+
+hermes::geo::Transform
+VDB_Node::childMatrix(const hermes::geo::Transform &top_matrix) const {
+  // draw hands the model matrix to Node::draw
+  return Node::childMatrix(top_matrix * world_matrix_);
+}
+
 std::string VDB_Node::toString(u32 tab_size) const {
   hermes::cstr s;
   s.appendLine(hermes::cstr::format("vdb node"));
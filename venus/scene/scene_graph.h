@@ -30,11 +30,16 @@
 #include <venus/pipeline/rasterizer.h>
 #include <venus/scene/camera.h>
 #include <venus/scene/material.h>
+#include <venus/scene/mesh_optimizer.h>
+#include <venus/scene/mesh_simplifier.h>
+#include <venus/scene/meshlets.h>
 #include <venus/scene/model.h>
+#include <venus/scene/static_batching.h>
 
 #include <hermes/geometry/bounds.h>
 #include <hermes/geometry/transform.h>
 
+#include <optional>
 #include <variant>
 
 #ifdef VENUS_INCLUDE_GLTF
@@ -52,6 +57,8 @@ struct RasterContext {
   struct RenderObject {
     // scene
 
+    /// Identifies the object across frames (node and shape), zero if unknown.
+    u64 id{0};
     hermes::geo::bounds::bsphere3 bounds;
     hermes::geo::Transform transform;
 
@@ -62,14 +69,39 @@ struct RasterContext {
     VkBuffer index_buffer{VK_NULL_HANDLE};
     VkBuffer vertex_buffer{VK_NULL_HANDLE};
     VkDeviceAddress vertex_buffer_address{0};
+    VkDeviceAddress position_buffer_address{0};
+    VkDeviceAddress index_buffer_address{0};
+    VkIndexType index_type{VK_INDEX_TYPE_UINT32};
+    /// Position dequantization (empty if vertices are not quantized).
+    std::optional<mem::Dequantization> dequantization;
+    /// Meshlets of the drawn range (zero count if the range has none).
+    VkDeviceAddress meshlet_buffer_address{0}; //< first meshlet of the range.
+    u32 meshlet_count{0};
 
     // shading
 
     Material::Instance::Ptr material_instance;
   };
 
+  /// Level of detail selection. Shapes draw their coarsest level whose error,
+  /// projected on screen, stays below the error threshold.
+  /// \note Selection is disabled while projection_scale is zero.
+  struct LodSelection {
+    /// \note Assumes a perspective projection.
+    /// \param camera
+    /// \param viewport_height Viewport height (in pixels).
+    /// \param error_threshold Max screen space error (in pixels).
+    static LodSelection fromCamera(const Camera &camera, f32 viewport_height,
+                                   f32 error_threshold);
+
+    hermes::geo::point3 eye;   //< camera position (world space).
+    f32 projection_scale{0.f}; //< pixels per world unit at distance one.
+    f32 error_threshold{1.f};  //< max screen space error (in pixels).
+  };
+
   // scene data
   std::vector<RenderObject> objects;
+  LodSelection lod_selection;
 };
 
 struct TracerContext {
@@ -77,10 +109,14 @@ struct TracerContext {
     mem::VertexLayout vertex_layout;
     hermes::geo::Transform transform;
     VkDeviceAddress vertex_buffer_address;
+    VkDeviceAddress position_buffer_address;
     VkDeviceAddress index_buffer_address;
+    VkIndexType index_type{VK_INDEX_TYPE_UINT32};
     VkDeviceAddress transform_buffer_address;
     u32 primitive_count;
     u32 max_vertex;
+    /// Position dequantization (empty if vertices are not quantized).
+    std::optional<mem::Dequantization> dequantization;
   };
   std::vector<RenderObject> objects;
 };
@@ -107,7 +143,7 @@ public:
   virtual void draw(const hermes::geo::Transform &top_matrix,
                     DrawContext &context) = 0;
 
-  void setVisible(bool visible);
+  virtual void setVisible(bool visible);
 
 protected:
   bool visible_{true};
@@ -136,11 +172,16 @@ public:
   virtual void draw(const hermes::geo::Transform &top_matrix,
                     DrawContext &context) override;
   virtual void destroy() noexcept override;
+  /// \note Hidden nodes draw nothing (see structureChanged).
+  void setVisible(bool visible) override;
 
   // access
 
   /// \return Node local transform matrix.
   const hermes::geo::Transform &localTransform() const;
+  /// \note Updated by updateTrasform.
+  /// \return Node world transform matrix.
+  const hermes::geo::Transform &worldTransform() const;
   /// \return This node parent.
   Node::Ptr parent();
 
@@ -158,14 +199,64 @@ public:
   /// Propagates the world transform of all nodes downwards.
   /// \param parent_matrix New transform coming from above.
   void updateTrasform(const hermes::geo::Transform &parent_matrix);
+  /// Propagates handles replaced by memory defragmentation downwards.
+  /// \param relocations Handles replaced by a defragmentation pass.
+  virtual void relocate(const std::vector<mem::Relocation> &relocations);
+
+  // changes
+
+  /// Marks the node as changed, so drawChanges draws the node (and its
+  /// subtree) again. Nodes mark themselves when their world transforms,
+  /// models, materials, visibility or children change.
+  /// \note Changes made to models (see Model) are not tracked, the nodes
+  ///       drawing them must be marked.
+  /// \param structure [def=false] Render objects may have been added or
+  ///        removed (see structureChanged).
+  void markChanged(bool structure = false);
+  /// \return true if render objects of the subtree may have been added or
+  ///         removed since the changes were last cleared, so only drawing
+  ///         the whole subtree gives all of its objects.
+  HERMES_NODISCARD bool structureChanged() const;
+  /// Draws the render objects of changed nodes (see markChanged) along with
+  /// their subtrees, and clears the changes. Only changed paths of the graph
+  /// are visited.
+  /// \param top_matrix
+  /// \param context
+  /// \param view_changed Also draws nodes whose render objects depend on the
+  ///        view (levels of detail).
+  void drawChanges(const hermes::geo::Transform &top_matrix,
+                   DrawContext &context, bool view_changed);
+  /// Clears the changes of the node and its subtree (after draw).
+  void clearChanges();
 
 protected:
+  /// \param top_matrix Matrix the node is drawn with.
+  /// \return Matrix the children of the node are drawn with.
+  virtual hermes::geo::Transform
+  childMatrix(const hermes::geo::Transform &top_matrix) const;
+  /// Marks the render objects of the node as dependent on the view, so
+  /// drawChanges draws them again when the view changes.
+  /// \param view_dependent
+  void setViewDependent(bool view_dependent);
+
   // graph
   Node::Ptr parent_;
   std::vector<Ptr> children_;
   // geometry
   hermes::geo::Transform local_matrix_;
   hermes::geo::Transform world_matrix_;
+  // changes
+  /// node holding this node as a child (see addChild), notified of changes
+  Node *graph_parent_{nullptr};
+  /// children with changes in their subtrees (see markChanged)
+  std::vector<Node *> changed_children_;
+  /// children with view dependent subtrees (see setViewDependent)
+  std::vector<Node *> view_dependent_children_;
+  bool changed_{false};
+  bool structure_changed_{false}; //< of the node or its subtree.
+  bool change_reported_{false};   //< listed by the graph parent.
+  bool view_dependent_{false};
+  bool view_dependent_reported_{false}; //< listed by the graph parent.
 
 #ifdef VENUS_INCLUDE_DEBUG_TRAITS
   virtual hermes::DebugMessage debugMessage() const {
@@ -198,12 +289,24 @@ public:
   void draw(const hermes::geo::Transform &top_matrix,
             DrawContext &context) override;
   void destroy() noexcept override;
+  void relocate(const std::vector<mem::Relocation> &relocations) override;
 
   Model::Ptr model();
+  /// \note Marks the node as changed (see Node::markChanged).
   void setModel(Model::Ptr model);
+  /// Overrides the material instance of all model shapes for this node only,
+  /// so nodes can share a model (see ShapeCache) with different materials.
+  /// \note Marks the node as changed (see Node::markChanged).
+  /// \param material_instance [def=null] Null uses the shape materials.
+  void setMaterialInstance(
+      const Material::Instance::Ptr &material_instance = {});
 
 protected:
+  hermes::geo::Transform
+  childMatrix(const hermes::geo::Transform &top_matrix) const override;
+
   Model::Ptr model_;
+  Material::Instance::Ptr material_instance_;
 
 #ifdef VENUS_INCLUDE_DEBUG_TRAITS
   hermes::DebugMessage debugMessage() const override {
@@ -215,6 +318,31 @@ protected:
 #endif
 };
 
+// *****************************************************************************
+//                                                           Static Batch Node
+// *****************************************************************************
+
+/// Specialized model node drawing static geometry already baked into world
+/// space (see buildStaticBatches).
+/// \note The node model holds a single shape covering the whole batch.
+class StaticBatchNode : public ModelNode {
+public:
+  using Ptr = hermes::Ref<StaticBatchNode>;
+
+  StaticBatchNode() = default;
+  virtual ~StaticBatchNode() noexcept = default;
+  /// \param model Model of the batch.
+  /// \param sources Index ranges and world space bounds of the batched shapes.
+  StaticBatchNode(Model::Ptr model, std::vector<StaticBatch::Source> sources);
+
+  /// \note Source bounds can be used for picking batched shapes.
+  /// \return Index ranges and world space bounds of the batched shapes.
+  const std::vector<StaticBatch::Source> &sources() const;
+
+protected:
+  std::vector<StaticBatch::Source> sources_;
+};
+
 // *****************************************************************************
 //                                                                 Camera Node
 // *****************************************************************************
@@ -236,6 +364,9 @@ public:
   void setCamera(Camera::Ptr camera);
 
 protected:
+  hermes::geo::Transform
+  childMatrix(const hermes::geo::Transform &top_matrix) const override;
+
   Camera::Ptr camera_;
 
 #ifdef VENUS_INCLUDE_DEBUG_TRAITS
@@ -258,8 +389,29 @@ public:
     mem::Image::View view;
   };
 
+  /// \param path
+  /// \param gd
+  /// \param optimization [def={}] Import-time optimization of each primitive
+  ///        (see optimizeMesh).
+  /// \param lods [def={}] Levels of detail of each primitive (see
+  ///        generateLods), disabled by default.
+  /// \param meshlets [def=false] Splits each primitive into meshlets (see
+  ///        buildMeshlets).
+  /// \param batching [def={}] Merges primitives of static nodes (not targeted
+  ///        by animations or skins) sharing a material into batches (see
+  ///        buildStaticBatches), disabled by default. Static batch ids are
+  ///        glTF node indices.
+  /// \param quantize [def=false] Uploads quantized vertices (see
+  ///        mem::quantizeVertices), decoded by the built-in mesh shader.
+  /// \param depth_prepass [def=false] Materials draw a depth prepass (see
+  ///        engine::GraphicsEngine::Globals::Materials).
   static Result<Ptr> from(const std::filesystem::path &path,
-                          const engine::GraphicsDevice &gd);
+                          const engine::GraphicsDevice &gd,
+                          const MeshOptimization &optimization = {},
+                          const MeshLodGeneration &lods = {},
+                          bool meshlets = false,
+                          const StaticBatching &batching = {},
+                          bool quantize = false, bool depth_prepass = false);
 
   ~GLTF_Node() noexcept;
 
@@ -267,6 +419,10 @@ public:
             DrawContext &ctx) override;
   void destroy() noexcept override;
 
+protected:
+  hermes::geo::Transform
+  childMatrix(const hermes::geo::Transform &top_matrix) const override;
+
 private:
   // named data
 
@@ -277,8 +433,12 @@ private:
   std::unordered_map<std::string, Node::Ptr> nodes_;
   std::unordered_map<std::string, Material::Instance::Ptr> materials_;
 
-  // top nodes on the GLTF tree
+  // top nodes on the GLTF tree (also children of this node, so their changes
+  // reach it)
   std::vector<Node::Ptr> top_nodes_;
+  // merged static geometry (drawn after the tree, also children)
+  std::vector<StaticBatchNode::Ptr> static_batches_;
+  std::vector<Model::Storage<mem::AllocatedBuffer>> static_batch_storage_;
 
   // constructed data
 
@@ -307,6 +467,11 @@ public:
   void draw(const hermes::geo::Transform &top_matrix,
             DrawContext &ctx) override;
   void destroy() noexcept override;
+  void relocate(const std::vector<mem::Relocation> &relocations) override;
+
+protected:
+  hermes::geo::Transform
+  childMatrix(const hermes::geo::Transform &top_matrix) const override;
 
 private:
   mem::AllocatedBuffer gpu_vdb_data_;
@@ -388,6 +553,7 @@ template <> struct DebugTraits<venus::scene::RasterContext::RenderObject> {
   message(const venus::scene::RasterContext::RenderObject &data) {
     return DebugMessage()
         .addTitle("[Raster Context] Render Object")
+        .add("id", data.id)
         .add("bounds", data.bounds)
         .add("transform", data.transform)
         .add("count", data.count)
@@ -395,6 +561,8 @@ template <> struct DebugTraits<venus::scene::RasterContext::RenderObject> {
         .add("index buffer", data.index_buffer)
         .add("vertex buffer", data.vertex_buffer)
         .add("vertex buffer address", data.vertex_buffer_address)
+        .add("position buffer address", data.position_buffer_address)
+        .add("quantized", data.dequantization.has_value())
         .addFmt("material instance: 0x{:x}",
                 (uintptr_t)(data.material_instance.get()))
         .addFmt("material address: 0x{:x}",
@@ -0,0 +1,220 @@
+/* Copyright (c) 2025, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+/// \file   static_batching.cpp
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-18
+
+#include <venus/scene/static_batching.h>
+
+#include <hermes/geometry/point.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace venus::scene {
+
+// Direction component (normal, tangent or bitangent) of the vertex layout.
+struct StaticBatchDirection {
+  u32 offset{0};
+  bool is_normal{false}; //< normals use the inverse transpose transform.
+};
+
+static void bakeVertex(u8 *vertex, const hermes::geo::Transform &transform,
+                       const hermes::geo::Transform &inverse,
+                       u32 position_offset,
+                       const std::vector<StaticBatchDirection> &directions) {
+  f32 p[3];
+  std::memcpy(p, vertex + position_offset, sizeof(p));
+  auto position = transform(hermes::geo::point3(p[0], p[1], p[2]));
+  for (u32 d = 0; d < 3; ++d)
+    p[d] = position[d];
+  std::memcpy(vertex + position_offset, p, sizeof(p));
+
+  const auto inverse_matrix = inverse.matrix();
+  for (const auto &direction : directions) {
+    f32 v[3];
+    std::memcpy(v, vertex + direction.offset, sizeof(v));
+    hermes::geo::vec3 baked;
+    if (direction.is_normal) {
+      for (u32 i = 0; i < 3; ++i)
+        baked[i] = inverse_matrix[0][i] * v[0] + inverse_matrix[1][i] * v[1] +
+                   inverse_matrix[2][i] * v[2];
+    } else
+      baked = transform(hermes::geo::vec3(v[0], v[1], v[2]));
+    f32 length = baked.length();
+    if (length > 0.f)
+      baked = baked / length;
+    for (u32 d = 0; d < 3; ++d)
+      v[d] = baked[d];
+    std::memcpy(vertex + direction.offset, v, sizeof(v));
+  }
+}
+
+static f32 linearDeterminant(const hermes::geo::Transform &transform) {
+  const auto m = transform.matrix();
+  return m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) -
+         m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) +
+         m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+}
+
+static hermes::geo::bounds::bsphere3
+boxSphere(const hermes::geo::point3 &lower, const hermes::geo::point3 &upper) {
+  hermes::geo::bounds::bsphere3 sphere;
+  sphere.setCenter((upper + hermes::geo::vec3(lower)) / 2.f);
+  sphere.setRadius(((upper - lower) / 2.f).length());
+  return sphere;
+}
+
+Result<std::vector<StaticBatch>>
+buildStaticBatches(const mem::VertexLayout &layout,
+                   const std::vector<StaticBatchSource> &sources,
+                   const StaticBatching &options) {
+  using ComponentType = mem::VertexLayout::ComponentType;
+
+  const u32 stride = static_cast<u32>(layout.stride());
+  if (!stride || !options.max_batch_size)
+    return VeResult::inputError();
+  auto position_offset = layout.componentOffset(ComponentType::Position);
+  auto position_format = layout.componentFormat(ComponentType::Position);
+  if (layout.streamCount() > 1 || layout.isQuantized() || !position_offset ||
+      !position_format || *position_format != VK_FORMAT_R32G32B32_SFLOAT)
+    return VeResult::incompatible();
+
+  std::vector<StaticBatchDirection> directions;
+  for (const auto &component : layout.components()) {
+    if (component.type != ComponentType::Normal &&
+        component.type != ComponentType::Tangent &&
+        component.type != ComponentType::Bitangent)
+      continue;
+    if (component.format != VK_FORMAT_R32G32B32_SFLOAT &&
+        component.format != VK_FORMAT_R32G32B32A32_SFLOAT)
+      return VeResult::incompatible();
+    StaticBatchDirection direction;
+    direction.offset = static_cast<u32>(component.offset);
+    direction.is_normal = component.type == ComponentType::Normal;
+    directions.emplace_back(direction);
+  }
+
+  std::vector<StaticBatch> batches;
+  // world space box of each batch
+  std::vector<std::pair<hermes::geo::point3, hermes::geo::point3>> boxes;
+  // batch still accepting sources of each material instance
+  std::unordered_map<const Material::Instance *, h_index> open_batches;
+  std::vector<u32> remap;
+  std::vector<u32> used;
+  for (const auto &source : sources) {
+    if (!source.vertices || !source.indices || !source.index_count ||
+        source.index_count % 3)
+      return VeResult::inputError();
+
+    // referenced vertices, in order of first reference
+
+    remap.assign(source.vertex_count, ~0u);
+    used.clear();
+    for (u32 i = 0; i < source.index_count; ++i) {
+      u32 index = source.indices[i];
+      if (index >= source.vertex_count)
+        return VeResult::outOfBounds();
+      if (remap[index] == ~0u) {
+        remap[index] = static_cast<u32>(used.size());
+        used.emplace_back(index);
+      }
+    }
+
+    // pick (or open) the batch of the material instance
+
+    const u64 source_size =
+        u64(stride) * used.size() + sizeof(u32) * source.index_count;
+    auto it = open_batches.find(source.material_instance.get());
+    bool fits = it != open_batches.end();
+    if (fits) {
+      const auto &open_batch = batches[it->second];
+      fits = open_batch.vertices.size() +
+                 sizeof(u32) * open_batch.indices.size() + source_size <=
+             options.max_batch_size;
+    }
+    if (!fits) {
+      open_batches[source.material_instance.get()] = batches.size();
+      batches.emplace_back().material_instance = source.material_instance;
+      boxes.emplace_back();
+    }
+    const h_index batch_index = open_batches[source.material_instance.get()];
+    StaticBatch &batch = batches[batch_index];
+
+    // bake vertices
+
+    const u8 *data = reinterpret_cast<const u8 *>(source.vertices);
+    const auto inverse = hermes::geo::inverse(source.transform);
+    const u32 base_vertex = batch.vertex_count;
+    batch.vertices.resize(batch.vertices.size() + u64(stride) * used.size());
+    hermes::geo::point3 lower, upper;
+    for (u32 v = 0; v < used.size(); ++v) {
+      u8 *vertex = batch.vertices.data() + u64(stride) * (base_vertex + v);
+      std::memcpy(vertex, data + u64(stride) * used[v], stride);
+      bakeVertex(vertex, source.transform, inverse,
+                 static_cast<u32>(*position_offset), directions);
+      f32 p[3];
+      std::memcpy(p, vertex + *position_offset, sizeof(p));
+      for (u32 d = 0; d < 3; ++d) {
+        lower[d] = v ? std::min(lower[d], p[d]) : p[d];
+        upper[d] = v ? std::max(upper[d], p[d]) : p[d];
+      }
+    }
+    batch.vertex_count += static_cast<u32>(used.size());
+
+    // indices (mirroring transforms flip the triangle winding)
+
+    StaticBatch::Source batched;
+    batched.id = source.id;
+    batched.bounds = boxSphere(lower, upper);
+    batched.index_base = static_cast<u32>(batch.indices.size());
+    batched.index_count = source.index_count;
+    const bool flip = linearDeterminant(source.transform) < 0.f;
+    for (u32 i = 0; i < source.index_count; i += 3) {
+      batch.indices.emplace_back(base_vertex + remap[source.indices[i]]);
+      batch.indices.emplace_back(
+          base_vertex + remap[source.indices[i + (flip ? 2 : 1)]]);
+      batch.indices.emplace_back(
+          base_vertex + remap[source.indices[i + (flip ? 1 : 2)]]);
+    }
+
+    auto &box = boxes[batch_index];
+    for (u32 d = 0; d < 3; ++d) {
+      box.first[d] =
+          batch.sources.empty() ? lower[d] : std::min(box.first[d], lower[d]);
+      box.second[d] =
+          batch.sources.empty() ? upper[d] : std::max(box.second[d], upper[d]);
+    }
+    batch.sources.emplace_back(batched);
+  }
+
+  for (h_index b = 0; b < batches.size(); ++b)
+    batches[b].bounds = boxSphere(boxes[b].first, boxes[b].second);
+
+  return Result<std::vector<StaticBatch>>(std::move(batches));
+}
+
+} // namespace venus::scene
@@ -0,0 +1,90 @@
+/* Copyright (c) 2025, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+/// \file   static_batching.h
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-18
+/// \brief  Static geometry batching.
+
+#pragma once
+
+#include <venus/scene/material.h>
+
+#include <hermes/geometry/bounds.h>
+#include <hermes/geometry/transform.h>
+
+namespace venus::scene {
+
+/// Options of buildStaticBatches.
+struct StaticBatching {
+  /// Max size (in bytes) of the vertex and index data of a single batch.
+  /// \note Zero disables static batching.
+  u64 max_batch_size{0};
+};
+
+/// Shape geometry to be merged into a static batch.
+struct StaticBatchSource {
+  const void *vertices{nullptr}; //< interleaved vertex data.
+  u32 vertex_count{0};           //< number of vertices in vertices.
+  const u32 *indices{nullptr};   //< triangle list (relative to vertices).
+  u32 index_count{0};
+  hermes::geo::Transform transform; //< object to world transform.
+  Material::Instance::Ptr material_instance;
+  u32 id{0}; //< identifies the source (e.g. its scene node).
+};
+
+/// Static geometry sharing a material instance, baked into world space.
+struct StaticBatch {
+  /// Where a source ended up in the batch.
+  struct Source {
+    u32 id{0};                            //< see StaticBatchSource::id.
+    hermes::geo::bounds::bsphere3 bounds; //< world space bounds.
+    u32 index_base{0};  //< first index of the source in the batch.
+    u32 index_count{0}; //< index count of the source in the batch.
+  };
+
+  Material::Instance::Ptr material_instance;
+  std::vector<u8> vertices; //< world space vertices (same input layout).
+  u32 vertex_count{0};
+  std::vector<u32> indices;
+  hermes::geo::bounds::bsphere3 bounds; //< world space bounds of the batch.
+  std::vector<Source> sources;          //< per source ranges (for picking).
+};
+
+/// \brief Merges static shapes sharing a material instance into batches, so
+///        each batch is drawn at once.
+/// Source transforms are baked into positions, normals, tangents and
+/// bitangents. Only the vertices referenced by the source indices are copied.
+/// A batch is closed once adding a source would exceed the max batch size, a
+/// single source larger than the budget gets a batch of its own.
+/// \note Requires R32G32B32_SFLOAT positions (and direction components).
+/// \param layout Layout of the input (single stream) vertex data.
+/// \param sources Shapes to be merged (batches follow their order).
+/// \param options
+/// \return Batches grouped by material instance, or error.
+HERMES_NODISCARD Result<std::vector<StaticBatch>>
+buildStaticBatches(const mem::VertexLayout &layout,
+                   const std::vector<StaticBatchSource> &sources,
+                   const StaticBatching &options);
+
+} // namespace venus::scene
@@ -0,0 +1,83 @@
+/* Copyright (c) 2025, FilipeCN.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+/// \file   memory_budget.cpp
+/// \author FilipeCN (filipedecn@gmail.com)
+/// \date   2026-10-18
+
+#include <venus/ui/memory_budget.h>
+
+#include <imgui.h>
+
+namespace venus::ui {
+
+static f32 toMiB(VkDeviceSize size_in_bytes) {
+  return static_cast<f32>(size_in_bytes) / (1024.f * 1024.f);
+}
+
+void memoryBudgetPanel(const core::MemoryBudget &budget) {
+  ImGui::Text("Usage %.1f / %.1f MiB (peak %.1f MiB)",
+              toMiB(budget.totalUsage()), toMiB(budget.totalBudget()),
+              toMiB(budget.peakUsage()));
+  if (budget.isOverBudget())
+    ImGui::TextColored(ImVec4(1.f, 0.3f, 0.3f, 1.f), "Over budget!");
+
+  // heaps
+  const auto &heaps = budget.heaps();
+  for (h_index i = 0; i < heaps.size(); ++i) {
+    const auto &heap = heaps[i];
+    ImGui::Text("heap %d%s", static_cast<i32>(i),
+                heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT ? " (device)"
+                                                             : "");
+    ImGui::SameLine();
+    ImGui::ProgressBar(heap.budget ? static_cast<f32>(heap.usage) /
+                                         static_cast<f32>(heap.budget)
+                                   : 0.f,
+                       ImVec2(-1.f, 0.f));
+  }
+
+  // categories
+  if (ImGui::BeginTable("memory_categories", 4)) {
+    ImGui::TableSetupColumn("category");
+    ImGui::TableSetupColumn("MiB");
+    ImGui::TableSetupColumn("peak MiB");
+    ImGui::TableSetupColumn("count");
+    ImGui::TableHeadersRow();
+    for (u32 i = 0; i < static_cast<u32>(core::MemoryCategory::Count); ++i) {
+      auto category = static_cast<core::MemoryCategory>(i);
+      const auto &c = budget.category(category);
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      ImGui::TextUnformatted(core::memoryCategoryName(category).data());
+      ImGui::TableNextColumn();
+      ImGui::Text("%.2f", toMiB(c.bytes));
+      ImGui::TableNextColumn();
+      ImGui::Text("%.2f", toMiB(c.peak_bytes));
+      ImGui::TableNextColumn();
+      ImGui::Text("%zu", static_cast<size_t>(c.allocation_count));
+    }
+    ImGui::EndTable();
+  }
+}
+
+} // namespace venus::ui